@@ -0,0 +1,405 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "exceptions.h"
+#include "generationcontext.h"
+#include "mapgenerator.h"
+#include "maptemplate.h"
+#include "maptemplatereader.h"
+#include "syntheticgameinfo.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sol/sol.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace rsg {
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+// Measured phases: template contents, generation phases in their order, serialization
+static const char* const phaseNames[] = {
+    "contents",
+    "placeZones",
+    "createBorders",
+    "fillZones",
+    "createObstacles",
+    "connectRoads",
+    "createRoads",
+    "setupDiplomacy",
+    "serialize",
+};
+
+static constexpr std::size_t phasesTotal{std::size(phaseNames)};
+static constexpr std::size_t contentsPhase{0};
+static constexpr std::size_t serializePhase{phasesTotal - 1};
+
+// Generation phase index in phaseNames
+static std::size_t getPhaseIndex(GenerationPhase phase)
+{
+    return static_cast<std::size_t>(phase) + 1;
+}
+
+// Races of template players, fixed so results do not depend on random races
+static const RaceType playerRaces[] = {
+    RaceType::Human, RaceType::Undead, RaceType::Heretic, RaceType::Dwarf, RaceType::Elf,
+};
+
+// Objects counted to make sure benchmark generates the same scenarios
+static const CMidgardID::Type countedObjects[] = {
+    CMidgardID::Type::Fortification,
+    CMidgardID::Type::Stack,
+    CMidgardID::Type::Item,
+    CMidgardID::Type::Bag,
+    CMidgardID::Type::Site,
+    CMidgardID::Type::Ruin,
+    CMidgardID::Type::Crystal,
+    CMidgardID::Type::Landmark,
+};
+
+struct BenchmarkOptions
+{
+    std::vector<int> sizes{48, 72, 96, 120, 144};
+    std::time_t firstSeed{1};
+    std::size_t seeds{5};
+    // Each scenario is generated several times, median time is reported
+    std::size_t repeat{3};
+    // Generate in large map mode, ignoring template size limits.
+    // Scenarios larger than the game supports are not serialized
+    bool largeMap{};
+    // Threads that fill zones of each scenario in parallel, zero fills zones one by one
+    std::size_t fillThreads{};
+};
+
+// Sizes used in large map mode when they are not specified
+static const int largeMapSizes[] = {144, 256, 384, 512};
+
+// Results of a single template at a single scenario size
+struct BenchmarkResult
+{
+    std::string templateName;
+    int size{};
+    std::size_t runs{};
+    std::size_t failed{};
+    // Objects of all scenarios generated from different seeds
+    std::size_t objects{};
+    // Milliseconds of each successful run, per phase
+    std::vector<double> phaseTimes[phasesTotal];
+    std::vector<double> totalTimes;
+};
+
+static double getMilliseconds(BenchmarkClock::time_point start, BenchmarkClock::time_point end)
+{
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static double getMedian(std::vector<double> values)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+
+    const auto middle{values.begin() + values.size() / 2};
+    std::nth_element(values.begin(), middle, values.end());
+    return *middle;
+}
+
+// Generates scenario once, returns false if zones lacked space.
+// Fills time of each phase in milliseconds
+static bool runScenario(const GenerationContext& context,
+                        const MapTemplateSettings& templateSettings,
+                        sol::state& lua,
+                        int size,
+                        const BenchmarkOptions& benchmarkOptions,
+                        std::time_t seed,
+                        const std::filesystem::path& scenarioPath,
+                        double (&phaseTimes)[phasesTotal],
+                        std::size_t& objects)
+{
+    std::fill(std::begin(phaseTimes), std::end(phaseTimes), 0.0);
+
+    MapTemplate mapTemplate;
+    mapTemplate.settings = templateSettings;
+    mapTemplate.settings.size = size;
+
+    const auto playersTotal{std::min(std::size(playerRaces),
+                                     static_cast<std::size_t>(templateSettings.maxPlayers))};
+    mapTemplate.settings.races.assign(std::begin(playerRaces),
+                                      std::begin(playerRaces) + playersTotal);
+
+    MapGenOptions options;
+    options.mapTemplate = &mapTemplate;
+    options.name = "Benchmark scenario";
+    options.description = "Benchmark scenario";
+    options.size = size;
+    options.largeMap = benchmarkOptions.largeMap;
+    options.fillThreads = benchmarkOptions.fillThreads;
+
+    MapGenerator generator{context, options, seed};
+
+    auto phaseStart{BenchmarkClock::now()};
+    readTemplateContents(mapTemplate, lua);
+
+    auto now{BenchmarkClock::now()};
+    phaseTimes[contentsPhase] = getMilliseconds(phaseStart, now);
+
+    // Phase ends when the next one is reported
+    std::size_t currentPhase{contentsPhase};
+    phaseStart = now;
+
+    generator.setProgressCallback([&](const GenerationProgress& progress) {
+        const auto phase{getPhaseIndex(progress.phase)};
+        if (phase == currentPhase) {
+            return;
+        }
+
+        const auto phaseEnd{BenchmarkClock::now()};
+        phaseTimes[currentPhase] += getMilliseconds(phaseStart, phaseEnd);
+        currentPhase = phase;
+        phaseStart = phaseEnd;
+    });
+
+    MapPtr map;
+
+    try {
+        map = generator.generate();
+    } catch (const LackOfSpaceException&) {
+        return false;
+    }
+
+    if (size <= maxScenarioSize) {
+        phaseStart = BenchmarkClock::now();
+        map->serialize(scenarioPath);
+        phaseTimes[serializePhase] = getMilliseconds(phaseStart, BenchmarkClock::now());
+    }
+
+    objects = 0;
+    for (const auto type : countedObjects) {
+        map->visit(type, [&objects](const ScenarioObject*) { ++objects; });
+    }
+
+    return true;
+}
+
+static void runTemplate(const GenerationContext& context,
+                        const std::filesystem::path& templatePath,
+                        const BenchmarkOptions& options,
+                        const std::filesystem::path& scenarioPath,
+                        std::vector<BenchmarkResult>& results)
+{
+    sol::state lua;
+    bindLuaApi(lua);
+
+    const MapTemplateSettings settings{readTemplateSettings(templatePath, lua)};
+
+    for (const int size : options.sizes) {
+        if (!options.largeMap && (size < settings.sizeMin || size > settings.sizeMax)) {
+            continue;
+        }
+
+        BenchmarkResult result;
+        result.templateName = templatePath.stem().u8string();
+        result.size = size;
+
+        for (std::size_t i = 0; i < options.seeds; ++i) {
+            const std::time_t seed{options.firstSeed + static_cast<std::time_t>(i)};
+
+            for (std::size_t run = 0; run < options.repeat; ++run) {
+                double phaseTimes[phasesTotal];
+                std::size_t objects{};
+
+                ++result.runs;
+                if (!runScenario(context, settings, lua, size, options, seed,
+                                 scenarioPath, phaseTimes, objects)) {
+                    ++result.failed;
+                    continue;
+                }
+
+                // Repeated runs generate the same scenario
+                if (run == 0) {
+                    result.objects += objects;
+                }
+
+                double total{};
+                for (std::size_t phase = 0; phase < phasesTotal; ++phase) {
+                    result.phaseTimes[phase].push_back(phaseTimes[phase]);
+                    total += phaseTimes[phase];
+                }
+
+                result.totalTimes.push_back(total);
+            }
+        }
+
+        std::cout << result.templateName << ' ' << size << ": "
+                  << static_cast<long long>(getMedian(result.totalTimes)) << " ms\n";
+
+        results.push_back(std::move(result));
+    }
+}
+
+// Writes one line per template and size with median time of each phase in milliseconds.
+// Lines and columns have fixed order, so results of different builds can be compared with diff
+static void writeResults(std::ostream& stream,
+                         const std::vector<BenchmarkResult>& results,
+                         const BenchmarkOptions& options)
+{
+    stream << "# Median milliseconds of " << options.repeat << " runs per seed, seeds "
+           << options.firstSeed << '-'
+           << options.firstSeed + static_cast<std::time_t>(options.seeds) - 1 << '\n';
+
+    // Area column shows how phase times scale with map area
+    stream << "template\tsize\tarea\truns\tfailed\tobjects";
+    for (const auto name : phaseNames) {
+        stream << '\t' << name;
+    }
+
+    stream << "\ttotal\n";
+
+    stream << std::fixed << std::setprecision(3);
+    for (const auto& result : results) {
+        stream << result.templateName << '\t' << result.size << '\t'
+               << result.size * result.size << '\t' << result.runs << '\t' << result.failed
+               << '\t' << result.objects;
+
+        for (const auto& times : result.phaseTimes) {
+            stream << '\t' << getMedian(times);
+        }
+
+        stream << '\t' << getMedian(result.totalTimes) << '\n';
+    }
+}
+
+static bool readSizes(const char* string, std::vector<int>& sizes)
+{
+    sizes.clear();
+
+    std::istringstream stream{string};
+    std::string size;
+
+    while (std::getline(stream, size, ',')) {
+        const int value{std::atoi(size.c_str())};
+        if (value <= 0) {
+            return false;
+        }
+
+        sizes.push_back(value);
+    }
+
+    return !sizes.empty();
+}
+
+} // namespace rsg
+
+static void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program
+              << " <templates folder> <results file> [--sizes 48,72,96,120,144] [--seeds N]"
+                 " [--first-seed N] [--repeat N] [--large] [--fill-threads N]\n";
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace rsg;
+
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    const std::filesystem::path templatesFolder{std::filesystem::u8path(argv[1])};
+    const std::filesystem::path resultsPath{std::filesystem::u8path(argv[2])};
+
+    BenchmarkOptions options;
+    bool sizesSpecified{};
+
+    for (int i = 3; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--sizes") && i + 1 < argc) {
+            if (!readSizes(argv[++i], options.sizes)) {
+                printUsage(argv[0]);
+                return 2;
+            }
+
+            sizesSpecified = true;
+        } else if (!std::strcmp(argv[i], "--seeds") && i + 1 < argc) {
+            options.seeds = std::max(1, std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--first-seed") && i + 1 < argc) {
+            options.firstSeed = std::max(0, std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--repeat") && i + 1 < argc) {
+            options.repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--large")) {
+            options.largeMap = true;
+        } else if (!std::strcmp(argv[i], "--fill-threads") && i + 1 < argc) {
+            options.fillThreads = std::max(0, std::atoi(argv[++i]));
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (options.largeMap && !sizesSpecified) {
+        options.sizes.assign(std::begin(largeMapSizes), std::end(largeMapSizes));
+    }
+
+    try {
+        std::vector<std::filesystem::path> templates;
+        for (const auto& entry : std::filesystem::directory_iterator(templatesFolder)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".lua") {
+                templates.push_back(entry.path());
+            }
+        }
+
+        // Directory order is not specified
+        std::sort(templates.begin(), templates.end());
+
+        const SyntheticGameInfo info;
+        const GenerationContext context(info, info.getGeneratorSettings());
+
+        // Scenarios are serialized to measure it, but not kept
+        auto scenarioPath{resultsPath};
+        scenarioPath.replace_extension(".sg");
+
+        std::vector<BenchmarkResult> results;
+        for (const auto& templatePath : templates) {
+            runTemplate(context, templatePath, options, scenarioPath, results);
+        }
+
+        std::filesystem::remove(scenarioPath);
+
+        std::ofstream stream(resultsPath);
+        if (!stream) {
+            std::cerr << "Could not create results file " << resultsPath.u8string() << '\n';
+            return 1;
+        }
+
+        writeResults(stream, results, options);
+    } catch (const std::exception& e) {
+        std::cerr << "Exception during benchmark: " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,607 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "syntheticgameinfo.h"
+#include "randomgenerator.h"
+#include "standaloneiteminfo.h"
+#include "standalonelandmarkinfo.h"
+#include "standaloneraceinfo.h"
+#include "standalonespellinfo.h"
+#include "standaloneunitinfo.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+namespace rsg {
+
+// Sizes of synthesized catalogs, close to the game with both expansions
+static constexpr int soldiersPerRace{24};
+static constexpr int leadersPerRace{6};
+static constexpr int soldiersPerNeutralSubrace{40};
+static constexpr int leadersPerNeutralSubrace{8};
+static constexpr int itemsPerType{26};
+static constexpr int spellsPerType{11};
+static constexpr int landmarksTotal{260};
+static constexpr int cityNamesTotal{80};
+static constexpr int siteTextsTotal{24};
+
+// clang-format off
+static const std::pair<RaceType, SubRaceType> playableRaces[] = {
+    {RaceType::Human, SubRaceType::Human},
+    {RaceType::Undead, SubRaceType::Undead},
+    {RaceType::Heretic, SubRaceType::Heretic},
+    {RaceType::Dwarf, SubRaceType::Dwarf},
+    {RaceType::Elf, SubRaceType::Elf},
+};
+
+static const SubRaceType neutralSubraces[] = {
+    SubRaceType::Neutral,
+    SubRaceType::NeutralHuman,
+    SubRaceType::NeutralElf,
+    SubRaceType::NeutralGreenSkin,
+    SubRaceType::NeutralDragon,
+    SubRaceType::NeutralMarsh,
+    SubRaceType::NeutralWater,
+    SubRaceType::NeutralBarbarian,
+    SubRaceType::NeutralWolf,
+};
+
+// Item value ranges of each type
+static const std::tuple<ItemType, int, int> itemValues[] = {
+    {ItemType::Armor, 400, 3000},
+    {ItemType::Jewel, 300, 2500},
+    {ItemType::Weapon, 400, 3000},
+    {ItemType::Banner, 500, 2500},
+    {ItemType::PotionBoost, 50, 400},
+    {ItemType::PotionHeal, 50, 300},
+    {ItemType::PotionRevive, 100, 400},
+    {ItemType::PotionPermanent, 300, 1500},
+    {ItemType::Scroll, 150, 1500},
+    {ItemType::Wand, 300, 2000},
+    {ItemType::Valuable, 100, 1500},
+    {ItemType::Orb, 300, 2000},
+    {ItemType::Talisman, 500, 1500},
+    {ItemType::TravelItem, 400, 1500},
+    {ItemType::Special, 0, 0},
+};
+
+static const SpellType spellTypes[] = {
+    SpellType::Attack,
+    SpellType::Lower,
+    SpellType::Heal,
+    SpellType::Boost,
+    SpellType::Summon,
+    SpellType::Fog,
+    SpellType::Unfog,
+    SpellType::RestoreMove,
+    SpellType::Invisibility,
+    SpellType::RemoveRod,
+    SpellType::ChangeTerrain,
+    SpellType::GiveWards,
+};
+
+static const AttackType supportAttacks[] = {
+    AttackType::Heal,
+    AttackType::Paralyze,
+    AttackType::BoostDamage,
+    AttackType::LowerDamage,
+    AttackType::Cure,
+};
+// clang-format on
+
+static CMidgardID createGlobalId(CMidgardID::Type type, int index)
+{
+    return CMidgardID(CMidgardID::Category::Global, 0, type, static_cast<std::uint16_t>(index));
+}
+
+SyntheticGameInfo::SyntheticGameInfo(std::uint64_t seed)
+{
+    RandomGenerator random{seed};
+
+    minLeaderValue = std::numeric_limits<int>::max();
+    maxLeaderValue = std::numeric_limits<int>::min();
+    minSoldierValue = std::numeric_limits<int>::max();
+    maxSoldierValue = std::numeric_limits<int>::min();
+
+    createRaces(random);
+    createNeutralUnits(random);
+    createItems(random);
+    createSpells(random);
+    createLandmarks(random);
+    createTexts();
+    createGeneratorSettings(random);
+    buildLandmarksByRace();
+    assignCatalogIndices(*this);
+}
+
+const UnitsInfo& SyntheticGameInfo::getUnits() const
+{
+    return unitsInfo;
+}
+
+const UnitInfoArray& SyntheticGameInfo::getLeaders() const
+{
+    return leaders;
+}
+
+const UnitInfoArray& SyntheticGameInfo::getSoldiers() const
+{
+    return soldiers;
+}
+
+int SyntheticGameInfo::getMinLeaderValue() const
+{
+    return minLeaderValue;
+}
+
+int SyntheticGameInfo::getMaxLeaderValue() const
+{
+    return maxLeaderValue;
+}
+
+int SyntheticGameInfo::getMinSoldierValue() const
+{
+    return minSoldierValue;
+}
+
+int SyntheticGameInfo::getMaxSoldierValue() const
+{
+    return maxSoldierValue;
+}
+
+const ItemsInfo& SyntheticGameInfo::getItemsInfo() const
+{
+    return itemsInfo;
+}
+
+const ItemInfoArray& SyntheticGameInfo::getItems() const
+{
+    return allItems;
+}
+
+const ItemInfoArray& SyntheticGameInfo::getItems(ItemType itemType) const
+{
+    const auto it{itemsByType.find(itemType)};
+    if (it == itemsByType.end()) {
+        throw std::runtime_error("Could not find items by type");
+    }
+
+    return it->second;
+}
+
+const SpellsInfo& SyntheticGameInfo::getSpellsInfo() const
+{
+    return spellsInfo;
+}
+
+const SpellInfoArray& SyntheticGameInfo::getSpells() const
+{
+    return allSpells;
+}
+
+const SpellInfoArray& SyntheticGameInfo::getSpells(SpellType spellType) const
+{
+    const auto it{spellsByType.find(spellType)};
+    if (it == spellsByType.end()) {
+        throw std::runtime_error("Could not find spells by type");
+    }
+
+    return it->second;
+}
+
+const LandmarksInfo& SyntheticGameInfo::getLandmarksInfo() const
+{
+    return landmarksInfo;
+}
+
+const LandmarkInfoArray& SyntheticGameInfo::getLandmarks(LandmarkType landmarkType) const
+{
+    const auto it{landmarksByType.find(landmarkType)};
+    if (it == landmarksByType.end()) {
+        throw std::runtime_error("Could not find landmarks by type");
+    }
+
+    return it->second;
+}
+
+const LandmarkInfoArray& SyntheticGameInfo::getLandmarks(RaceType raceType) const
+{
+    const auto it{landmarksByRace.find(raceType)};
+    if (it == landmarksByRace.end()) {
+        throw std::runtime_error("Could not find landmarks by race");
+    }
+
+    return it->second;
+}
+
+const LandmarkInfoArray& SyntheticGameInfo::getMountainLandmarks() const
+{
+    return mountainLandmarks;
+}
+
+const RacesInfo& SyntheticGameInfo::getRacesInfo() const
+{
+    return racesInfo;
+}
+
+const RaceInfo& SyntheticGameInfo::getRaceInfo(RaceType raceType) const
+{
+    for (const auto& pair : racesInfo) {
+        if (pair.second->getRaceType() == raceType) {
+            return *pair.second.get();
+        }
+    }
+
+    throw std::runtime_error("Could not find race by type");
+}
+
+const char* SyntheticGameInfo::getGlobalText(const CMidgardID& textId) const
+{
+    const auto it{globalTexts.find(textId)};
+    return it != globalTexts.end() ? it->second.c_str() : "NOT FOUND";
+}
+
+const char* SyntheticGameInfo::getEditorInterfaceText(const CMidgardID& textId) const
+{
+    const auto it{editorInterfaceTexts.find(textId)};
+    return it != editorInterfaceTexts.end() ? it->second.c_str() : "NOT FOUND";
+}
+
+const CityNames& SyntheticGameInfo::getCityNames() const
+{
+    return cityNames;
+}
+
+const SiteTexts& SyntheticGameInfo::getMercenaryTexts() const
+{
+    return mercenaryTexts;
+}
+
+const SiteTexts& SyntheticGameInfo::getMageTexts() const
+{
+    return mageTexts;
+}
+
+const SiteTexts& SyntheticGameInfo::getMerchantTexts() const
+{
+    return merchantTexts;
+}
+
+const SiteTexts& SyntheticGameInfo::getRuinTexts() const
+{
+    return ruinTexts;
+}
+
+const SiteTexts& SyntheticGameInfo::getTrainerTexts() const
+{
+    return trainerTexts;
+}
+
+const SiteTexts& SyntheticGameInfo::getMarketTexts() const
+{
+    return marketTexts;
+}
+
+UnitInfo* SyntheticGameInfo::createUnit(RandomGenerator& random,
+                                        const CMidgardID& raceId,
+                                        SubRaceType subrace,
+                                        UnitType type,
+                                        int level)
+{
+    const CMidgardID unitId{createGlobalId(CMidgardID::Type::UnitGlobal,
+                                           static_cast<int>(unitsInfo.size()))};
+    const CMidgardID nameId{createGlobalText("Unit " + std::to_string(unitsInfo.size()))};
+
+    // Unit value grows with level, values of the same level overlap
+    const int value{level * 45 + random.nextInteger(0, level * 35)};
+
+    const bool big{random.chance(20)};
+    const auto reachRoll{random.nextInteger(0, 99)};
+    const ReachType reach{reachRoll < 55 ? ReachType::Adjacent
+                                         : (reachRoll < 85 ? ReachType::Any : ReachType::All)};
+
+    AttackType attack{AttackType::Damage};
+    if (reach != ReachType::Adjacent && random.chance(25)) {
+        attack = supportAttacks[random.nextInteger(std::size_t{0}, std::size(supportAttacks) - 1)];
+    }
+
+    const int hp{50 + level * (big ? 60 : 35)};
+    const int leadership{type == UnitType::Leader ? random.nextInteger(1, 5) : 0};
+
+    auto info{std::make_unique<StandaloneUnitInfo>(unitId, raceId, nameId, level, value, type,
+                                                   subrace, reach, attack, hp, 20, leadership,
+                                                   big, random.chance(70))};
+    UnitInfo* unit{info.get()};
+    unitsInfo[unitId] = std::move(info);
+
+    if (type == UnitType::Leader) {
+        leaders.push_back(unit);
+        minLeaderValue = std::min(minLeaderValue, value);
+        maxLeaderValue = std::max(maxLeaderValue, value);
+    } else if (type == UnitType::Soldier) {
+        soldiers.push_back(unit);
+        minSoldierValue = std::min(minSoldierValue, value);
+        maxSoldierValue = std::max(maxSoldierValue, value);
+    }
+
+    return unit;
+}
+
+CMidgardID SyntheticGameInfo::createGlobalText(std::string&& text)
+{
+    const CMidgardID textId{createGlobalId(CMidgardID::Type::TextGlobal,
+                                           static_cast<int>(globalTexts.size()))};
+    globalTexts[textId] = std::move(text);
+    return textId;
+}
+
+static LeaderNames createLeaderNames(const std::string& raceName)
+{
+    LeaderNames names;
+    for (int i = 0; i < 10; ++i) {
+        names.maleNames.push_back(raceName + " lord " + std::to_string(i));
+        names.femaleNames.push_back(raceName + " lady " + std::to_string(i));
+    }
+
+    return names;
+}
+
+void SyntheticGameInfo::createRaces(RandomGenerator& random)
+{
+    for (const auto& [raceType, subrace] : playableRaces) {
+        const CMidgardID raceId{createGlobalId(CMidgardID::Type::Race,
+                                               static_cast<int>(raceType))};
+
+        const auto* guardian{createUnit(random, raceId, subrace, UnitType::Guardian, 10)};
+        const auto* noble{createUnit(random, raceId, subrace, UnitType::Noble, 1)};
+
+        std::vector<CMidgardID> leaderIds;
+        for (int i = 0; i < leadersPerRace; ++i) {
+            const auto* leader{createUnit(random, raceId, subrace, UnitType::Leader, 1 + i % 3)};
+
+            // Races have 4 starting leaders in the game
+            if (leaderIds.size() < 4) {
+                leaderIds.push_back(leader->getUnitId());
+            }
+        }
+
+        for (int i = 0; i < soldiersPerRace; ++i) {
+            createUnit(random, raceId, subrace, UnitType::Soldier, 1 + i % 5);
+        }
+
+        const std::string raceName{"Race " + std::to_string(static_cast<int>(raceType))};
+        racesInfo[raceId] = std::make_unique<StandaloneRaceInfo>(raceId, guardian->getUnitId(),
+                                                                 noble->getUnitId(), raceType,
+                                                                 createLeaderNames(raceName),
+                                                                 std::move(leaderIds));
+    }
+}
+
+void SyntheticGameInfo::createNeutralUnits(RandomGenerator& random)
+{
+    const CMidgardID raceId{createGlobalId(CMidgardID::Type::Race,
+                                           static_cast<int>(RaceType::Neutral))};
+
+    const auto* guardian{createUnit(random, raceId, SubRaceType::Neutral, UnitType::Guardian, 10)};
+    const auto* noble{createUnit(random, raceId, SubRaceType::Neutral, UnitType::Noble, 1)};
+
+    std::vector<CMidgardID> leaderIds;
+    for (const auto subrace : neutralSubraces) {
+        for (int i = 0; i < leadersPerNeutralSubrace; ++i) {
+            const auto* leader{createUnit(random, raceId, subrace, UnitType::Leader, 1 + i)};
+
+            if (leaderIds.size() < 4) {
+                leaderIds.push_back(leader->getUnitId());
+            }
+        }
+
+        for (int i = 0; i < soldiersPerNeutralSubrace; ++i) {
+            createUnit(random, raceId, subrace, UnitType::Soldier, 1 + i % 10);
+        }
+    }
+
+    racesInfo[raceId] = std::make_unique<StandaloneRaceInfo>(raceId, guardian->getUnitId(),
+                                                             noble->getUnitId(),
+                                                             RaceType::Neutral,
+                                                             createLeaderNames("Neutral"),
+                                                             std::move(leaderIds));
+}
+
+void SyntheticGameInfo::createItems(RandomGenerator& random)
+{
+    for (const auto& [itemType, minValue, maxValue] : itemValues) {
+        auto& typeItems{itemsByType[itemType]};
+
+        for (int i = 0; i < itemsPerType; ++i) {
+            const CMidgardID itemId{createGlobalId(CMidgardID::Type::ItemGlobal,
+                                                   static_cast<int>(allItems.size()))};
+
+            // Game item values are multiples of 10
+            const int value{random.nextInteger(minValue / 10, maxValue / 10) * 10};
+
+            auto info{std::make_unique<StandaloneItemInfo>(itemId, value, itemType)};
+            allItems.push_back(info.get());
+            typeItems.push_back(info.get());
+            itemsInfo[itemId] = std::move(info);
+        }
+    }
+}
+
+void SyntheticGameInfo::createSpells(RandomGenerator& random)
+{
+    for (const auto spellType : spellTypes) {
+        auto& typeSpells{spellsByType[spellType]};
+
+        for (int i = 0; i < spellsPerType; ++i) {
+            const CMidgardID spellId{createGlobalId(CMidgardID::Type::Spell,
+                                                    static_cast<int>(allSpells.size()))};
+
+            const int level{1 + i % 5};
+            const int value{level * 200 + random.nextInteger(0, 15) * 10};
+
+            auto info{std::make_unique<StandaloneSpellInfo>(spellId, value, level, spellType)};
+            allSpells.push_back(info.get());
+            typeSpells.push_back(info.get());
+            spellsInfo[spellId] = std::move(info);
+        }
+    }
+}
+
+void SyntheticGameInfo::createLandmarks(RandomGenerator& random)
+{
+    for (int i = 0; i < landmarksTotal; ++i) {
+        const CMidgardID landmarkId{createGlobalId(CMidgardID::Type::LandmarkGlobal, i)};
+
+        // Most landmarks are small and square
+        const int size{random.chance(60) ? random.nextInteger(1, 2) : random.nextInteger(3, 5)};
+        const Position landmarkSize{size, random.chance(85) ? size : std::max(1, size - 1)};
+
+        const auto type{static_cast<LandmarkType>(random.nextInteger(0, 3))};
+
+        auto info{std::make_unique<StandaloneLandmarkInfo>(landmarkId, landmarkSize, type,
+                                                           random.chance(30))};
+        allLandmarks.push_back(info.get());
+        landmarksByType[type].push_back(info.get());
+        landmarksInfo[landmarkId] = std::move(info);
+    }
+}
+
+static SiteTexts createSiteTexts(const std::string& siteName)
+{
+    SiteTexts texts;
+    for (int i = 0; i < siteTextsTotal; ++i) {
+        const std::string name{siteName + ' ' + std::to_string(i)};
+        texts.push_back(SiteText{name, name + " description"});
+    }
+
+    return texts;
+}
+
+void SyntheticGameInfo::createTexts()
+{
+    // Default texts used by Scenario Editor
+    editorInterfaceTexts[CMidgardID("X005TA0777")] = "No scenario objective defined";
+    editorInterfaceTexts[CMidgardID("X005TA0778")] = "Congratulations! You have successfully "
+                                                     "completed the quest.";
+    editorInterfaceTexts[CMidgardID("X005TA0779")] = "You have been defeated, the objective was "
+                                                     "completed by the enemy.";
+
+    for (int i = 0; i < cityNamesTotal; ++i) {
+        cityNames.push_back("City " + std::to_string(i));
+    }
+
+    mercenaryTexts = createSiteTexts("Mercenary camp");
+    mageTexts = createSiteTexts("Mage tower");
+    merchantTexts = createSiteTexts("Merchant");
+    ruinTexts = createSiteTexts("Ruin");
+    trainerTexts = createSiteTexts("Trainer");
+    marketTexts = createSiteTexts("Resource market");
+}
+
+static void createImages(std::set<int>& images, int total)
+{
+    for (int i = 0; i < total; ++i) {
+        images.insert(i);
+    }
+}
+
+static void createImages(GeneratorSettings::ObjectImages& images, int total, int waterTotal)
+{
+    createImages(images.images, total);
+    createImages(images.waterImages, waterTotal);
+}
+
+void SyntheticGameInfo::createGeneratorSettings(RandomGenerator& random)
+{
+    auto& landmarks{generatorSettings.landmarks};
+    std::set<CMidgardID>* raceLandmarks[] = {&landmarks.empire,  &landmarks.clans,
+                                             &landmarks.undead,  &landmarks.legions,
+                                             &landmarks.elves,   &landmarks.neutral};
+
+    // Each landmark looks good on one or two terrains
+    for (const auto landmark : allLandmarks) {
+        const auto& landmarkId{landmark->getLandmarkId()};
+
+        raceLandmarks[random.nextInteger(0, 5)]->insert(landmarkId);
+        if (random.chance(30)) {
+            raceLandmarks[random.nextInteger(0, 5)]->insert(landmarkId);
+        }
+
+        if (landmark->isMountain()) {
+            landmarks.mountains.insert(landmarkId);
+        }
+    }
+
+    // Mountain sizes found in IsoTerrn.ff
+    for (const int size : {1, 2, 3, 5}) {
+        for (int image = 0; image < 3; ++image) {
+            generatorSettings.mountains.push_back(GeneratorSettings::Mountain{size, image});
+        }
+    }
+
+    createImages(generatorSettings.bags, 8, 2);
+    createImages(generatorSettings.ruins, 6, 2);
+    createImages(generatorSettings.merchants, 5, 2);
+    createImages(generatorSettings.mages, 5, 2);
+    createImages(generatorSettings.trainers, 5, 2);
+    createImages(generatorSettings.mercenaries, 5, 2);
+    createImages(generatorSettings.resourceMarkets, 3, 1);
+
+    generatorSettings.maxTreeImageIndex = 10;
+}
+
+void SyntheticGameInfo::buildLandmarksByRace()
+{
+    for (auto landmark : allLandmarks) {
+        const auto& landmarkId{landmark->getLandmarkId()};
+
+        if (isEmpireLandmark(generatorSettings, landmarkId)) {
+            landmarksByRace[RaceType::Human].push_back(landmark);
+        }
+
+        if (isClansLandmark(generatorSettings, landmarkId)) {
+            landmarksByRace[RaceType::Dwarf].push_back(landmark);
+        }
+
+        if (isUndeadLandmark(generatorSettings, landmarkId)) {
+            landmarksByRace[RaceType::Undead].push_back(landmark);
+        }
+
+        if (isLegionsLandmark(generatorSettings, landmarkId)) {
+            landmarksByRace[RaceType::Heretic].push_back(landmark);
+        }
+
+        if (isElvesLandmark(generatorSettings, landmarkId)) {
+            landmarksByRace[RaceType::Elf].push_back(landmark);
+        }
+
+        if (isNeutralLandmark(generatorSettings, landmarkId)) {
+            landmarksByRace[RaceType::Neutral].push_back(landmark);
+        }
+
+        if (isMountainLandmark(generatorSettings, landmarkId)) {
+            mountainLandmarks.push_back(landmark);
+        }
+    }
+}
+
+} // namespace rsg
@@ -0,0 +1,165 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "gameinfo.h"
+#include "generatorsettings.h"
+#include <cstdint>
+#include <map>
+
+namespace rsg {
+
+// In-memory game data for benchmarks, does not need game files.
+// Units, items, spells, landmarks and races are synthesized
+// with sizes and value ranges close to the ones of a game install.
+// Same seed always produces the same data
+class SyntheticGameInfo final : public GameInfo
+{
+public:
+    explicit SyntheticGameInfo(std::uint64_t seed = 1);
+
+    ~SyntheticGameInfo() override = default;
+
+    const UnitsInfo& getUnits() const override;
+
+    const UnitInfoArray& getLeaders() const override;
+
+    const UnitInfoArray& getSoldiers() const override;
+
+    int getMinLeaderValue() const override;
+
+    int getMaxLeaderValue() const override;
+
+    int getMinSoldierValue() const override;
+
+    int getMaxSoldierValue() const override;
+
+    const ItemsInfo& getItemsInfo() const override;
+
+    const ItemInfoArray& getItems() const override;
+
+    const ItemInfoArray& getItems(ItemType itemType) const override;
+
+    const SpellsInfo& getSpellsInfo() const override;
+
+    const SpellInfoArray& getSpells() const override;
+
+    const SpellInfoArray& getSpells(SpellType spellType) const override;
+
+    const LandmarksInfo& getLandmarksInfo() const override;
+
+    const LandmarkInfoArray& getLandmarks(LandmarkType landmarkType) const override;
+
+    const LandmarkInfoArray& getLandmarks(RaceType raceType) const override;
+
+    const LandmarkInfoArray& getMountainLandmarks() const override;
+
+    const RacesInfo& getRacesInfo() const override;
+
+    const RaceInfo& getRaceInfo(RaceType raceType) const override;
+
+    const char* getGlobalText(const CMidgardID& textId) const override;
+
+    const char* getEditorInterfaceText(const CMidgardID& textId) const override;
+
+    const CityNames& getCityNames() const override;
+
+    const SiteTexts& getMercenaryTexts() const override;
+
+    const SiteTexts& getMageTexts() const override;
+
+    const SiteTexts& getMerchantTexts() const override;
+
+    const SiteTexts& getRuinTexts() const override;
+
+    const SiteTexts& getTrainerTexts() const override;
+
+    const SiteTexts& getMarketTexts() const override;
+
+    // Returns generator settings that match synthesized landmarks and images
+    const GeneratorSettings& getGeneratorSettings() const
+    {
+        return generatorSettings;
+    }
+
+private:
+    // Creates playable and neutral races along with their units
+    void createRaces(RandomGenerator& random);
+    // Creates units of neutral subraces
+    void createNeutralUnits(RandomGenerator& random);
+    void createItems(RandomGenerator& random);
+    void createSpells(RandomGenerator& random);
+    void createLandmarks(RandomGenerator& random);
+    void createTexts();
+    void createGeneratorSettings(RandomGenerator& random);
+    void buildLandmarksByRace();
+
+    // Creates unit, its name text and adds it to leaders or soldiers
+    UnitInfo* createUnit(RandomGenerator& random,
+                         const CMidgardID& raceId,
+                         SubRaceType subrace,
+                         UnitType type,
+                         int level);
+
+    CMidgardID createGlobalText(std::string&& text);
+
+    UnitsInfo unitsInfo;
+    UnitInfoArray leaders;
+    UnitInfoArray soldiers;
+
+    int minLeaderValue{};
+    int maxLeaderValue{};
+
+    int minSoldierValue{};
+    int maxSoldierValue{};
+
+    ItemsInfo itemsInfo;
+    ItemInfoArray allItems;
+    std::map<ItemType, ItemInfoArray> itemsByType;
+
+    SpellsInfo spellsInfo;
+    SpellInfoArray allSpells;
+    std::map<SpellType, SpellInfoArray> spellsByType;
+
+    LandmarksInfo landmarksInfo;
+    LandmarkInfoArray allLandmarks;
+    std::map<LandmarkType, LandmarkInfoArray> landmarksByType;
+    std::map<RaceType, LandmarkInfoArray> landmarksByRace;
+    LandmarkInfoArray mountainLandmarks;
+
+    RacesInfo racesInfo;
+
+    TextsInfo globalTexts;
+    TextsInfo editorInterfaceTexts;
+
+    CityNames cityNames;
+
+    SiteTexts mercenaryTexts;
+    SiteTexts mageTexts;
+    SiteTexts merchantTexts;
+    SiteTexts ruinTexts;
+    SiteTexts trainerTexts;
+    SiteTexts marketTexts;
+
+    GeneratorSettings generatorSettings;
+};
+
+} // namespace rsg
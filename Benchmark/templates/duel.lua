@@ -0,0 +1,76 @@
+-- Benchmark template: two players, few small zones
+local function getStacks(scenarioSize, value)
+    return {
+        {
+            count = scenarioSize // 12,
+            value = { min = value, max = value + value // 4 },
+            loot = {
+                itemTypes = { Item.PotionHeal, Item.PotionBoost, Item.Valuable },
+                value = { min = value // 2, max = value },
+            }
+        }
+    }
+end
+
+local function getStartZone(id, race, scenarioSize)
+    return {
+        id = id,
+        type = Zone.PlayerStart,
+        race = race,
+        size = 30,
+        mines = { gold = 1, lifeMana = 1, deathMana = 1 },
+        capital = {
+            garrison = {
+                subraceTypes = { Subrace.Neutral },
+                value = { min = 150, max = 200 },
+            },
+        },
+        towns = {
+            { tier = 1, garrison = { value = { min = 100, max = 150 } } },
+        },
+        merchants = {
+            { goods = { itemTypes = { Item.PotionHeal, Item.Scroll }, value = { min = 800, max = 1200 } } },
+        },
+        stacks = getStacks(scenarioSize, 150),
+        bags = { count = scenarioSize // 16, loot = { value = { min = 100, max = 300 } } },
+    }
+end
+
+template = {
+    name = 'Duel',
+    description = 'Benchmark: two players and a treasure zone between them',
+    minSize = 48,
+    maxSize = 96,
+    maxPlayers = 2,
+    startingGold = 500,
+    roads = 50,
+    forest = 40,
+
+    getContents = function(races, scenarioSize)
+        return {
+            zones = {
+                getStartZone(0, races[1], scenarioSize),
+                getStartZone(1, races[2], scenarioSize),
+                {
+                    id = 2,
+                    type = Zone.Treasure,
+                    size = 40,
+                    mines = { gold = 2, runicMana = 1, infernalMana = 1 },
+                    towns = {
+                        { tier = 3, garrison = { value = { min = 400, max = 500 } } },
+                    },
+                    ruins = {
+                        { gold = { min = 300, max = 400 }, guard = { value = { min = 500, max = 600 } } },
+                    },
+                    stacks = getStacks(scenarioSize, 400),
+                    bags = { count = scenarioSize // 12, loot = { value = { min = 200, max = 500 } } },
+                },
+            },
+
+            connections = {
+                { from = 0, to = 2, guard = { value = { min = 300, max = 350 } } },
+                { from = 1, to = 2, guard = { value = { min = 300, max = 350 } } },
+            }
+        }
+    end,
+}
@@ -0,0 +1,102 @@
+-- Benchmark template: four players around a rich center
+local function getStacks(scenarioSize, value)
+    return {
+        {
+            count = scenarioSize // 10,
+            value = { min = value, max = value + value // 4 },
+            loot = {
+                itemTypes = { Item.PotionHeal, Item.PotionBoost, Item.Armor, Item.Jewel },
+                value = { min = value // 2, max = value },
+                itemValue = { min = 50, max = value },
+            }
+        }
+    }
+end
+
+local function getStartZone(id, race, scenarioSize)
+    return {
+        id = id,
+        type = Zone.PlayerStart,
+        race = race,
+        size = 25,
+        border = Border.SemiOpen,
+        gapChance = 30,
+        mines = { gold = 1, lifeMana = 1, deathMana = 1, groveMana = 1 },
+        towns = {
+            { tier = 1, garrison = { value = { min = 100, max = 150 } } },
+            { tier = 2, garrison = { value = { min = 200, max = 250 } } },
+        },
+        mages = {
+            { spellTypes = { Spell.Attack, Spell.Boost }, value = { min = 1000, max = 1500 } },
+        },
+        stacks = getStacks(scenarioSize, 200),
+        bags = { count = scenarioSize // 12, loot = { value = { min = 100, max = 300 } } },
+    }
+end
+
+local function getTreasureZone(id, scenarioSize)
+    return {
+        id = id,
+        type = Zone.Treasure,
+        size = 15,
+        mines = { gold = 1, runicMana = 1 },
+        ruins = {
+            { gold = { min = 200, max = 300 }, guard = { value = { min = 400, max = 500 } } },
+        },
+        mercenaries = {
+            { subraceTypes = { Subrace.NeutralHuman, Subrace.NeutralElf }, value = { min = 500, max = 800 } },
+        },
+        stacks = getStacks(scenarioSize, 400),
+        bags = { count = scenarioSize // 16, loot = { value = { min = 200, max = 400 } } },
+    }
+end
+
+template = {
+    name = 'Four players',
+    description = 'Benchmark: four players, treasure zones and a center',
+    minSize = 72,
+    maxSize = 144,
+    maxPlayers = 4,
+    startingGold = 500,
+    roads = 60,
+    forest = 45,
+
+    getContents = function(races, scenarioSize)
+        local zones = { }
+        local connections = { }
+
+        for i = 1, 4 do
+            local start = i - 1
+            local treasure = i + 3
+            zones[#zones + 1] = getStartZone(start, races[i], scenarioSize)
+            zones[#zones + 1] = getTreasureZone(treasure, scenarioSize)
+
+            connections[#connections + 1] = { from = start, to = treasure }
+            connections[#connections + 1] = { from = treasure, to = 8, guard = { value = { min = 600, max = 700 } } }
+            -- Neighbour players are also connected through treasure zones
+            connections[#connections + 1] = { from = treasure, to = i % 4 }
+        end
+
+        zones[#zones + 1] = {
+            id = 8,
+            type = Zone.Treasure,
+            size = 30,
+            mines = { gold = 2, infernalMana = 1, runicMana = 1 },
+            towns = {
+                { tier = 4, garrison = { value = { min = 800, max = 900 } } },
+            },
+            merchants = {
+                { goods = { itemTypes = { Item.Armor, Item.Weapon, Item.Banner }, value = { min = 3000, max = 4000 } } },
+            },
+            resourceMarkets = {
+                { stock = { { resource = Resource.Gold, infinite = true } } },
+            },
+            stacks = getStacks(scenarioSize, 800),
+        }
+
+        return {
+            zones = zones,
+            connections = connections,
+        }
+    end,
+}
@@ -0,0 +1,70 @@
+-- Benchmark template: players connected through many small junction zones
+local function getGuard(value)
+    return { value = { min = value, max = value + 100 } }
+end
+
+template = {
+    name = 'Junctions',
+    description = 'Benchmark: junction-heavy layout with many guarded connections',
+    minSize = 72,
+    maxSize = 144,
+    maxPlayers = 4,
+    startingGold = 500,
+    roads = 80,
+    forest = 30,
+
+    getContents = function(races, scenarioSize)
+        local zones = { }
+        local connections = { }
+
+        for i = 1, 4 do
+            zones[#zones + 1] = {
+                id = i - 1,
+                type = Zone.PlayerStart,
+                race = races[i],
+                size = 20,
+                mines = { gold = 1, deathMana = 1 },
+                stacks = {
+                    { count = scenarioSize // 18, value = { min = 150, max = 200 } },
+                },
+            }
+        end
+
+        -- Two junctions between each pair of neighbour players, one more towards center
+        local junction = 4
+        for i = 1, 4 do
+            local from = i - 1
+            local to = i % 4
+
+            zones[#zones + 1] = { id = junction, type = Zone.Junction, size = 4 }
+            zones[#zones + 1] = { id = junction + 1, type = Zone.Junction, size = 4 }
+            zones[#zones + 1] = { id = junction + 2, type = Zone.Junction, size = 3 }
+
+            connections[#connections + 1] = { from = from, to = junction, guard = getGuard(200) }
+            connections[#connections + 1] = { from = junction, to = junction + 1, guard = getGuard(400) }
+            connections[#connections + 1] = { from = junction + 1, to = to, guard = getGuard(200) }
+            connections[#connections + 1] = { from = junction + 1, to = junction + 2, guard = getGuard(600) }
+            connections[#connections + 1] = { from = junction + 2, to = 16, guard = getGuard(900) }
+
+            junction = junction + 3
+        end
+
+        zones[#zones + 1] = {
+            id = 16,
+            type = Zone.Treasure,
+            size = 16,
+            mines = { gold = 2, lifeMana = 1, runicMana = 1 },
+            ruins = {
+                { gold = { min = 500, max = 700 }, guard = getGuard(1200) },
+            },
+            stacks = {
+                { count = scenarioSize // 12, value = { min = 700, max = 900 } },
+            },
+        }
+
+        return {
+            zones = zones,
+            connections = connections,
+        }
+    end,
+}
@@ -0,0 +1,92 @@
+-- Benchmark template: two players with large zones full of objects
+local function getStacks(scenarioSize, value)
+    return {
+        {
+            count = scenarioSize // 4,
+            value = { min = value, max = value * 2 },
+            loot = {
+                itemTypes = { Item.PotionHeal, Item.PotionRevive, Item.Talisman, Item.Orb, Item.Wand },
+                value = { min = value // 2, max = value },
+            }
+        },
+        {
+            count = scenarioSize // 8,
+            value = { min = value * 2, max = value * 3 },
+            loot = {
+                itemTypes = { Item.Armor, Item.Weapon, Item.Jewel, Item.Banner },
+                value = { min = value, max = value * 2 },
+            }
+        }
+    }
+end
+
+local function getSites()
+    return {
+        ruins = {
+            { gold = { min = 200, max = 300 }, guard = { value = { min = 400, max = 500 } } },
+            { gold = { min = 400, max = 600 }, guard = { value = { min = 800, max = 900 } } },
+        },
+        merchants = {
+            { goods = { itemTypes = { Item.PotionHeal, Item.PotionBoost }, value = { min = 1000, max = 1500 } } },
+        },
+        mages = {
+            { spellTypes = { Spell.Attack, Spell.Heal, Spell.Lower }, value = { min = 1500, max = 2000 } },
+        },
+        mercenaries = {
+            { subraceTypes = { Subrace.NeutralBarbarian, Subrace.NeutralGreenSkin }, value = { min = 600, max = 900 } },
+        },
+        trainers = {
+            { guard = { value = { min = 300, max = 400 } } },
+        },
+    }
+end
+
+local function getZone(id, type, race, scenarioSize)
+    local sites = getSites()
+    return {
+        id = id,
+        type = type,
+        race = race,
+        size = 50,
+        mines = { gold = 3, lifeMana = 2, deathMana = 2, infernalMana = 2, runicMana = 2, groveMana = 2 },
+        towns = {
+            { tier = 1, garrison = { value = { min = 100, max = 150 } } },
+            { tier = 3, garrison = { value = { min = 400, max = 500 } } },
+            { tier = 5, garrison = { value = { min = 900, max = 1000 } } },
+        },
+        ruins = sites.ruins,
+        merchants = sites.merchants,
+        mages = sites.mages,
+        mercenaries = sites.mercenaries,
+        trainers = sites.trainers,
+        stacks = getStacks(scenarioSize, 200),
+        bags = { count = scenarioSize // 6, loot = { value = { min = 200, max = 400 } } },
+    }
+end
+
+template = {
+    name = 'Large zones',
+    description = 'Benchmark: few large zones with many objects',
+    minSize = 96,
+    maxSize = 144,
+    maxPlayers = 2,
+    startingGold = 1000,
+    roads = 40,
+    forest = 50,
+
+    getContents = function(races, scenarioSize)
+        return {
+            zones = {
+                getZone(0, Zone.PlayerStart, races[1], scenarioSize),
+                getZone(1, Zone.PlayerStart, races[2], scenarioSize),
+                getZone(2, Zone.Treasure, nil, scenarioSize),
+            },
+
+            connections = {
+                { from = 0, to = 2, guard = { value = { min = 500, max = 600 } } },
+                { from = 1, to = 2, guard = { value = { min = 500, max = 600 } } },
+                { from = 0, to = 1, guard = { value = { min = 1500, max = 1600 } } },
+            }
+        }
+    end,
+}
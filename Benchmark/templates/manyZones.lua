@@ -0,0 +1,58 @@
+-- Benchmark template: two players and a long chain of small treasure zones
+local treasureZones = 14
+
+local function getStacks(scenarioSize, value)
+    return {
+        {
+            count = scenarioSize // 24,
+            value = { min = value, max = value + value // 4 },
+            loot = {
+                itemTypes = { Item.PotionHeal, Item.Valuable, Item.Scroll },
+                value = { min = value // 2, max = value },
+            }
+        }
+    }
+end
+
+template = {
+    name = 'Many zones',
+    description = 'Benchmark: many small zones placed around the map',
+    minSize = 96,
+    maxSize = 144,
+    maxPlayers = 2,
+    startingGold = 500,
+    roads = 50,
+    forest = 35,
+
+    getContents = function(races, scenarioSize)
+        local zones = {
+            { id = 0, type = Zone.PlayerStart, race = races[1], size = 12, mines = { gold = 1 } },
+            { id = 1, type = Zone.PlayerStart, race = races[2], size = 12, mines = { gold = 1 } },
+        }
+        local connections = { }
+
+        local previous = 0
+        for i = 1, treasureZones do
+            local id = i + 1
+            zones[#zones + 1] = {
+                id = id,
+                type = Zone.Treasure,
+                size = 6,
+                mines = { gold = 1 },
+                towns = i % 3 == 0 and { { tier = 2, garrison = { value = { min = 200, max = 300 } } } } or nil,
+                stacks = getStacks(scenarioSize, 150 + i * 30),
+                bags = { count = 2, loot = { value = { min = 100, max = 200 } } },
+            }
+
+            connections[#connections + 1] = { from = previous, to = id, guard = { value = { min = 100 + i * 20, max = 150 + i * 20 } } }
+            previous = id
+        end
+
+        connections[#connections + 1] = { from = previous, to = 1 }
+
+        return {
+            zones = zones,
+            connections = connections,
+        }
+    end,
+}
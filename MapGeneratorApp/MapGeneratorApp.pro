@@ -25,6 +25,11 @@ DEFINES += \
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Uncomment to measure time spent in generation phases, see profiler.h
+#DEFINES += RSG_PROFILING
+# Uncomment together with RSG_PROFILING to count memory allocations of each profiled scope
+#DEFINES += RSG_TRACK_ALLOCATIONS
+
 CONFIG += c++17
 
 INCLUDEPATH += \
@@ -37,17 +42,27 @@ INCLUDEPATH += \
 
 SOURCES += \
         ../ScenarioGenerator/src/blueprint.cpp \
+        ../ScenarioGenerator/src/catalog.cpp \
         ../ScenarioGenerator/src/currency.cpp \
         ../ScenarioGenerator/src/decoration.cpp \
+        ../ScenarioGenerator/src/forbiddenfilter.cpp \
         ../ScenarioGenerator/src/gameinfo.cpp \
+        ../ScenarioGenerator/src/generationattempts.cpp \
         ../ScenarioGenerator/src/generatorsettings.cpp \
         ../ScenarioGenerator/src/image.cpp \
         ../ScenarioGenerator/src/itempicker.cpp \
         ../ScenarioGenerator/src/landmarkpicker.cpp \
+        ../ScenarioGenerator/src/lootindex.cpp \
+        ../ScenarioGenerator/src/luaarena.cpp \
+        ../ScenarioGenerator/src/luastatepool.cpp \
         ../ScenarioGenerator/src/mapgenerator.cpp \
+        ../ScenarioGenerator/src/pathsearch.cpp \
+        ../ScenarioGenerator/src/previewrasterizer.cpp \
+        ../ScenarioGenerator/src/profiler.cpp \
         ../ScenarioGenerator/src/maptemplatereader.cpp \
         ../ScenarioGenerator/src/rsgid.cpp \
         ../ScenarioGenerator/src/mqdb.cpp \
+        ../ScenarioGenerator/src/mappedfile.cpp \
         ../ScenarioGenerator/src/scenario/bag.cpp \
         ../ScenarioGenerator/src/scenario/capital.cpp \
         ../ScenarioGenerator/src/scenario/crystal.cpp \
@@ -85,11 +100,15 @@ SOURCES += \
         ../ScenarioGenerator/src/scenario/unit.cpp \
         ../ScenarioGenerator/src/scenario/village.cpp \
         ../ScenarioGenerator/src/serializer.cpp \
+        ../ScenarioGenerator/src/snapshot.cpp \
         ../ScenarioGenerator/src/spellpicker.cpp \
+        ../ScenarioGenerator/src/templatecache.cpp \
         ../ScenarioGenerator/src/templatezone.cpp \
         ../ScenarioGenerator/src/textconvert.cpp \
         ../ScenarioGenerator/src/texts.cpp \
+        ../ScenarioGenerator/src/unitindex.cpp \
         ../ScenarioGenerator/src/unitpicker.cpp \
+        ../ScenarioGenerator/src/zonefillbuffer.cpp \
         ../ScenarioGenerator/src/zoneplacer.cpp \
         ../dbf.cpp \
         ../lua/lapi.c \
@@ -125,6 +144,7 @@ SOURCES += \
         ../lua/lvm.c \
         ../lua/lzio.c \
         ../standalonegameinfo.cpp \
+        ../standalonegameinfosnapshot.cpp \
         main.cpp \
         mapgeneratorapp.cpp \
         mapgeneratorthread.cpp
@@ -132,25 +152,39 @@ SOURCES += \
 HEADERS += \
         ../ScenarioGenerator/src/aipriority.h \
         ../ScenarioGenerator/src/blueprint.h \
+        ../ScenarioGenerator/src/cancellationtoken.h \
+        ../ScenarioGenerator/src/catalog.h \
         ../ScenarioGenerator/src/containers.h \
         ../ScenarioGenerator/src/currency.h \
         ../ScenarioGenerator/src/decoration.h \
         ../ScenarioGenerator/src/enums.h \
         ../ScenarioGenerator/src/exceptions.h \
+        ../ScenarioGenerator/src/forbiddenfilter.h \
         ../ScenarioGenerator/src/gameinfo.h \
+        ../ScenarioGenerator/src/generationattempts.h \
+        ../ScenarioGenerator/src/generationcontext.h \
+        ../ScenarioGenerator/src/generationprogress.h \
         ../ScenarioGenerator/src/generatorsettings.h \
         ../ScenarioGenerator/src/image.h \
         ../ScenarioGenerator/src/iteminfo.h \
         ../ScenarioGenerator/src/itempicker.h \
         ../ScenarioGenerator/src/landmarkinfo.h \
         ../ScenarioGenerator/src/landmarkpicker.h \
+        ../ScenarioGenerator/src/lootindex.h \
+        ../ScenarioGenerator/src/luaarena.h \
+        ../ScenarioGenerator/src/luastatepool.h \
         ../ScenarioGenerator/src/mapgenerator.h \
         ../ScenarioGenerator/src/maptemplate.h \
         ../ScenarioGenerator/src/maptemplatereader.h \
         ../ScenarioGenerator/src/rsgid.h \
         ../ScenarioGenerator/src/mqdb.h \
+        ../ScenarioGenerator/src/mappedfile.h \
         ../ScenarioGenerator/src/picker.h \
+        ../ScenarioGenerator/src/pathsearch.h \
         ../ScenarioGenerator/src/position.h \
+        ../ScenarioGenerator/src/positiongrid.h \
+        ../ScenarioGenerator/src/previewrasterizer.h \
+        ../ScenarioGenerator/src/profiler.h \
         ../ScenarioGenerator/src/raceinfo.h \
         ../ScenarioGenerator/src/randomgenerator.h \
         ../ScenarioGenerator/src/scenario/bag.h \
@@ -193,16 +227,20 @@ HEADERS += \
         ../ScenarioGenerator/src/scenario/unit.h \
         ../ScenarioGenerator/src/scenario/village.h \
         ../ScenarioGenerator/src/serializer.h \
+        ../ScenarioGenerator/src/snapshot.h \
         ../ScenarioGenerator/src/spellinfo.h \
         ../ScenarioGenerator/src/spellpicker.h \
         ../ScenarioGenerator/src/stb_image_write.h \
+        ../ScenarioGenerator/src/templatecache.h \
         ../ScenarioGenerator/src/templatezone.h \
         ../ScenarioGenerator/src/textconvert.h \
         ../ScenarioGenerator/src/texts.h \
         ../ScenarioGenerator/src/tileinfo.h \
+        ../ScenarioGenerator/src/unitindex.h \
         ../ScenarioGenerator/src/unitinfo.h \
         ../ScenarioGenerator/src/unitpicker.h \
         ../ScenarioGenerator/src/vposition.h \
+        ../ScenarioGenerator/src/zonefillbuffer.h \
         ../ScenarioGenerator/src/zoneid.h \
         ../ScenarioGenerator/src/zoneoptions.h \
         ../ScenarioGenerator/src/zoneplacer.h \
@@ -4,13 +4,18 @@
 #include "maptemplatereader.h"
 #include "mapgenerator.h"
 #include "mapgeneratorthread.h"
-#include "image.h"
+#include "profiler.h"
 #include "version.h"
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QImage>
+#include <QPainter>
 #include <QDebug>
 #include <QComboBox>
+#include <QListWidgetItem>
+#include <algorithm>
+#include <sstream>
+#include <thread>
 
 static const char* getRaceLabel(rsg::RaceType race)
 {
@@ -44,6 +49,32 @@ static int getComboBoxIndex(rsg::RaceType race)
     }
 }
 
+static rsg::PreviewImage toPreviewImage(QImage& image)
+{
+    return rsg::PreviewImage{image.bits(), static_cast<std::size_t>(image.bytesPerLine())};
+}
+
+// Zones and contents of generated scenario side by side
+static QIcon createThumbnail(const rsg::MapGenerator& generator)
+{
+    const int size = generator.mapGenOptions.size;
+    QImage zones(size, size, QImage::Format_RGB888);
+    QImage contents(size, size, QImage::Format_RGB888);
+
+    rsg::PreviewRasterizer rasterizer;
+    rasterizer.update(generator, toPreviewImage(zones), toPreviewImage(contents));
+
+    const int thumbnailSize = 96;
+    QPixmap thumbnail(thumbnailSize * 2, thumbnailSize);
+
+    QPainter painter(&thumbnail);
+    painter.drawImage(QRect(0, 0, thumbnailSize, thumbnailSize), zones);
+    painter.drawImage(QRect(thumbnailSize, 0, thumbnailSize, thumbnailSize), contents);
+    painter.end();
+
+    return QIcon(thumbnail);
+}
+
 static rsg::RaceType comboBoxIndexToRace(int index)
 {
     using namespace rsg;
@@ -82,24 +113,93 @@ MapGeneratorApp::MapGeneratorApp(QWidget *parent) :
 
 MapGeneratorApp::~MapGeneratorApp()
 {
+    // Stop generation right away instead of waiting for it to complete
+    for (auto& candidate : candidates) {
+        if (candidate.thread) {
+            candidate.thread->cancel();
+        }
+    }
+
+    for (auto& candidate : candidates) {
+        if (candidate.thread) {
+            candidate.thread->wait();
+        }
+    }
+
     delete ui;
 }
 
 void MapGeneratorApp::onScenarioMapGenerated(rsg::Map *scenarioMap, const QString &error)
 {
+    rsg::MapPtr map{scenarioMap};
+
+    auto thread = qobject_cast<MapGeneratorThread*>(sender());
+    const int index = findCandidate(thread);
+    if (index < 0) {
+        return;
+    }
+
+    auto& candidate = candidates[index];
+    candidate.finished = true;
+    candidate.percent = 100;
+
+    if (error.isEmpty()) {
+        candidate.generation = thread->takeAttempt();
+        candidate.scenario = std::move(map);
+        // Seed that succeeded, differs from requested one after retries
+        candidate.seed = thread->getScenarioSeed();
+    } else {
+        candidate.error = error;
+    }
+
+    addCandidateItem(index);
+
+    const bool running = std::any_of(candidates.begin(), candidates.end(),
+                                     [](const Candidate& other) { return !other.finished; });
+    if (running) {
+        showGenerationProgress();
+        return;
+    }
+
+    ui->generateButton->setText(generateButtonText);
     // Enable buttons
     enableButtons();
 
-    if (!error.isEmpty()) {
-        QMessageBox::critical(this, tr("Error"), error);
+#ifdef RSG_PROFILING
+    // Profile of each generation is written next to the application
+    std::ostringstream profileSummary;
+    rsg::Profiler::instance().writeSummary(profileSummary);
+    qDebug().noquote() << QString::fromStdString(profileSummary.str());
+    rsg::Profiler::instance().writeTrace("trace.json");
+    rsg::Profiler::instance().clear();
+#endif
+
+    if (!selectedCandidate) {
+        // All candidates failed, show error of the first one
+        QMessageBox::critical(this, tr("Error"), candidates.front().error);
+    }
+}
+
+void MapGeneratorApp::onGenerationProgress(int percent)
+{
+    const int index = findCandidate(sender());
+    if (index < 0) {
         return;
     }
 
-    scenario.reset(scenarioMap);
-    // Allow to save generated scenario
-    ui->saveScenarioButtom->setEnabled(true);
-    // Update zone and contents images
-    updatePreviewImages();
+    candidates[index].percent = percent;
+    showGenerationProgress();
+}
+
+void MapGeneratorApp::onGenerationPreview()
+{
+    auto thread = qobject_cast<MapGeneratorThread*>(sender());
+    if (!thread) {
+        return;
+    }
+
+    // Show progress of generation as it goes
+    drawPreview(thread->takePreview(zonesPreview, contentsPreview));
 }
 
 void MapGeneratorApp::seedPlaceholderUpdate()
@@ -189,8 +289,10 @@ bool MapGeneratorApp::readGameInfo(const std::filesystem::path &gameFolder)
     }
 
     try {
-        gameInfo = std::make_unique<rsg::StandaloneGameInfo>(gameFolder);
-        rsg::setGameInfo(gameInfo.get());
+        const auto snapshotPath{rsg::StandaloneGameInfo::getDefaultSnapshotPath(gameFolder)};
+        auto info{std::make_unique<rsg::StandaloneGameInfo>(gameFolder, snapshotPath)};
+        context = std::make_unique<rsg::GenerationContext>(*info, info->getGeneratorSettings());
+        gameInfo = std::move(info);
         return true;
     } catch (const std::exception& e) {
         QMessageBox::critical(this, tr("Error"), tr("%1").arg(e.what()));
@@ -203,10 +305,12 @@ void MapGeneratorApp::readTemplateAndUpdateUi(const std::filesystem::path& templ
     try {
         MapTemplatePtr tmplt = std::make_unique<rsg::MapTemplate>();
 
-        tmplt->settings = rsg::readTemplateSettings(templatePath, lua);
+        tmplt->settings = templateCache.readTemplateSettings(templatePath, lua);
 
         mapTemplate = std::move(tmplt);
         templateFilePath = templatePath;
+        // Contents are generated in pooled states, each run starts without garbage of previous
+        templateStates = std::make_unique<rsg::LuaStatePool>(templateCache, templatePath);
     }
     catch (const std::runtime_error& e) {
         QMessageBox::critical(this, tr("Error"), tr("Could not read template file\n%1").arg(e.what()));
@@ -233,6 +337,9 @@ void MapGeneratorApp::readTemplateAndUpdateUi(const std::filesystem::path& templ
     ui->forestSpinBox->setValue(settings.forest);
     ui->forestSpinBox->setEnabled(true);
 
+    // Allow user to generate several scenarios at once and choose one of them
+    ui->candidatesSpinBox->setEnabled(true);
+
     // Allow user to select scenario size
     updateRadioButtons();
     updateRaceButtons();
@@ -261,6 +368,7 @@ void MapGeneratorApp::disableButtons(bool forGeneration)
     ui->seedEdit->setEnabled(false);
 
     ui->goldSpinBox->setEnabled(false);
+    ui->candidatesSpinBox->setEnabled(false);
 
     ui->roadsSpinBox->setEnabled(false);
     ui->forestSpinBox->setEnabled(false);
@@ -323,6 +431,7 @@ void MapGeneratorApp::enableButtons()
     ui->scenarioTemplateButtonReload->setEnabled(true);
 
     ui->goldSpinBox->setEnabled(true);
+    ui->candidatesSpinBox->setEnabled(true);
 
     ui->roadsSpinBox->setEnabled(true);
     ui->forestSpinBox->setEnabled(true);
@@ -490,85 +599,51 @@ std::time_t MapGeneratorApp::getScenarioSeed()
     return seed;
 }
 
-void MapGeneratorApp::updatePreviewImages()
+void MapGeneratorApp::updatePreviewImages(const rsg::MapGenerator& generator)
 {
-    using namespace rsg;
+    const auto size = generator.mapGenOptions.size;
 
-    const size_t width = static_cast<size_t>(options.size);
-    const size_t height = static_cast<size_t>(options.size);
-    const auto pixelsTotal{width * height};
-
-    std::vector<RgbColor> pixels(pixelsTotal);
-    std::vector<RgbColor> pixels2(pixelsTotal);
-
-    for (size_t i = 0; i < width; ++i) {
-        for (size_t j = 0; j < height; ++j) {
-            Position pos{static_cast<int>(i), static_cast<int>(j)};
-
-            // clang-format off
-            static const RgbColor colors[] = {
-                RgbColor{255, 0, 0},        // red
-                RgbColor{0, 255, 0},        // green
-                RgbColor{0, 0, 255},        // blue
-                RgbColor{255, 255, 255},    // white
-                RgbColor{0, 0, 0},          // black
-                RgbColor{127, 127, 127},    // gray
-                RgbColor{255, 255, 0},      // yellow
-                RgbColor{0, 255, 255},      // cyan
-                RgbColor{255, 0, 255},      // magenta
-                RgbColor{255, 153, 0},      // orange
-                RgbColor{127, 0, 0},        // dark red
-                RgbColor{0, 127, 0},        // dark green
-                RgbColor{0, 0, 127},        // dark blue
-                RgbColor{64, 64, 64},       // dark gray
-                RgbColor{127, 127, 0},      // dark yellow
-                RgbColor{0, 127, 127},      // dark cyan
-                RgbColor{127, 0, 127},      // violet
-                RgbColor{127, 64, 0},       // brown
-            };
-            // clang-format on
-
-            const std::size_t index = i + width * j;
-
-            const auto zoneId{generator->zoneColoring[generator->posToIndex(pos)]};
-
-            if (zoneId < std::size(colors)) {
-                pixels[index] = colors[zoneId];
-            }
-            else {
-                std::uint8_t c = 32 + 10 * (zoneId - std::size(colors));
-                pixels[index] = RgbColor(c, c, c);
-            }
+    if (zonesPreview.width() != size) {
+        zonesPreview = QImage(size, size, QImage::Format_RGB888);
+        contentsPreview = QImage(size, size, QImage::Format_RGB888);
+    }
 
-            auto& tile{generator->tiles[generator->posToIndex(pos)]};
-
-            if (tile.isRoad()) {
-                pixels2[index] = RgbColor(175, 175, 175); // grey
-            } else if (tile.isUsed()) {
-                pixels2[index] = RgbColor(237, 177, 100); // yellow
-            } else if (tile.isBlocked()) {
-                pixels2[index] = RgbColor(255, 0, 0); // red
-            } else if (tile.isFree()) {
-                pixels2[index] = RgbColor(255, 255, 255); // white
-            } else if (tile.isPossible()) {
-                pixels2[index] = RgbColor(255, 179, 185); // pink
-            } else {
-                pixels2[index] = RgbColor(0, 0, 0); // black for all other
-            }
-        }
+    // Images could show progress of another attempt, draw them completely
+    previewRasterizer.reset();
+    const auto changed = previewRasterizer.update(generator, toPreviewImage(zonesPreview),
+                                                  toPreviewImage(contentsPreview));
+
+    drawPreview(QRect(changed.x, changed.y, changed.width, changed.height));
+}
+
+void MapGeneratorApp::drawPreview(const QRect& changedTiles)
+{
+    if (changedTiles.isEmpty() || zonesPreview.isNull()) {
+        return;
     }
 
-    auto zonesData = reinterpret_cast<uchar*>(pixels.data());
-    QImage zonesImage(zonesData, options.size, options.size, QImage::Format_RGB888);
-    auto zonesPixmap = QPixmap::fromImage(zonesImage);
+    const int pixmapSize = 288;
+    if (zonesPixmap.isNull()) {
+        zonesPixmap = QPixmap(pixmapSize, pixmapSize);
+        contentsPixmap = QPixmap(pixmapSize, pixmapSize);
+    }
 
-    ui->zonesImage->setPixmap(zonesPixmap.scaled(288, 288));
+    const qreal scale = static_cast<qreal>(pixmapSize) / zonesPreview.width();
+    const QRectF target(changedTiles.x() * scale, changedTiles.y() * scale,
+                        changedTiles.width() * scale, changedTiles.height() * scale);
 
-    auto contentData = reinterpret_cast<uchar*>(pixels2.data());
-    QImage contentImage(contentData, options.size, options.size, QImage::Format_RGB888);
-    auto contentPixmap = QPixmap::fromImage(contentImage);
+    {
+        QPainter painter(&zonesPixmap);
+        painter.drawImage(target, zonesPreview, changedTiles);
+    }
+
+    {
+        QPainter painter(&contentsPixmap);
+        painter.drawImage(target, contentsPreview, changedTiles);
+    }
 
-    ui->contentsImage->setPixmap(contentPixmap.scaled(288, 288));
+    ui->zonesImage->setPixmap(zonesPixmap);
+    ui->contentsImage->setPixmap(contentsPixmap);
 }
 
 void MapGeneratorApp::getSelectedRaces(std::vector<rsg::RaceType>& races, int maxPlayers)
@@ -596,6 +671,57 @@ void MapGeneratorApp::getSelectedRaces(std::vector<rsg::RaceType>& races, int ma
     }
 }
 
+int MapGeneratorApp::findCandidate(const QObject* thread) const
+{
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        if (thread && candidates[i].thread.data() == thread) {
+            return static_cast<int>(i);
+        }
+    }
+
+    return -1;
+}
+
+void MapGeneratorApp::showGenerationProgress()
+{
+    if (candidates.empty()) {
+        return;
+    }
+
+    // Average of all candidates, finished ones are complete
+    int percentTotal{};
+    for (const auto& candidate : candidates) {
+        percentTotal += candidate.percent;
+    }
+
+    const int percent = percentTotal / static_cast<int>(candidates.size());
+    ui->generateButton->setText(QString("%1 %2%").arg(generateButtonText).arg(percent));
+}
+
+void MapGeneratorApp::addCandidateItem(int index)
+{
+    const auto& candidate = candidates[index];
+
+    auto item = new QListWidgetItem(QString("%1").arg(candidate.seed));
+    item->setData(Qt::UserRole, index);
+
+    if (candidate.generation) {
+        item->setIcon(createThumbnail(*candidate.generation->generator));
+    } else {
+        // Failed candidates can not be chosen
+        item->setText(tr("Error"));
+        item->setToolTip(candidate.error);
+        item->setFlags(Qt::NoItemFlags);
+    }
+
+    ui->candidatesList->addItem(item);
+
+    if (!selectedCandidate && candidate.scenario) {
+        // Show the first finished candidate right away
+        ui->candidatesList->setCurrentItem(item);
+    }
+}
+
 void MapGeneratorApp::on_scenarioTemplateButton_clicked()
 {
     const QString filepath = QFileDialog::getOpenFileName(this,
@@ -621,51 +747,90 @@ void MapGeneratorApp::on_generateButton_clicked()
 
     using namespace rsg;
 
-    const auto seed = getScenarioSeed();
-    const auto seedString = std::to_string(seed);
+    requestedSeed = getScenarioSeed();
 
     auto& settings = mapTemplate->settings;
     settings.size = scenarioSize;
     getSelectedRaces(settings.races, settings.maxPlayers);
 
-    // Create options
-    options = MapGenOptions();
-    options.mapTemplate = mapTemplate.get();
-    options.name = std::string{"Random scenario "} + seedString;
-    options.description = std::string{"Random scenario based on template '"}
-            + settings.name
-            + std::string{"'. Seed: "} + seedString
-            + ". Starting gold: " + std::to_string(settings.startingGold)
-            + ". Roads: " + std::to_string(settings.roads)
-            + "%. Forest: " + std::to_string(settings.forest)
-            + "%.";
-    options.size = settings.size;
-    // Create generator
-    generator = std::make_unique<rsg::MapGenerator>(options, seed);
+    // Each attempt uses its own copy of template settings and its own contents.
+    // Attempts are created in generation threads, template contents are evaluated there too
+    auto createAttempt = [this, settings](std::time_t seed) {
+        const auto seedString = std::to_string(seed);
+
+        auto attempt = std::make_unique<GenerationAttempt>();
+        attempt->mapTemplate = std::make_unique<MapTemplate>();
+
+        auto& attemptSettings = attempt->mapTemplate->settings;
+        attemptSettings = settings;
+
+        // Create options
+        MapGenOptions options;
+        options.mapTemplate = attempt->mapTemplate.get();
+        options.name = std::string{"Random scenario "} + seedString;
+        options.description = std::string{"Random scenario based on template '"}
+                + attemptSettings.name
+                + std::string{"'. Seed: "} + seedString
+                + ". Starting gold: " + std::to_string(attemptSettings.startingGold)
+                + ". Roads: " + std::to_string(attemptSettings.roads)
+                + "%. Forest: " + std::to_string(attemptSettings.forest)
+                + "%.";
+        options.size = attemptSettings.size;
+        // Create generator
+        attempt->generator = std::make_unique<MapGenerator>(*context, options, seed);
+
+        attemptSettings.replaceRandomRaces(attempt->generator->randomGenerator);
+        // Generate new contents according to user settings
+        auto templateState{templateStates->acquire()};
+        readTemplateContents(*attempt->mapTemplate, templateState.getLua());
 
-    try {
-        // Cleanup previous contents, if any
-        mapTemplate->contents = MapTemplateContents();
+        return attempt;
+    };
 
-        settings.replaceRandomRaces(generator->randomGenerator);
-        // Generate new contents according to user settings
-        readTemplateContents(*mapTemplate, lua);
-    }
-    catch (const std::exception& e)
-    {
-        QMessageBox::critical(this, tr("Error"), tr("Could not generate template contents. Reason: %1").arg(e.what()));
-    }
+    const auto candidatesTotal = static_cast<unsigned int>(ui->candidatesSpinBox->value());
+
+    // Candidates share all cores, each retries tight templates with other seeds right away
+    GenerationAttemptOptions attemptOptions;
+    attemptOptions.parallelAttempts = std::max(1u, std::thread::hardware_concurrency()
+                                                       / candidatesTotal);
+    attemptOptions.maxAttempts = attemptOptions.parallelAttempts * 4;
+    attemptOptions.speculative = true;
 
     // Remember radio button states
     rememberRadioButtonStates();
     // Disable buttons
     disableButtons(true);
-    // Start generation in another thread, wait for signal
-    auto thread = new MapGeneratorThread(generator.get(), this);
+    generateButtonText = ui->generateButton->text();
+
+    ui->candidatesList->clear();
+    selectedCandidate = nullptr;
+    candidates.clear();
+    candidates.resize(candidatesTotal);
+
+    // Start each candidate generation in its own thread, wait for signals
+    for (unsigned int i = 0; i < candidatesTotal; ++i) {
+        // Candidates use consecutive seeds, their retries derive other seeds from them
+        const std::time_t seed = requestedSeed + i;
+
+        auto thread = new MapGeneratorThread(createAttempt, seed, attemptOptions, this);
+        candidates[i].thread = thread;
+        candidates[i].seed = seed;
+
+        connect(thread, &MapGeneratorThread::mapGenerated, this,
+                &MapGeneratorApp::onScenarioMapGenerated);
+        connect(thread, &MapGeneratorThread::progressChanged, this,
+                &MapGeneratorApp::onGenerationProgress);
+        if (candidatesTotal == 1) {
+            // Previews of several candidates would overwrite each other
+            connect(thread, &MapGeneratorThread::previewChanged, this,
+                    &MapGeneratorApp::onGenerationPreview);
+        }
+        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    }
 
-    connect(thread, &MapGeneratorThread::mapGenerated, this, &MapGeneratorApp::onScenarioMapGenerated);
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start();
+    for (auto& candidate : candidates) {
+        candidate.thread->start();
+    }
 }
 
 void MapGeneratorApp::on_saveScenarioButtom_clicked()
@@ -678,16 +843,27 @@ void MapGeneratorApp::on_saveScenarioButtom_clicked()
         return;
     }
 
-    // Remember radio button states
-    rememberRadioButtonStates();
-    // Disable buttons
-    disableButtons(true);
+    // Chosen candidate can be saved while others are still generated
+    const bool generating = std::any_of(candidates.begin(), candidates.end(),
+                                        [](const Candidate& candidate) {
+                                            return !candidate.finished;
+                                        });
+    if (!generating) {
+        // Remember radio button states
+        rememberRadioButtonStates();
+        // Disable buttons
+        disableButtons(true);
+    }
 
     const std::filesystem::path scenarioPath{filePath.toStdString()};
+    auto& scenario = selectedCandidate->scenario;
     scenario->author = std::string("mss32 rsg v ") + VER_PRODUCTVERSION_STR;
     scenario->serialize(scenarioPath);
 
-    enableButtons();
+    if (!generating) {
+        enableButtons();
+    }
+
     ui->saveScenarioButtom->setEnabled(true);
 }
 
@@ -736,3 +912,28 @@ void MapGeneratorApp::on_goldSpinBox_valueChanged(int gold)
 
     mapTemplate->settings.startingGold = gold;
 }
+
+void MapGeneratorApp::on_candidatesList_currentRowChanged(int row)
+{
+    auto item = ui->candidatesList->item(row);
+    if (!item) {
+        return;
+    }
+
+    auto& candidate = candidates[item->data(Qt::UserRole).toInt()];
+    if (!candidate.scenario) {
+        return;
+    }
+
+    selectedCandidate = &candidate;
+
+    // Show seed of chosen scenario so it can be generated again
+    if (candidates.size() > 1 || candidate.seed != requestedSeed) {
+        ui->seedEdit->setText(QString("%1").arg(candidate.seed));
+    }
+
+    // Allow to save chosen scenario
+    ui->saveScenarioButtom->setEnabled(true);
+    // Update zone and contents images
+    updatePreviewImages(*candidate.generation->generator);
+}
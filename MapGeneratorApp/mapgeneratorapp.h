@@ -1,11 +1,19 @@
 #ifndef MAPGENERATORAPP_H
 #define MAPGENERATORAPP_H
 
+#include "generationattempts.h"
+#include "luastatepool.h"
 #include "maptemplate.h"
 #include "mapgenerator.h"
+#include "previewrasterizer.h"
 #include "standalonegameinfo.h"
+#include "templatecache.h"
 #include <filesystem>
 #include <memory>
+#include <vector>
+#include <QImage>
+#include <QPixmap>
+#include <QPointer>
 #include <QWidget>
 #include <QTimer>
 #include <sol/sol.hpp>
@@ -14,6 +22,8 @@ namespace Ui {
 class MapGeneratorApp;
 }
 
+class MapGeneratorThread;
+
 class MapGeneratorApp : public QWidget
 {
     Q_OBJECT
@@ -24,6 +34,8 @@ public:
 
 public slots:
     void onScenarioMapGenerated(rsg::Map* scenarioMap, const QString& error);
+    void onGenerationProgress(int percent);
+    void onGenerationPreview();
     void seedPlaceholderUpdate();
     void onRaceSelected(int comboBoxIndex);
 
@@ -44,6 +56,8 @@ private slots:
 
     void on_goldSpinBox_valueChanged(int gold);
 
+    void on_candidatesList_currentRowChanged(int row);
+
 signals:
     void startGeneration();
 
@@ -69,10 +83,20 @@ private:
     int getSelectedScenarioSize();
     std::time_t getScenarioSeed();
 
-    void updatePreviewImages();
+    void updatePreviewImages(const rsg::MapGenerator& generator);
+    // Draws changed tiles of preview images into zone and contents pixmaps
+    void drawPreview(const QRect& changedTiles);
     void getSelectedRaces(std::vector<rsg::RaceType>& races, int maxPlayers);
-
+    // Returns index of candidate generated by thread or -1
+    int findCandidate(const QObject* thread) const;
+    void showGenerationProgress();
+    // Adds thumbnail of finished candidate to candidates list
+    void addCandidateItem(int index);
+
+    // Declared before lua state that uses it
+    rsg::TemplateCache templateCache{rsg::TemplateCache::getDefaultFolder()};
     sol::state lua;
+    std::unique_ptr<rsg::LuaStatePool> templateStates;
     Ui::MapGeneratorApp *ui;
 
     QTimer seedPlaceholderTimer;
@@ -80,15 +104,41 @@ private:
 
     using MapTemplatePtr = std::unique_ptr<rsg::MapTemplate>;
     MapTemplatePtr mapTemplate;
-    rsg::MapGenOptions options;
 
-    using MapGeneratorPtr = std::unique_ptr<rsg::MapGenerator>;
-    MapGeneratorPtr generator;
+    // Scenario generated from its own seed, user chooses one of them to save
+    struct Candidate
+    {
+        // Running generation, cancelled when window is closed
+        QPointer<MapGeneratorThread> thread;
+        // Attempt that generated scenario, used for preview
+        rsg::GenerationAttemptPtr generation;
+        rsg::MapPtr scenario;
+        QString error;
+        std::time_t seed{};
+        int percent{};
+        bool finished{};
+    };
+
+    // Candidates of the latest generation, generated concurrently
+    std::vector<Candidate> candidates;
+    Candidate* selectedCandidate{};
+    std::time_t requestedSeed{};
+    QString generateButtonText;
 
     using GameInfoPtr = std::unique_ptr<rsg::StandaloneGameInfo>;
     GameInfoPtr gameInfo;
 
-    rsg::MapPtr scenario;
+    // Refers to game info above, recreated each time game info is read
+    using GenerationContextPtr = std::unique_ptr<rsg::GenerationContext>;
+    GenerationContextPtr context;
+
+    // One pixel per tile, scaled into pixmaps shown in ui
+    rsg::PreviewRasterizer previewRasterizer;
+    QImage zonesPreview;
+    QImage contentsPreview;
+    QPixmap zonesPixmap;
+    QPixmap contentsPixmap;
+
     std::filesystem::path templateFilePath;
     bool radioButtons[5];
 };
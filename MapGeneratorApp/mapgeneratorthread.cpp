@@ -6,16 +6,98 @@
 void MapGeneratorThread::run()
 {
     try {
-        auto scenarioMap = generator->generate();
-        emit mapGenerated(scenarioMap.release(), "");
+        auto result = rsg::generateWithRetries(createAttempt, seed, options);
+        attempt = std::move(result.attempt);
+        seed = result.seed;
+        emit mapGenerated(result.map.release(), "");
     } catch (const std::exception& e) {
         auto error = QString{"Exception during map generation: "} + e.what();
         emit mapGenerated(nullptr, error);
     }
 }
 
-MapGeneratorThread::MapGeneratorThread(rsg::MapGenerator *generator, QObject *parent)
+MapGeneratorThread::MapGeneratorThread(rsg::GenerationAttemptFactory createAttempt,
+                                       std::time_t seed,
+                                       const rsg::GenerationAttemptOptions& options,
+                                       QObject *parent)
     : QThread(parent)
-    , generator{generator}
+    , createAttempt{std::move(createAttempt)}
+    , options{options}
+    , seed{seed}
 {
+    this->options.cancellation = &cancellation;
+    this->options.progress = [this](std::size_t,
+                                    const rsg::MapGenerator& generator,
+                                    const rsg::GenerationProgress& progress) {
+        onAttemptProgress(generator, progress);
+    };
+}
+
+rsg::GenerationAttemptPtr MapGeneratorThread::takeAttempt()
+{
+    return std::move(attempt);
+}
+
+std::time_t MapGeneratorThread::getScenarioSeed() const
+{
+    return seed;
+}
+
+void MapGeneratorThread::cancel()
+{
+    cancellation.cancel();
+}
+
+QRect MapGeneratorThread::takePreview(QImage& zones, QImage& tiles)
+{
+    std::lock_guard<std::mutex> lock(previewMutex);
+
+    // Images are shared until the next update changes them
+    zones = zonesPreview;
+    tiles = tilesPreview;
+
+    const QRect changed = previewChangedTiles;
+    previewChangedTiles = QRect();
+    return changed;
+}
+
+void MapGeneratorThread::onAttemptProgress(const rsg::MapGenerator& generator,
+                                           const rsg::GenerationProgress& progress)
+{
+    const int percent = static_cast<int>(progress.fraction * 100);
+
+    // Attempts run in parallel, report only when the most advanced one moves forward
+    int reported = percentReported.load();
+    while (percent > reported) {
+        if (percentReported.compare_exchange_weak(reported, percent)) {
+            emit progressChanged(percent);
+            updatePreview(generator);
+            break;
+        }
+    }
+}
+
+void MapGeneratorThread::updatePreview(const rsg::MapGenerator& generator)
+{
+    std::lock_guard<std::mutex> lock(previewMutex);
+
+    const int size = generator.mapGenOptions.size;
+    if (zonesPreview.width() != size) {
+        zonesPreview = QImage(size, size, QImage::Format_RGB888);
+        tilesPreview = QImage(size, size, QImage::Format_RGB888);
+        previewRasterizer.reset();
+    }
+
+    // Only tiles changed since the previous frame are drawn
+    const auto changed = previewRasterizer.update(
+        generator,
+        rsg::PreviewImage{zonesPreview.bits(), static_cast<std::size_t>(zonesPreview.bytesPerLine())},
+        rsg::PreviewImage{tilesPreview.bits(), static_cast<std::size_t>(tilesPreview.bytesPerLine())});
+
+    if (changed.isEmpty()) {
+        return;
+    }
+
+    previewChangedTiles |= QRect(changed.x, changed.y, changed.width, changed.height);
+    emit previewChanged();
 }
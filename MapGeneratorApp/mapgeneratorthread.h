@@ -1,14 +1,16 @@
 #ifndef MAPGENERATORWORKER_H
 #define MAPGENERATORWORKER_H
 
+#include "cancellationtoken.h"
+#include "generationattempts.h"
+#include "previewrasterizer.h"
+#include <QImage>
+#include <QRect>
 #include <QThread>
+#include <atomic>
+#include <mutex>
 #include <string>
 
-namespace rsg {
-class MapGenerator;
-class Map;
-}
-
 class MapGeneratorThread : public QThread
 {
     Q_OBJECT
@@ -16,13 +18,45 @@ class MapGeneratorThread : public QThread
     void run() override;
 
 public:
-    explicit MapGeneratorThread(rsg::MapGenerator* generator, QObject *parent = nullptr);
+    MapGeneratorThread(rsg::GenerationAttemptFactory createAttempt,
+                       std::time_t seed,
+                       const rsg::GenerationAttemptOptions& options,
+                       QObject *parent = nullptr);
+
+    // Returns successful attempt once mapGenerated is emitted
+    rsg::GenerationAttemptPtr takeAttempt();
+    // Returns seed of generated scenario, differs from requested one after retries
+    std::time_t getScenarioSeed() const;
+    // Asks generation to stop, mapGenerated is emitted with error once it stops
+    void cancel();
+    // Copies zones and tiles preview of the most advanced attempt.
+    // Returns tiles changed since previous call
+    QRect takePreview(QImage& zones, QImage& tiles);
 
 signals:
     void mapGenerated(rsg::Map* scenarioMap, const QString& error);
+    // Percent of the most advanced attempt
+    void progressChanged(int percent);
+    // Preview of the most advanced attempt changed
+    void previewChanged();
 
 private:
-    rsg::MapGenerator* generator;
+    void onAttemptProgress(const rsg::MapGenerator& generator,
+                           const rsg::GenerationProgress& progress);
+    void updatePreview(const rsg::MapGenerator& generator);
+
+    rsg::CancellationToken cancellation;
+    std::atomic<int> percentReported{-1};
+    // Attempts update preview from their own threads
+    std::mutex previewMutex;
+    rsg::PreviewRasterizer previewRasterizer;
+    QImage zonesPreview;
+    QImage tilesPreview;
+    QRect previewChangedTiles;
+    rsg::GenerationAttemptFactory createAttempt;
+    rsg::GenerationAttemptOptions options;
+    rsg::GenerationAttemptPtr attempt;
+    std::time_t seed;
 };
 
 #endif // MAPGENERATORWORKER_H
@@ -0,0 +1,75 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace rsg {
+
+// Stop request shared between generator and its owner.
+// Generator checks token between phases, zones and inside long loops
+// and stops with GenerationCancelledException once cancelled.
+// Token is also cancelled when its parent is cancelled or its deadline has passed
+class CancellationToken
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit CancellationToken(const CancellationToken* parent = nullptr)
+        : parent{parent}
+    { }
+
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    void cancel()
+    {
+        cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    // Deadline should be set before token is shared with generator
+    void setDeadline(Clock::time_point time)
+    {
+        deadline = time;
+        hasDeadline = true;
+    }
+
+    bool isCancelled() const
+    {
+        if (cancelled.load(std::memory_order_relaxed)) {
+            return true;
+        }
+
+        if (hasDeadline && Clock::now() >= deadline) {
+            return true;
+        }
+
+        return parent && parent->isCancelled();
+    }
+
+private:
+    const CancellationToken* parent;
+    Clock::time_point deadline;
+    std::atomic<bool> cancelled{};
+    bool hasDeadline{};
+};
+
+} // namespace rsg
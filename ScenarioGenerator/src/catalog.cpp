@@ -0,0 +1,93 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "catalog.h"
+
+namespace rsg {
+
+template <typename T>
+static void sortByValue(std::vector<T*>& pool)
+{
+    std::stable_sort(pool.begin(), pool.end(), [](const T* a, const T* b) {
+        return a->getValue() < b->getValue();
+    });
+}
+
+template <typename Key, typename T>
+static const std::vector<T*>& getBucket(const std::map<Key, std::vector<T*>>& buckets, Key key)
+{
+    static const std::vector<T*> empty;
+
+    const auto it{buckets.find(key)};
+    return it != buckets.end() ? it->second : empty;
+}
+
+Catalog::Catalog(const GameInfo& gameInfo)
+    : unitsTotal{gameInfo.getUnits().size()}
+    , itemsTotal{gameInfo.getItemsInfo().size()}
+    , spellsTotal{gameInfo.getSpellsInfo().size()}
+    , leaders{gameInfo.getLeaders()}
+    , soldiers{gameInfo.getSoldiers()}
+    , items{gameInfo.getItems()}
+    , spells{gameInfo.getSpells()}
+{
+    sortByValue(leaders);
+    sortByValue(soldiers);
+    sortByValue(items);
+    sortByValue(spells);
+
+    // Buckets are filled from sorted pools and stay sorted
+    for (auto leader : leaders) {
+        leadersBySubrace[leader->getSubrace()].push_back(leader);
+    }
+
+    for (auto soldier : soldiers) {
+        soldiersBySubrace[soldier->getSubrace()].push_back(soldier);
+    }
+
+    for (auto item : items) {
+        itemsByType[item->getItemType()].push_back(item);
+    }
+
+    for (auto spell : spells) {
+        spellsByType[spell->getSpellType()].push_back(spell);
+    }
+}
+
+const UnitInfoArray& Catalog::getLeaders(SubRaceType subrace) const
+{
+    return getBucket(leadersBySubrace, subrace);
+}
+
+const UnitInfoArray& Catalog::getSoldiers(SubRaceType subrace) const
+{
+    return getBucket(soldiersBySubrace, subrace);
+}
+
+const ItemInfoArray& Catalog::getItems(ItemType itemType) const
+{
+    return getBucket(itemsByType, itemType);
+}
+
+const SpellInfoArray& Catalog::getSpells(SpellType spellType) const
+{
+    return getBucket(spellsByType, spellType);
+}
+
+} // namespace rsg
@@ -0,0 +1,118 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gameinfo.h"
+#include <algorithm>
+#include <map>
+#include <utility>
+
+namespace rsg {
+
+// Game catalogs indexed for picking.
+// Built once per generation context, pools are sorted by value in ascending order.
+// Elements with equal values keep their game data order.
+// Catalog indices of units, items and spells are in [0 : total) range,
+// they are assigned once when game data is loaded
+class Catalog
+{
+public:
+    Catalog(const GameInfo& gameInfo);
+
+    std::size_t getUnitsTotal() const
+    {
+        return unitsTotal;
+    }
+
+    std::size_t getItemsTotal() const
+    {
+        return itemsTotal;
+    }
+
+    std::size_t getSpellsTotal() const
+    {
+        return spellsTotal;
+    }
+
+    const UnitInfoArray& getLeaders() const
+    {
+        return leaders;
+    }
+
+    // Returns leaders of specified subrace
+    const UnitInfoArray& getLeaders(SubRaceType subrace) const;
+
+    const UnitInfoArray& getSoldiers() const
+    {
+        return soldiers;
+    }
+
+    // Returns soldiers of specified subrace
+    const UnitInfoArray& getSoldiers(SubRaceType subrace) const;
+
+    const ItemInfoArray& getItems() const
+    {
+        return items;
+    }
+
+    // Returns items of specified type
+    const ItemInfoArray& getItems(ItemType itemType) const;
+
+    const SpellInfoArray& getSpells() const
+    {
+        return spells;
+    }
+
+    // Returns spells of specified type
+    const SpellInfoArray& getSpells(SpellType spellType) const;
+
+private:
+    std::size_t unitsTotal{};
+    std::size_t itemsTotal{};
+    std::size_t spellsTotal{};
+
+    UnitInfoArray leaders;
+    UnitInfoArray soldiers;
+    std::map<SubRaceType, UnitInfoArray> leadersBySubrace;
+    std::map<SubRaceType, UnitInfoArray> soldiersBySubrace;
+
+    ItemInfoArray items;
+    std::map<ItemType, ItemInfoArray> itemsByType;
+
+    SpellInfoArray spells;
+    std::map<SpellType, SpellInfoArray> spellsByType;
+};
+
+template <typename T>
+using PoolRange = std::pair<typename std::vector<T*>::const_iterator,
+                            typename std::vector<T*>::const_iterator>;
+
+// Returns part of value-sorted pool with element values in [minValue : maxValue] range
+template <typename T>
+PoolRange<T> getValueRange(const std::vector<T*>& pool, int minValue, int maxValue)
+{
+    auto lessValue = [](const T* info, int value) { return info->getValue() < value; };
+    auto greaterValue = [](int value, const T* info) { return value < info->getValue(); };
+
+    const auto begin{std::lower_bound(pool.cbegin(), pool.cend(), minValue, lessValue)};
+    return {begin, std::upper_bound(begin, pool.cend(), maxValue, greaterValue)};
+}
+
+} // namespace rsg
@@ -142,7 +142,7 @@ bool Decoration::placeLandmarks(std::set<Position>& area,
     for (std::size_t i = 0; i < landmarksTotal; ++i) {
         const auto landmarkRace{getLandmarksRace(zone, mapGenerator, map, rand)};
 
-        const auto* info{pickLandmark(landmarkRace, rand, landmarkFilters)};
+        const auto* info{pickLandmark(mapGenerator.getContext(), landmarkRace, rand, landmarkFilters)};
         if (!info) {
             break;
         }
@@ -170,7 +170,7 @@ bool Decoration::placeLandmarks(std::set<Position>& area,
         // Change tiles to specified terrain for better visuals
         const auto landmarkTerrain{getLandmarksTerrain(zone, mapGenerator, map, rand)};
         for (const auto& tile : landmarkTiles) {
-            map.getTile(tile).setTerrainGround(landmarkTerrain, GroundType::Plain);
+            mapGenerator.paintTerrain(tile, landmarkTerrain, GroundType::Plain);
             area.erase(tile);
         }
     }
@@ -191,13 +191,16 @@ bool Decoration::placeForests(std::set<Position>& area,
     randomShuffle(forestTiles, rand);
 
     const auto forestTerrain{getForestsTerrain(zone, mapGenerator, map, rand)};
+    const auto& settings{mapGenerator.getContext().getGeneratorSettings()};
 
     for (std::size_t i = 0; i < forestsTotal && i < forestTiles.size(); ++i) {
         const auto& forestTile{forestTiles[i]};
 
-        auto& tile{map.getTile(forestTile)};
-        tile.setTerrainGround(forestTerrain, GroundType::Forest);
-        tile.treeImage = getRandomTreeImageIndex(rand);
+        const auto treeImage{getRandomTreeImageIndex(settings, rand)};
+        mapGenerator.changeMapTile(forestTile, [forestTerrain, treeImage](Tile& tile) {
+            tile.setTerrainGround(forestTerrain, GroundType::Forest);
+            tile.treeImage = treeImage;
+        });
 
         mapGenerator.setOccupied(forestTile, TileType::Used);
     }
@@ -426,13 +429,16 @@ bool CrystalDecoration::placeForests(std::set<Position>& area,
     randomShuffle(forestTiles, rand);
 
     const auto forestTerrain{getForestsTerrain(zone, mapGenerator, map, rand)};
+    const auto& settings{mapGenerator.getContext().getGeneratorSettings()};
 
     for (std::size_t i = 0; i < forestsTotal && i < forestTiles.size(); ++i) {
         const auto& forestTile{forestTiles[i]};
 
-        auto& tile{map.getTile(forestTile)};
-        tile.setTerrainGround(forestTerrain, GroundType::Forest);
-        tile.treeImage = getRandomTreeImageIndex(rand);
+        const auto treeImage{getRandomTreeImageIndex(settings, rand)};
+        mapGenerator.changeMapTile(forestTile, [forestTerrain, treeImage](Tile& tile) {
+            tile.setTerrainGround(forestTerrain, GroundType::Forest);
+            tile.treeImage = treeImage;
+        });
 
         mapGenerator.setOccupied(forestTile, TileType::Used);
 
@@ -451,15 +457,18 @@ bool CapturedCrystalDecoration::decorate(TemplateZone& zone,
         return false;
     }
 
-    // Change terrain under and around crystal to specified
-    auto& tile{map.getTile(crystal->getPosition())};
-    tile.setTerrainGround(terrain, tile.ground);
+    // Change terrain under and around crystal to specified.
+    // Neighbor tiles could belong to other zones, change them through generator
+    auto changeTerrain = [terrain = terrain](Tile& tile) {
+        tile.setTerrainGround(terrain, tile.ground);
+    };
+
+    mapGenerator.changeMapTile(crystal->getPosition(), changeTerrain);
 
     mapGenerator.foreachNeighbor(crystal->getPosition(),
-                                 [this, &mapGenerator, &map](Position& pos) {
+                                 [&mapGenerator, &changeTerrain](Position& pos) {
                                      if (mapGenerator.isFree(pos) || mapGenerator.isUsed(pos)) {
-                                         auto& tile{map.getTile(pos)};
-                                         tile.setTerrainGround(terrain, tile.ground);
+                                         mapGenerator.changeMapTile(pos, changeTerrain);
                                      }
                                  });
     return true;
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <stdexcept>
+#include <string>
 
 namespace rsg {
 
@@ -36,6 +37,25 @@ public:
 // accroding to template contents. Better to abort generation and inform user.
 class LackOfSpaceException : public std::runtime_error
 {
+public:
+    LackOfSpaceException(const std::string& message, int zoneId = -1)
+        : std::runtime_error{message}
+        , zoneId{zoneId}
+    { }
+
+    // Zone that lacked space, -1 if not known
+    int getZoneId() const noexcept
+    {
+        return zoneId;
+    }
+
+private:
+    int zoneId;
+};
+
+// Generation was stopped by cancellation token before scenario was created
+class GenerationCancelledException : public std::runtime_error
+{
 public:
     using std::runtime_error::runtime_error;
 };
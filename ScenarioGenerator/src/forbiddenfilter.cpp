@@ -0,0 +1,58 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "forbiddenfilter.h"
+#include "generatorsettings.h"
+#include "maptemplate.h"
+
+namespace rsg {
+
+// Marks objects with specified ids, ids missing in game data are ignored
+template <typename T>
+static void markForbidden(std::vector<bool>& bits,
+                          const std::map<CMidgardID, std::unique_ptr<T>>& infos,
+                          const std::set<CMidgardID>& forbiddenIds)
+{
+    for (const auto& id : forbiddenIds) {
+        const auto it{infos.find(id)};
+        if (it != infos.end()) {
+            bits[it->second->getCatalogIndex()] = true;
+        }
+    }
+}
+
+ForbiddenFilter::ForbiddenFilter(const GameInfo& gameInfo,
+                                 const Catalog& catalog,
+                                 const GeneratorSettings& generatorSettings,
+                                 const MapTemplateSettings& templateSettings)
+    : units(catalog.getUnitsTotal())
+    , items(catalog.getItemsTotal())
+    , spells(catalog.getSpellsTotal())
+{
+    markForbidden(units, gameInfo.getUnits(), generatorSettings.forbiddenUnits);
+    markForbidden(units, gameInfo.getUnits(), templateSettings.forbiddenUnits);
+
+    markForbidden(items, gameInfo.getItemsInfo(), generatorSettings.forbiddenItems);
+    markForbidden(items, gameInfo.getItemsInfo(), templateSettings.forbiddenItems);
+
+    markForbidden(spells, gameInfo.getSpellsInfo(), generatorSettings.forbiddenSpells);
+    markForbidden(spells, gameInfo.getSpellsInfo(), templateSettings.forbiddenSpells);
+}
+
+} // namespace rsg
@@ -0,0 +1,62 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "catalog.h"
+#include <set>
+#include <vector>
+
+namespace rsg {
+
+struct GeneratorSettings;
+struct MapTemplateSettings;
+
+// Units, items and spells that must not be used in generation.
+// Global and template forbidden sets are compiled into dense bitsets over catalog indices
+class ForbiddenFilter
+{
+public:
+    ForbiddenFilter(const GameInfo& gameInfo,
+                    const Catalog& catalog,
+                    const GeneratorSettings& generatorSettings,
+                    const MapTemplateSettings& templateSettings);
+
+    bool isForbidden(const UnitInfo* info) const
+    {
+        return units[info->getCatalogIndex()];
+    }
+
+    bool isForbidden(const ItemInfo* info) const
+    {
+        return items[info->getCatalogIndex()];
+    }
+
+    bool isForbidden(const SpellInfo* info) const
+    {
+        return spells[info->getCatalogIndex()];
+    }
+
+private:
+    std::vector<bool> units;
+    std::vector<bool> items;
+    std::vector<bool> spells;
+};
+
+} // namespace rsg
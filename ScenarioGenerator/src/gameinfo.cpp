@@ -19,21 +19,27 @@
 
 #include "gameinfo.h"
 #include "containers.h"
-#include "generatorsettings.h"
 #include <cassert>
 
 namespace rsg {
 
-static const GameInfo* gameInfo{nullptr};
-
-void setGameInfo(const GameInfo* info)
+void assignCatalogIndices(GameInfo& gameInfo)
 {
-    gameInfo = info;
-}
+    // Indices are assigned in id order, they stay the same for the same game data
+    std::size_t unitIndex{};
+    for (const auto& [id, unit] : gameInfo.getUnits()) {
+        unit->catalogIndex = unitIndex++;
+    }
 
-const GameInfo* getGameInfo()
-{
-    return gameInfo;
+    std::size_t itemIndex{};
+    for (const auto& [id, item] : gameInfo.getItemsInfo()) {
+        item->catalogIndex = itemIndex++;
+    }
+
+    std::size_t spellIndex{};
+    for (const auto& [id, spell] : gameInfo.getSpellsInfo()) {
+        spell->catalogIndex = spellIndex++;
+    }
 }
 
 bool isLeader(const UnitInfo& info)
@@ -63,9 +69,9 @@ bool isSupport(const UnitInfo& info)
     return false;
 }
 
-bool isTalisman(const CMidgardID& itemId)
+bool isTalisman(const GameInfo& gameInfo, const CMidgardID& itemId)
 {
-    const ItemsInfo& items{getGameInfo()->getItemsInfo()};
+    const ItemsInfo& items{gameInfo.getItemsInfo()};
 
     const auto it{items.find(itemId)};
     if (it == items.end()) {
@@ -75,9 +81,9 @@ bool isTalisman(const CMidgardID& itemId)
     return it->second->getItemType() == ItemType::Talisman;
 }
 
-bool isRaceUnplayable(const CMidgardID& raceId)
+bool isRaceUnplayable(const GameInfo& gameInfo, const CMidgardID& raceId)
 {
-    const RacesInfo& races = getGameInfo()->getRacesInfo();
+    const RacesInfo& races = gameInfo.getRacesInfo();
 
     const auto it{races.find(raceId)};
     if (it == races.end()) {
@@ -145,13 +145,9 @@ protected:
     GameInfo() = default;
 };
 
-// Sets up GameInfo interface for scenario generator to use.
-// It is a user responsibility to manage GameInfo object lifetime.
-// Passed GameInfo object should stay valid until scenario generator is running
-void setGameInfo(const GameInfo* gameInfo);
-
-// Returns currently set game info interface
-const GameInfo* getGameInfo();
+// Assigns catalog indices of units, items and spells.
+// Called once by game info implementations after game data is loaded
+void assignCatalogIndices(GameInfo& gameInfo);
 
 // Returns true if unit info describes leader unit
 bool isLeader(const UnitInfo& info);
@@ -160,10 +156,10 @@ bool isLeader(const UnitInfo& info);
 bool isSupport(const UnitInfo& info);
 
 // Returns true if item with specified global id is a talisman
-bool isTalisman(const CMidgardID& itemId);
+bool isTalisman(const GameInfo& gameInfo, const CMidgardID& itemId);
 
 // Returns true if race with specified id can not be played by human player
-bool isRaceUnplayable(const CMidgardID& raceId);
+bool isRaceUnplayable(const GameInfo& gameInfo, const CMidgardID& raceId);
 // Returns true if race with specified type can not be played by human player
 bool isRaceUnplayable(RaceType raceType);
 
@@ -0,0 +1,223 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "generationattempts.h"
+#include "cancellationtoken.h"
+#include "exceptions.h"
+#include "randomgenerator.h"
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rsg {
+
+struct GenerationAttemptState
+{
+    explicit GenerationAttemptState(const CancellationToken* parent)
+        : cancellation{parent}
+    { }
+
+    CancellationToken cancellation;
+    GenerationAttemptPtr attempt;
+    MapPtr map;
+    std::exception_ptr error;
+};
+
+std::time_t getAttemptSeed(std::time_t seed, std::size_t attemptIndex)
+{
+    if (!attemptIndex) {
+        return seed;
+    }
+
+    const auto mixed{SplitMix64::mix(static_cast<std::uint64_t>(seed)
+                                     + attemptIndex * SplitMix64::gamma)};
+    // Scenario info stores 32 bit seed, keep derived seeds reproducible from it
+    return static_cast<std::time_t>(mixed & 0xffffffffull);
+}
+
+static void setupGenerator(MapGenerator& generator,
+                           const CancellationToken& cancellation,
+                           std::size_t attemptIndex,
+                           const GenerationAttemptOptions& options)
+{
+    generator.setCancellationToken(&cancellation);
+
+    if (options.progress) {
+        const auto& progress{options.progress};
+        generator.setProgressCallback(
+            [&progress, &generator, attemptIndex](const GenerationProgress& attemptProgress) {
+                progress(attemptIndex, generator, attemptProgress);
+            });
+    }
+}
+
+// Generates scenario of a single attempt.
+// While zones lack space fills them again with other fill seeds, reusing zone placement
+static MapPtr generateAttempt(GenerationAttempt& attempt,
+                              const CancellationToken& cancellation,
+                              std::size_t attemptIndex,
+                              const GenerationAttemptOptions& options)
+{
+    setupGenerator(*attempt.generator, cancellation, attemptIndex, options);
+
+    try {
+        return attempt.generator->generate();
+    } catch (const LackOfSpaceException&) {
+        if (options.fillAttempts < 2 || !attempt.generator->getCheckpoint()) {
+            throw;
+        }
+    }
+
+    const auto placement{attempt.generator->getCheckpoint()};
+
+    for (std::size_t fill = 1;; ++fill) {
+        const MapGenerator& previous{*attempt.generator};
+
+        MapGenOptions fillOptions{previous.mapGenOptions};
+        fillOptions.fillSeed = fill;
+
+        // Each generator generates a single scenario
+        attempt.generator = std::make_unique<MapGenerator>(previous.getContext(), fillOptions,
+                                                           previous.randomSeed,
+                                                           previous.isDebugMode());
+        setupGenerator(*attempt.generator, cancellation, attemptIndex, options);
+
+        try {
+            return attempt.generator->generate(placement);
+        } catch (const LackOfSpaceException&) {
+            if (fill + 1 >= options.fillAttempts) {
+                throw;
+            }
+        }
+    }
+}
+
+GenerationAttemptResult generateWithRetries(const GenerationAttemptFactory& createAttempt,
+                                            std::time_t seed,
+                                            const GenerationAttemptOptions& options)
+{
+    const auto maxAttempts{std::max<std::size_t>(options.maxAttempts, 1)};
+    // States are not movable, deque keeps them in place
+    std::deque<GenerationAttemptState> attempts;
+    for (std::size_t i = 0; i < maxAttempts; ++i) {
+        attempts.emplace_back(options.cancellation);
+    }
+
+    std::mutex mutex;
+    std::size_t nextAttempt{};
+    // The first attempt that finished without lack of space, attempts after it are not needed
+    std::size_t winner{maxAttempts};
+
+    auto runAttempt = [&](std::size_t index) {
+        GenerationAttemptState& state{attempts[index]};
+        bool lackOfSpace{};
+
+        try {
+            state.attempt = createAttempt(getAttemptSeed(seed, index));
+            state.map = generateAttempt(*state.attempt, state.cancellation, index, options);
+        } catch (const LackOfSpaceException&) {
+            state.error = std::current_exception();
+            lackOfSpace = true;
+        } catch (...) {
+            state.error = std::current_exception();
+        }
+
+        if (state.error) {
+            // Failed attempts are not needed anymore, free their memory right away
+            state.attempt.reset();
+        }
+
+        if (lackOfSpace) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock{mutex};
+        // Attempts after the winner are cancelled and their results are ignored
+        if (index < winner) {
+            winner = index;
+
+            for (std::size_t i = index + 1; i < nextAttempt; ++i) {
+                attempts[i].cancellation.cancel();
+            }
+        }
+    };
+
+    auto runAttempts = [&]() {
+        for (;;) {
+            std::size_t index{};
+
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                if (nextAttempt >= winner) {
+                    return;
+                }
+
+                index = nextAttempt++;
+            }
+
+            runAttempt(index);
+        }
+    };
+
+    if (!options.speculative) {
+        // Retry in parallel only if the first attempt failed
+        nextAttempt = 1;
+        runAttempt(0);
+    }
+
+    const auto threadsTotal{std::min(std::max<std::size_t>(options.parallelAttempts, 1),
+                                     maxAttempts)};
+
+    std::vector<std::thread> threads;
+    if (winner != 0) {
+        for (std::size_t i = 1; i < threadsTotal; ++i) {
+            threads.emplace_back(runAttempts);
+        }
+    }
+
+    runAttempts();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (winner == maxAttempts) {
+        // All attempts lack space, report why the first one failed
+        std::rethrow_exception(attempts.front().error);
+    }
+
+    GenerationAttemptState& state{attempts[winner]};
+    if (state.error) {
+        std::rethrow_exception(state.error);
+    }
+
+    GenerationAttemptResult result;
+    result.attempt = std::move(state.attempt);
+    result.map = std::move(state.map);
+    result.seed = getAttemptSeed(seed, winner);
+    result.fillSeed = result.attempt->generator->mapGenOptions.fillSeed;
+    result.attemptsStarted = nextAttempt;
+
+    return result;
+}
+
+} // namespace rsg
@@ -0,0 +1,96 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "generationprogress.h"
+#include "mapgenerator.h"
+#include "maptemplate.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+
+namespace rsg {
+
+class CancellationToken;
+
+// Scenario generation for a single seed.
+// Owns template with contents evaluated for this seed and generator that uses it
+struct GenerationAttempt
+{
+    std::unique_ptr<MapTemplate> mapTemplate;
+    std::unique_ptr<MapGenerator> generator;
+};
+
+using GenerationAttemptPtr = std::unique_ptr<GenerationAttempt>;
+
+// Prepares attempt for specified seed: chooses races and evaluates template contents.
+// Called from several threads at once
+using GenerationAttemptFactory = std::function<GenerationAttemptPtr(std::time_t seed)>;
+
+struct GenerationAttemptOptions
+{
+    // Attempts made before giving up, including the first one
+    std::size_t maxAttempts{1};
+    // Attempts running at the same time
+    std::size_t parallelAttempts{1};
+    // Fills made by each attempt while zones lack space.
+    // The first fill places zones, the rest reuse that placement with other fill seeds
+    std::size_t fillAttempts{1};
+    // Start parallel attempts right away instead of waiting for the first one to fail
+    bool speculative{};
+    // Stops all attempts when cancelled, must outlive generation
+    const CancellationToken* cancellation{};
+    // Progress of each attempt, attempts running in parallel report from their own threads.
+    // Tiles of attempt generator can be read from the callback if zones are filled one by one
+    std::function<void(std::size_t attemptIndex,
+                       const MapGenerator& generator,
+                       const GenerationProgress&)>
+        progress;
+};
+
+struct GenerationAttemptResult
+{
+    // Successful attempt, its generator can be used to inspect tiles and zones
+    GenerationAttemptPtr attempt;
+    MapPtr map;
+    // Seed of successful attempt
+    std::time_t seed{};
+    // Fill seed of successful attempt, see MapGenOptions::fillSeed
+    std::uint64_t fillSeed{};
+    // Attempts started, including cancelled ones
+    std::size_t attemptsStarted{};
+};
+
+// Returns seed of attempt with specified index, the first attempt uses seed as is
+std::time_t getAttemptSeed(std::time_t seed, std::size_t attemptIndex);
+
+// Generates scenario retrying while zones lack space,
+// first with other fill seeds for the same zone placement, then with derived seeds.
+// Result is the same as of sequential retries regardless of parallel attempts:
+// the first attempt in seed order that did not fail with LackOfSpaceException wins,
+// attempts after it are cancelled as soon as it succeeds.
+// Rethrows exception of the winning attempt or the first LackOfSpaceException if all failed
+GenerationAttemptResult generateWithRetries(const GenerationAttemptFactory& createAttempt,
+                                            std::time_t seed,
+                                            const GenerationAttemptOptions& options);
+
+} // namespace rsg
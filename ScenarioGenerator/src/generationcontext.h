@@ -0,0 +1,65 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "catalog.h"
+#include "gameinfo.h"
+#include "generatorsettings.h"
+
+namespace rsg {
+
+// Game data and generator settings used during generation.
+// Context is immutable once created and can be shared by several generators,
+// game info and settings must outlive it
+class GenerationContext
+{
+public:
+    GenerationContext(const GameInfo& gameInfo, const GeneratorSettings& generatorSettings)
+        : gameInfo{gameInfo}
+        , generatorSettings{generatorSettings}
+        , catalog{gameInfo}
+    { }
+
+    GenerationContext(const GenerationContext&) = delete;
+    GenerationContext& operator=(const GenerationContext&) = delete;
+
+    const GameInfo& getGameInfo() const
+    {
+        return gameInfo;
+    }
+
+    const GeneratorSettings& getGeneratorSettings() const
+    {
+        return generatorSettings;
+    }
+
+    // Returns game data indexed for picking
+    const Catalog& getCatalog() const
+    {
+        return catalog;
+    }
+
+private:
+    const GameInfo& gameInfo;
+    const GeneratorSettings& generatorSettings;
+    const Catalog catalog;
+};
+
+} // namespace rsg
@@ -0,0 +1,54 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace rsg {
+
+// Generation phases in order they run
+enum class GenerationPhase
+{
+    PlaceZones,
+    CreateBorders,
+    FillZones,
+    CreateObstacles,
+    ConnectRoads,
+    CreateRoads,
+    SetupDiplomacy,
+    Finished,
+};
+
+struct GenerationProgress
+{
+    GenerationPhase phase{};
+    // Zones of current phase processed so far, 0 for phases not done zone by zone
+    std::size_t zone{};
+    std::size_t zonesTotal{};
+    // Part of whole generation completed, from 0 to 1
+    double fraction{};
+};
+
+// Called from generation thread at phase boundaries and after each zone is processed.
+// Zones filled in parallel report progress from several threads, one at a time
+using GenerationProgressCallback = std::function<void(const GenerationProgress&)>;
+
+} // namespace rsg
@@ -28,6 +28,7 @@
 #include <lua.hpp>
 #include <sol/sol.hpp>
 #include <string>
+#include <string_view>
 
 namespace rsg {
 
@@ -38,8 +39,6 @@ static const char* treePrefixes[6] = {"HUF", "UNF", "HEF", "DWF", "NEF", "ELF"};
 using OptionalTable = sol::optional<sol::table>;
 using StringSet = std::set<std::string>;
 
-static GeneratorSettings generatorSettings;
-
 static std::string readFile(const std::filesystem::path& file)
 {
     std::ifstream stream(file);
@@ -64,27 +63,27 @@ static void readStringSet(std::set<CMidgardID>& ids, const StringSet& stringSet)
     }
 }
 
-static void readForbiddenUnits(const sol::table& table)
+static void readForbiddenUnits(GeneratorSettings& settings, const sol::table& table)
 {
     auto units = table.get<sol::optional<StringSet>>("forbiddenUnits");
     if (units.has_value()) {
-        readStringSet(generatorSettings.forbiddenUnits, units.value());
+        readStringSet(settings.forbiddenUnits, units.value());
     }
 }
 
-static void readForbiddenItems(const sol::table& table)
+static void readForbiddenItems(GeneratorSettings& settings, const sol::table& table)
 {
     auto items = table.get<sol::optional<StringSet>>("forbiddenItems");
     if (items.has_value()) {
-        readStringSet(generatorSettings.forbiddenItems, items.value());
+        readStringSet(settings.forbiddenItems, items.value());
     }
 }
 
-static void readForbiddenSpells(const sol::table& table)
+static void readForbiddenSpells(GeneratorSettings& settings, const sol::table& table)
 {
     auto spells = table.get<sol::optional<StringSet>>("forbiddenSpells");
     if (spells.has_value()) {
-        readStringSet(generatorSettings.forbiddenSpells, spells.value());
+        readStringSet(settings.forbiddenSpells, spells.value());
     }
 }
 
@@ -98,7 +97,7 @@ static void readRaceLandmarks(std::set<CMidgardID>& ids,
     }
 }
 
-static void readLandmarks(const sol::table& table)
+static void readLandmarks(GeneratorSettings& settings, const sol::table& table)
 {
     auto landmarks = table.get<OptionalTable>("landmarks");
     if (!landmarks.has_value()) {
@@ -106,13 +105,13 @@ static void readLandmarks(const sol::table& table)
     }
 
     const sol::table& landmarksTable = landmarks.value();
-    readRaceLandmarks(generatorSettings.landmarks.empire, landmarksTable, "human");
-    readRaceLandmarks(generatorSettings.landmarks.clans, landmarksTable, "dwarf");
-    readRaceLandmarks(generatorSettings.landmarks.undead, landmarksTable, "undead");
-    readRaceLandmarks(generatorSettings.landmarks.legions, landmarksTable, "heretic");
-    readRaceLandmarks(generatorSettings.landmarks.elves, landmarksTable, "elf");
-    readRaceLandmarks(generatorSettings.landmarks.neutral, landmarksTable, "neutral");
-    readRaceLandmarks(generatorSettings.landmarks.mountains, landmarksTable, "mountain");
+    readRaceLandmarks(settings.landmarks.empire, landmarksTable, "human");
+    readRaceLandmarks(settings.landmarks.clans, landmarksTable, "dwarf");
+    readRaceLandmarks(settings.landmarks.undead, landmarksTable, "undead");
+    readRaceLandmarks(settings.landmarks.legions, landmarksTable, "heretic");
+    readRaceLandmarks(settings.landmarks.elves, landmarksTable, "elf");
+    readRaceLandmarks(settings.landmarks.neutral, landmarksTable, "neutral");
+    readRaceLandmarks(settings.landmarks.mountains, landmarksTable, "mountain");
 }
 
 // Same as std::string::find, but case insensitive.
@@ -180,36 +179,39 @@ static void readObjectImages(GeneratorSettings::ObjectImages& images,
     readObjectImages(images.waterImages, water.value(), namePrefix);
 }
 
-static void readScriptSettings(sol::state& lua)
+static void readScriptSettings(GeneratorSettings& settings, sol::state& lua)
 {
-    const sol::table& settings = lua["settings"];
-
-    readForbiddenUnits(settings);
-    readForbiddenItems(settings);
-    readForbiddenSpells(settings);
-    readLandmarks(settings);
-    readObjectImages(generatorSettings.ruins, settings, "ruins", "g000ru00000");
-    readObjectImages(generatorSettings.merchants, settings, "merchants", "g000si0000merh");
-    readObjectImages(generatorSettings.mages, settings, "mages", "g000si0000mage");
-    readObjectImages(generatorSettings.trainers, settings, "trainers", "g000si0000trai");
-    readObjectImages(generatorSettings.mercenaries, settings, "mercenaries", "g000si0000merc");
-    readObjectImages(generatorSettings.resourceMarkets, settings, "resourceMarkets",
-                     "g000si0000rmkt");
+    const sol::table& table = lua["settings"];
+
+    readForbiddenUnits(settings, table);
+    readForbiddenItems(settings, table);
+    readForbiddenSpells(settings, table);
+    readLandmarks(settings, table);
+    readObjectImages(settings.ruins, table, "ruins", "g000ru00000");
+    readObjectImages(settings.merchants, table, "merchants", "g000si0000merh");
+    readObjectImages(settings.mages, table, "mages", "g000si0000mage");
+    readObjectImages(settings.trainers, table, "trainers", "g000si0000trai");
+    readObjectImages(settings.mercenaries, table, "mercenaries", "g000si0000merc");
+    readObjectImages(settings.resourceMarkets, table, "resourceMarkets", "g000si0000rmkt");
 }
 
-static void processFFFileRecords(const std::filesystem::path& ffFilePath,
-                                 void (*processRecord)(const std::string& recordName))
+static void processFFFileRecords(GeneratorSettings& settings,
+                                 const std::filesystem::path& ffFilePath,
+                                 void (*processRecord)(GeneratorSettings& settings,
+                                                       std::string_view recordName))
 {
-    mqdb::Mqdb file(ffFilePath, false);
-    const std::vector<std::string>& recordNames = file.indexData.images.names;
+    // Only image names are needed, map the file and don't read anything else
+    const mqdb::MappedMqdb file(ffFilePath);
 
-    for (const auto& name : recordNames) {
-        processRecord(name);
+    for (const auto& name : file.getImageNames()) {
+        processRecord(settings, name);
     }
 }
 
 // Get mountain data from 'MOMNE<size><image>' record names
-static void processMountainRecord(const std::string& recordName, std::size_t pos)
+static void processMountainRecord(GeneratorSettings& settings,
+                                  std::string_view recordName,
+                                  std::size_t pos)
 {
     const char* start = recordName.data() + pos + std::size(mountainPrefix) - 1;
 
@@ -224,13 +226,14 @@ static void processMountainRecord(const std::string& recordName, std::size_t pos
         throw std::runtime_error("Could not read mountain image from record name");
     }
 
-    generatorSettings.mountains.push_back(mountain);
+    settings.mountains.push_back(mountain);
 }
 
-static void processTerrainRecords(const std::filesystem::path& isoTerrnFilePath)
+static void processTerrainRecords(GeneratorSettings& settings,
+                                  const std::filesystem::path& isoTerrnFilePath)
 {
-    mqdb::Mqdb file(isoTerrnFilePath, false);
-    const std::vector<std::string>& recordNames = file.indexData.images.names;
+    const mqdb::MappedMqdb file(isoTerrnFilePath);
+    const std::vector<std::string_view> recordNames{file.getImageNames()};
 
     // Maximum tree image index for each race
     // Same order as in RaceType
@@ -239,8 +242,8 @@ static void processTerrainRecords(const std::filesystem::path& isoTerrnFilePath)
     for (const auto& recordName : recordNames) {
         // Check for mountain records
         const std::size_t mountainPrefixPos = recordName.find(mountainPrefix);
-        if (mountainPrefixPos != std::string::npos) {
-            processMountainRecord(recordName, mountainPrefixPos);
+        if (mountainPrefixPos != std::string_view::npos) {
+            processMountainRecord(settings, recordName, mountainPrefixPos);
             continue;
         }
 
@@ -248,7 +251,7 @@ static void processTerrainRecords(const std::filesystem::path& isoTerrnFilePath)
         // Determine max value of 'index 2' for each race
         for (int i = 0; i < 6; ++i) {
             const std::size_t pos = recordName.find(treePrefixes[i]);
-            if (pos == std::string::npos) {
+            if (pos == std::string_view::npos) {
                 continue;
             }
 
@@ -267,17 +270,17 @@ static void processTerrainRecords(const std::filesystem::path& isoTerrnFilePath)
     }
 
     // Choose minimal value from all races maximums
-    generatorSettings.maxTreeImageIndex = *std::min_element(std::begin(treeMaxIndices),
-                                                            std::end(treeMaxIndices));
+    settings.maxTreeImageIndex = *std::min_element(std::begin(treeMaxIndices),
+                                                   std::end(treeMaxIndices));
 }
 
 // Get bag images from 'G000BG0000<terrain><image>' record names
-static void processBagRecord(const std::string& recordName)
+static void processBagRecord(GeneratorSettings& settings, std::string_view recordName)
 {
     static const char prefix[] = "G000BG0000";
 
     const std::size_t pos = recordName.find(prefix);
-    if (pos == std::string::npos) {
+    if (pos == std::string_view::npos) {
         return;
     }
 
@@ -291,16 +294,16 @@ static void processBagRecord(const std::string& recordName)
     }
 
     if (onLand) {
-        generatorSettings.bags.images.insert(image);
+        settings.bags.images.insert(image);
     } else {
-        generatorSettings.bags.waterImages.insert(image);
+        settings.bags.waterImages.insert(image);
     }
 }
 
-bool readGeneratorSettings(const std::filesystem::path& gameFolderPath)
+bool readGeneratorSettings(GeneratorSettings& settings, const std::filesystem::path& gameFolderPath)
 {
     // Make sure we read fresh settings each time
-    generatorSettings = GeneratorSettings();
+    settings = GeneratorSettings();
 
     try {
         // Read and parse 'Scripts/generatorSettings.lua'
@@ -329,12 +332,12 @@ bool readGeneratorSettings(const std::filesystem::path& gameFolderPath)
             return false;
         }
 
-        readScriptSettings(lua);
+        readScriptSettings(settings, lua);
 
         const std::filesystem::path imagesPath = gameFolderPath / "Imgs";
 
-        processTerrainRecords(imagesPath / "IsoTerrn.ff");
-        processFFFileRecords(imagesPath / "IsoCmon.ff", processBagRecord);
+        processTerrainRecords(settings, imagesPath / "IsoTerrn.ff");
+        processFFFileRecords(settings, imagesPath / "IsoCmon.ff", processBagRecord);
     } catch (const std::exception& e) {
         std::cerr << "Could not read generator settings: " << e.what() << '\n';
         return false;
@@ -343,49 +346,44 @@ bool readGeneratorSettings(const std::filesystem::path& gameFolderPath)
     return true;
 }
 
-const GeneratorSettings& getGeneratorSettings()
-{
-    return generatorSettings;
-}
-
-std::uint8_t getRandomTreeImageIndex(RandomGenerator& rand)
+std::uint8_t getRandomTreeImageIndex(const GeneratorSettings& settings, RandomGenerator& rand)
 {
-    return rand.nextInteger(std::uint8_t{0}, getGeneratorSettings().maxTreeImageIndex);
+    return rand.nextInteger(std::uint8_t{0}, settings.maxTreeImageIndex);
 }
 
-bool isEmpireLandmark(const CMidgardID& landmarkId)
+bool isEmpireLandmark(const GeneratorSettings& settings, const CMidgardID& landmarkId)
 {
-    return contains(getGeneratorSettings().landmarks.empire, landmarkId);
+    return contains(settings.landmarks.empire, landmarkId);
 }
 
-bool isClansLandmark(const CMidgardID& landmarkId)
+bool isClansLandmark(const GeneratorSettings& settings, const CMidgardID& landmarkId)
 {
-    return contains(getGeneratorSettings().landmarks.clans, landmarkId);
+    return contains(settings.landmarks.clans, landmarkId);
 }
 
-bool isUndeadLandmark(const CMidgardID& landmarkId)
+bool isUndeadLandmark(const GeneratorSettings& settings, const CMidgardID& landmarkId)
 {
-    return contains(getGeneratorSettings().landmarks.undead, landmarkId);
+    return contains(settings.landmarks.undead, landmarkId);
 }
 
-bool isLegionsLandmark(const CMidgardID& landmarkId)
+bool isLegionsLandmark(const GeneratorSettings& settings, const CMidgardID& landmarkId)
 {
-    return contains(getGeneratorSettings().landmarks.legions, landmarkId);
+    return contains(settings.landmarks.legions, landmarkId);
 }
 
-bool isElvesLandmark(const CMidgardID& landmarkId)
+bool isElvesLandmark(const GeneratorSettings& settings, const CMidgardID& landmarkId)
 {
-    return contains(getGeneratorSettings().landmarks.elves, landmarkId);
+    return contains(settings.landmarks.elves, landmarkId);
 }
 
-bool isNeutralLandmark(const CMidgardID& landmarkId)
+bool isNeutralLandmark(const GeneratorSettings& settings, const CMidgardID& landmarkId)
 {
-    return contains(getGeneratorSettings().landmarks.neutral, landmarkId);
+    return contains(settings.landmarks.neutral, landmarkId);
 }
 
-bool isMountainLandmark(const CMidgardID& landmarkId)
+bool isMountainLandmark(const GeneratorSettings& settings, const CMidgardID& landmarkId)
 {
-    return contains(getGeneratorSettings().landmarks.mountains, landmarkId);
+    return contains(settings.landmarks.mountains, landmarkId);
 }
 
 } // namespace rsg
@@ -28,7 +28,7 @@ namespace rsg {
 
 class RandomGenerator;
 
-/** Scenario generator settings that are global. */
+/** Scenario generator settings read from game folder. */
 struct GeneratorSettings
 {
     // Units that will be never used in generation
@@ -85,18 +85,17 @@ struct GeneratorSettings
     std::uint8_t maxTreeImageIndex{};
 };
 
-bool readGeneratorSettings(const std::filesystem::path& gameFolderPath);
+// Reads settings from 'Scripts/generatorSettings.lua' and game images
+bool readGeneratorSettings(GeneratorSettings& settings, const std::filesystem::path& gameFolderPath);
 
-const GeneratorSettings& getGeneratorSettings();
+std::uint8_t getRandomTreeImageIndex(const GeneratorSettings& settings, RandomGenerator& rand);
 
-std::uint8_t getRandomTreeImageIndex(RandomGenerator& rand);
-
-bool isEmpireLandmark(const CMidgardID& landmarkId);
-bool isClansLandmark(const CMidgardID& landmarkId);
-bool isUndeadLandmark(const CMidgardID& landmarkId);
-bool isLegionsLandmark(const CMidgardID& landmarkId);
-bool isElvesLandmark(const CMidgardID& landmarkId);
-bool isNeutralLandmark(const CMidgardID& landmarkId);
-bool isMountainLandmark(const CMidgardID& landmarkId);
+bool isEmpireLandmark(const GeneratorSettings& settings, const CMidgardID& landmarkId);
+bool isClansLandmark(const GeneratorSettings& settings, const CMidgardID& landmarkId);
+bool isUndeadLandmark(const GeneratorSettings& settings, const CMidgardID& landmarkId);
+bool isLegionsLandmark(const GeneratorSettings& settings, const CMidgardID& landmarkId);
+bool isElvesLandmark(const GeneratorSettings& settings, const CMidgardID& landmarkId);
+bool isNeutralLandmark(const GeneratorSettings& settings, const CMidgardID& landmarkId);
+bool isMountainLandmark(const GeneratorSettings& settings, const CMidgardID& landmarkId);
 
 } // namespace rsg
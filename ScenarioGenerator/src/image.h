@@ -22,6 +22,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <utility>
 #include <vector>
 
 namespace rsg {
@@ -52,6 +53,12 @@ public:
         , height{height}
     { }
 
+    Image(std::size_t width, std::size_t height, std::vector<RgbColor>&& pixels)
+        : pixels{std::move(pixels)}
+        , width{width}
+        , height{height}
+    { }
+
     bool write(std::filesystem::path& file) const;
     bool write(const char* file) const;
 
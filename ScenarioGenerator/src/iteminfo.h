@@ -20,10 +20,12 @@
 #pragma once
 
 #include "enums.h"
+#include <cstddef>
 
 namespace rsg {
 
 class CMidgardID;
+class GameInfo;
 
 // Information about item from GItem and LmagItm.dbf
 class ItemInfo
@@ -36,8 +38,19 @@ public:
 
     virtual int getValue() const = 0;
 
+    // Returns stable index of item in game catalog
+    std::size_t getCatalogIndex() const
+    {
+        return catalogIndex;
+    }
+
 protected:
     ItemInfo() = default;
+
+private:
+    friend void assignCatalogIndices(GameInfo& gameInfo);
+
+    std::size_t catalogIndex{};
 };
 
 } // namespace rsg
@@ -18,9 +18,7 @@
  */
 
 #include "itempicker.h"
-#include "containers.h"
-#include "gameinfo.h"
-#include "generatorsettings.h"
+#include "generationcontext.h"
 #include "picker.h"
 
 namespace rsg {
@@ -32,14 +30,19 @@ ItemInfo* pickItem(const std::vector<ItemInfo*>& itemPool,
     return pick(itemPool, random, filters);
 }
 
-ItemInfo* pickItem(RandomGenerator& random, const ItemFilterList& filters)
+ItemInfo* pickItem(const GenerationContext& context,
+                   RandomGenerator& random,
+                   const ItemFilterList& filters)
 {
-    return pickItem(getGameInfo()->getItems(), random, filters);
+    return pickItem(context.getCatalog().getItems(), random, filters);
 }
 
-ItemInfo* pickItem(ItemType itemType, RandomGenerator& random, const ItemFilterList& filters)
+ItemInfo* pickItem(const GenerationContext& context,
+                   ItemType itemType,
+                   RandomGenerator& random,
+                   const ItemFilterList& filters)
 {
-    return pickItem(getGameInfo()->getItems(itemType), random, filters);
+    return pickItem(context.getCatalog().getItems(itemType), random, filters);
 }
 
 bool noSpecialItem(const ItemInfo* info)
@@ -47,9 +50,4 @@ bool noSpecialItem(const ItemInfo* info)
     return info->getItemType() == ItemType::Special;
 }
 
-bool noForbiddenItem(const ItemInfo* info)
-{
-    return contains(getGeneratorSettings().forbiddenItems, info->getItemId());
-}
-
 } // namespace rsg
@@ -25,6 +25,7 @@
 
 namespace rsg {
 
+class GenerationContext;
 class ItemInfo;
 class RandomGenerator;
 
@@ -38,15 +39,18 @@ ItemInfo* pickItem(const std::vector<ItemInfo*>& itemPool,
                    RandomGenerator& random,
                    const ItemFilterList& filters);
 // Picks any random item after applying filters
-ItemInfo* pickItem(RandomGenerator& random, const ItemFilterList& filters);
+ItemInfo* pickItem(const GenerationContext& context,
+                   RandomGenerator& random,
+                   const ItemFilterList& filters);
 // Picks random item of specific type
-ItemInfo* pickItem(ItemType itemType, RandomGenerator& random, const ItemFilterList& filters);
+ItemInfo* pickItem(const GenerationContext& context,
+                   ItemType itemType,
+                   RandomGenerator& random,
+                   const ItemFilterList& filters);
 
 // These below are predefined filters
 
 // Removes special items from pick
 bool noSpecialItem(const ItemInfo* info);
-// Removes forbidden items from pick
-bool noForbiddenItem(const ItemInfo* info);
 
 } // namespace rsg
@@ -18,7 +18,7 @@
  */
 
 #include "landmarkpicker.h"
-#include "gameinfo.h"
+#include "generationcontext.h"
 #include "picker.h"
 
 namespace rsg {
@@ -30,23 +30,27 @@ LandmarkInfo* pickLandmark(const std::vector<LandmarkInfo*>& landmarkPool,
     return pick(landmarkPool, random, filters);
 }
 
-LandmarkInfo* pickLandmark(LandmarkType landmarkType,
+LandmarkInfo* pickLandmark(const GenerationContext& context,
+                           LandmarkType landmarkType,
                            RandomGenerator& random,
                            const LandmarkFilterList& filters)
 {
-    return pickLandmark(getGameInfo()->getLandmarks(landmarkType), random, filters);
+    return pickLandmark(context.getGameInfo().getLandmarks(landmarkType), random, filters);
 }
 
-LandmarkInfo* pickLandmark(RaceType raceType,
+LandmarkInfo* pickLandmark(const GenerationContext& context,
+                           RaceType raceType,
                            RandomGenerator& random,
                            const LandmarkFilterList& filters)
 {
-    return pickLandmark(getGameInfo()->getLandmarks(raceType), random, filters);
+    return pickLandmark(context.getGameInfo().getLandmarks(raceType), random, filters);
 }
 
-LandmarkInfo* pickMountainLandmark(RandomGenerator& random, const LandmarkFilterList& filters)
+LandmarkInfo* pickMountainLandmark(const GenerationContext& context,
+                                   RandomGenerator& random,
+                                   const LandmarkFilterList& filters)
 {
-    return pickLandmark(getGameInfo()->getMountainLandmarks(), random, filters);
+    return pickLandmark(context.getGameInfo().getMountainLandmarks(), random, filters);
 }
 
 } // namespace rsg
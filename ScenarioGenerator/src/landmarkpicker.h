@@ -25,6 +25,7 @@
 
 namespace rsg {
 
+class GenerationContext;
 class LandmarkInfo;
 class RandomGenerator;
 
@@ -38,14 +39,18 @@ LandmarkInfo* pickLandmark(const std::vector<LandmarkInfo*>& landmarkPool,
                            RandomGenerator& random,
                            const LandmarkFilterList& filters);
 // Pick random landmark of specified type
-LandmarkInfo* pickLandmark(LandmarkType landmarkType,
+LandmarkInfo* pickLandmark(const GenerationContext& context,
+                           LandmarkType landmarkType,
                            RandomGenerator& random,
                            const LandmarkFilterList& filters);
 // Pick random landmark visually appropriate for specified race
-LandmarkInfo* pickLandmark(RaceType raceType,
+LandmarkInfo* pickLandmark(const GenerationContext& context,
+                           RaceType raceType,
                            RandomGenerator& random,
                            const LandmarkFilterList& filters);
 // Pick random mountain landmark
-LandmarkInfo* pickMountainLandmark(RandomGenerator& random, const LandmarkFilterList& filters);
+LandmarkInfo* pickMountainLandmark(const GenerationContext& context,
+                                   RandomGenerator& random,
+                                   const LandmarkFilterList& filters);
 
 } // namespace rsg
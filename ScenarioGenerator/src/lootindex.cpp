@@ -0,0 +1,69 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lootindex.h"
+#include "forbiddenfilter.h"
+#include "itempicker.h"
+#include "picker.h"
+#include <vector>
+
+namespace rsg {
+
+LootIndex::LootIndex(const Catalog& catalog, const ForbiddenFilter& forbidden)
+{
+    // Catalog pools are sorted by value, filtered copies stay sorted
+    for (auto item : catalog.getItems()) {
+        if (noSpecialItem(item) || forbidden.isForbidden(item)) {
+            continue;
+        }
+
+        itemsByType[item->getItemType()].push_back(item);
+    }
+}
+
+const ItemInfo* LootIndex::pick(RandomGenerator& random,
+                                const std::set<ItemType>& itemTypes,
+                                bool noValuables,
+                                int minValue,
+                                int maxValue) const
+{
+    if (minValue > maxValue) {
+        return nullptr;
+    }
+
+    // Item types are read from game data as is, mods could add more of them
+    std::vector<PoolRange<ItemInfo>> ranges;
+    ranges.reserve(itemsByType.size());
+
+    for (const auto& [itemType, pool] : itemsByType) {
+        if (noValuables && itemType == ItemType::Valuable) {
+            continue;
+        }
+
+        if (!itemTypes.empty() && itemTypes.find(itemType) == itemTypes.end()) {
+            continue;
+        }
+
+        ranges.push_back(getValueRange(pool, minValue, maxValue));
+    }
+
+    return pickFromRanges(ranges.cbegin(), ranges.cend(), random);
+}
+
+} // namespace rsg
@@ -0,0 +1,53 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "catalog.h"
+#include <map>
+#include <set>
+
+namespace rsg {
+
+class ForbiddenFilter;
+class RandomGenerator;
+
+// Items allowed in loot of a single template.
+// Pools are partitioned by item type and sorted by value in ascending order.
+// Special items and items forbidden globally or by template are excluded beforehand
+class LootIndex
+{
+public:
+    LootIndex(const Catalog& catalog, const ForbiddenFilter& forbidden);
+
+    // Picks random item with value in [minValue : maxValue] range.
+    // Empty item types set allows items of any type.
+    // Each suitable item has the same chance to be picked.
+    // Returns nullptr if there are no suitable items
+    const ItemInfo* pick(RandomGenerator& random,
+                         const std::set<ItemType>& itemTypes,
+                         bool noValuables,
+                         int minValue,
+                         int maxValue) const;
+
+private:
+    std::map<ItemType, ItemInfoArray> itemsByType;
+};
+
+} // namespace rsg
@@ -0,0 +1,123 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "luaarena.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+namespace rsg {
+
+LuaArena::~LuaArena()
+{
+    // Large blocks of a closed state are already freed
+    assert(used == 0);
+}
+
+void* LuaArena::allocate(void* userData, void* block, std::size_t oldSize, std::size_t newSize)
+{
+    // When block is null old size holds type of object being created
+    return static_cast<LuaArena*>(userData)->reallocate(block, block ? oldSize : 0, newSize);
+}
+
+void LuaArena::reset()
+{
+    assert(used == 0);
+
+    freeLists.fill(nullptr);
+    currentChunk = 0;
+    chunkOffset = 0;
+}
+
+void* LuaArena::reallocate(void* block, std::size_t oldSize, std::size_t newSize)
+{
+    if (newSize == 0) {
+        if (oldSize > maxSmallSize) {
+            std::free(block);
+        } else if (block) {
+            freeSmall(block, oldSize);
+        }
+
+        used -= oldSize;
+        return nullptr;
+    }
+
+    void* newBlock{};
+    if (oldSize > maxSmallSize && newSize > maxSmallSize) {
+        newBlock = std::realloc(block, newSize);
+    } else if (block && oldSize > 0 && getSizeClass(oldSize) == getSizeClass(newSize)) {
+        newBlock = block;
+    } else {
+        newBlock = newSize > maxSmallSize ? std::malloc(newSize) : allocateSmall(newSize);
+        if (newBlock && block) {
+            std::memcpy(newBlock, block, std::min(oldSize, newSize));
+
+            if (oldSize > maxSmallSize) {
+                std::free(block);
+            } else {
+                freeSmall(block, oldSize);
+            }
+        }
+    }
+
+    if (newBlock) {
+        used = used - oldSize + newSize;
+    }
+
+    return newBlock;
+}
+
+void* LuaArena::allocateSmall(std::size_t size)
+{
+    auto& freeList{freeLists[getSizeClass(size)]};
+    if (freeList) {
+        FreeBlock* block{freeList};
+        freeList = block->next;
+        return block;
+    }
+
+    const std::size_t blockSize{(getSizeClass(size) + 1) * granularity};
+    if (currentChunk == chunks.size() || chunkOffset + blockSize > chunkSize) {
+        if (currentChunk < chunks.size()) {
+            // Rest of the current chunk is too small, move to the next one
+            ++currentChunk;
+            chunkOffset = 0;
+        }
+
+        if (currentChunk == chunks.size()) {
+            chunks.push_back(std::make_unique<std::byte[]>(chunkSize));
+        }
+    }
+
+    void* block{chunks[currentChunk].get() + chunkOffset};
+    chunkOffset += blockSize;
+    return block;
+}
+
+void LuaArena::freeSmall(void* block, std::size_t size)
+{
+    auto& freeList{freeLists[getSizeClass(size)]};
+
+    auto freeBlock{static_cast<FreeBlock*>(block)};
+    freeBlock->next = freeList;
+    freeList = freeBlock;
+}
+
+} // namespace rsg
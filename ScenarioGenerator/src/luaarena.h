@@ -0,0 +1,79 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace rsg {
+
+// Lua allocator that serves small blocks from large chunks.
+// Freed small blocks are reused through per size free lists, larger blocks use heap.
+// Reset rewinds all chunks at once without returning them to the system
+class LuaArena
+{
+public:
+    LuaArena() = default;
+    ~LuaArena();
+
+    LuaArena(const LuaArena&) = delete;
+    LuaArena& operator=(const LuaArena&) = delete;
+
+    // Allocation function to pass to lua_newstate, user data must point to arena
+    static void* allocate(void* userData, void* block, std::size_t oldSize, std::size_t newSize);
+
+    // Forgets all blocks. Lua state that used arena must be closed before reset
+    void reset();
+
+    // Returns memory allocated by Lua
+    std::size_t getUsed() const
+    {
+        return used;
+    }
+
+private:
+    static constexpr std::size_t granularity{16};
+    static constexpr std::size_t maxSmallSize{512};
+    static constexpr std::size_t chunkSize{256 * 1024};
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    void* reallocate(void* block, std::size_t oldSize, std::size_t newSize);
+    void* allocateSmall(std::size_t size);
+    void freeSmall(void* block, std::size_t size);
+
+    static std::size_t getSizeClass(std::size_t size)
+    {
+        return (size + granularity - 1) / granularity - 1;
+    }
+
+    std::vector<std::unique_ptr<std::byte[]>> chunks;
+    std::size_t currentChunk{};
+    std::size_t chunkOffset{};
+    std::array<FreeBlock*, maxSmallSize / granularity> freeLists{};
+    std::size_t used{};
+};
+
+} // namespace rsg
@@ -0,0 +1,114 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "luastatepool.h"
+#include "luaarena.h"
+#include "maptemplatereader.h"
+#include "templatecache.h"
+#include <lua.hpp>
+#include <optional>
+#include <sol/sol.hpp>
+
+namespace rsg {
+
+struct LuaStatePool::PooledState
+{
+    // Declared before the state, state is closed first
+    LuaArena arena;
+    std::optional<sol::state> lua;
+};
+
+LuaStatePool::LuaStatePool(TemplateCache& templateCache,
+                           const std::filesystem::path& templatePath,
+                           std::size_t maxStateMemory)
+    : templateCache{templateCache}
+    , templatePath{templatePath}
+    , maxStateMemory{maxStateMemory}
+{ }
+
+LuaStatePool::~LuaStatePool() = default;
+
+LuaStatePool::Lease LuaStatePool::acquire()
+{
+    PooledStatePtr pooled;
+
+    {
+        std::lock_guard<std::mutex> lock{idleStatesMutex};
+
+        if (!idleStates.empty()) {
+            pooled = std::move(idleStates.back());
+            idleStates.pop_back();
+        }
+    }
+
+    if (!pooled) {
+        pooled = std::make_unique<PooledState>();
+    }
+
+    if (!pooled->lua) {
+        initialize(*pooled);
+    }
+
+    // Contents are evaluated without collection pauses, garbage is collected on release
+    lua_gc(pooled->lua->lua_state(), LUA_GCSTOP);
+
+    return Lease{*this, std::move(pooled)};
+}
+
+void LuaStatePool::initialize(PooledState& pooled)
+{
+    pooled.lua.emplace(sol::default_at_panic, LuaArena::allocate, &pooled.arena);
+
+    bindLuaApi(*pooled.lua);
+    // Executes template chunk, settings are not needed here
+    templateCache.readTemplateSettings(templatePath, *pooled.lua);
+}
+
+void LuaStatePool::release(PooledStatePtr&& pooled)
+{
+    if (pooled->arena.getUsed() > maxStateMemory) {
+        // Create state again on next use, arena chunks are reused
+        pooled->lua.reset();
+        pooled->arena.reset();
+    } else {
+        lua_gc(pooled->lua->lua_state(), LUA_GCCOLLECT);
+    }
+
+    std::lock_guard<std::mutex> lock{idleStatesMutex};
+    idleStates.push_back(std::move(pooled));
+}
+
+LuaStatePool::Lease::Lease(LuaStatePool& pool, PooledStatePtr&& pooled)
+    : pool{&pool}
+    , pooled{std::move(pooled)}
+{ }
+
+LuaStatePool::Lease::~Lease()
+{
+    if (pooled) {
+        pool->release(std::move(pooled));
+    }
+}
+
+sol::state& LuaStatePool::Lease::getLua()
+{
+    return *pooled->lua;
+}
+
+} // namespace rsg
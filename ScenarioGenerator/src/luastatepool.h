@@ -0,0 +1,94 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sol {
+class state;
+}
+
+namespace rsg {
+
+class TemplateCache;
+
+// Lua states ready to evaluate contents of a single template.
+// Each state has scenario generator api bound, template chunk executed
+// and allocates memory from its own arena.
+// Garbage collector is stopped while state is in use and runs when state is returned,
+// states that grew too large are recreated in the same arena.
+// Pool can be used from several threads, each state is used by one thread at a time
+class LuaStatePool
+{
+public:
+    class Lease;
+
+    // Template cache must outlive the pool
+    LuaStatePool(TemplateCache& templateCache,
+                 const std::filesystem::path& templatePath,
+                 std::size_t maxStateMemory = 64 * 1024 * 1024);
+    ~LuaStatePool();
+
+    LuaStatePool(const LuaStatePool&) = delete;
+    LuaStatePool& operator=(const LuaStatePool&) = delete;
+
+    // Returns idle state or creates a new one if all states are in use.
+    // Throws exception if template could not be loaded
+    Lease acquire();
+
+private:
+    struct PooledState;
+    using PooledStatePtr = std::unique_ptr<PooledState>;
+
+    void initialize(PooledState& pooled);
+    void release(PooledStatePtr&& pooled);
+
+    TemplateCache& templateCache;
+    std::filesystem::path templatePath;
+    std::size_t maxStateMemory;
+    std::vector<PooledStatePtr> idleStates;
+    std::mutex idleStatesMutex;
+};
+
+// State acquired from pool, returns it back on destruction
+class LuaStatePool::Lease
+{
+public:
+    Lease(Lease&& other) noexcept = default;
+    ~Lease();
+
+    Lease& operator=(Lease&&) = delete;
+
+    sol::state& getLua();
+
+private:
+    friend class LuaStatePool;
+
+    Lease(LuaStatePool& pool, PooledStatePtr&& pooled);
+
+    LuaStatePool* pool;
+    PooledStatePtr pooled;
+};
+
+} // namespace rsg
@@ -18,30 +18,40 @@
  */
 
 #include "mapgenerator.h"
+#include "cancellationtoken.h"
 #include "diplomacy.h"
+#include "exceptions.h"
 #include "fog.h"
 #include "image.h"
 #include "knownspells.h"
 #include "maptemplate.h"
 #include "player.h"
 #include "playerbuildings.h"
+#include "previewrasterizer.h"
+#include "profiler.h"
 #include "road.h"
 #include "scenarioinfo.h"
 #include "subrace.h"
+#include <atomic>
 #include <cassert>
+#include <exception>
 #include <iostream>
 #include <numeric>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 
 namespace rsg {
 
+// Buffer of zone that is filled by current thread in parallel mode
+static thread_local ZoneFillBuffer* currentFillBuffer{};
+
 PlayerSubraceIdPair MapGenerator::createPlayer(RaceType race)
 {
     auto playerId{createId(CMidgardID::Type::Player)};
 
     auto player{std::make_unique<Player>(playerId)};
-    player->setRace(getGameInfo()->getRaceInfo(race).getRaceId());
+    player->setRace(context.getGameInfo().getRaceInfo(race).getRaceId());
     player->setLord(getLordId(race));
 
     if (race != RaceType::Neutral) {
@@ -90,7 +100,38 @@ PlayerSubraceIdPair MapGenerator::createPlayer(RaceType race)
 
 MapPtr MapGenerator::generate()
 {
+    prepareGeneration();
+    generateZones();
+
+    return finishGeneration();
+}
+
+MapPtr MapGenerator::generate(const GenerationCheckpointPtr& placement)
+{
+    prepareGeneration();
+    restoreZones(placement);
+
+    return finishGeneration();
+}
+
+void MapGenerator::prepareGeneration()
+{
+    const int maxSize{mapGenOptions.largeMap ? maxLargeMapSize : maxScenarioSize};
+    if (mapGenOptions.size < 1 || mapGenOptions.size > maxSize) {
+        std::stringstream stream;
+        stream << "Scenario size " << mapGenOptions.size << " is not supported, maximum is "
+               << maxSize;
+
+        throw std::runtime_error(stream.str());
+    }
+
     map = std::make_unique<Map>();
+    const auto& catalog{context.getCatalog()};
+    forbidden = std::make_unique<ForbiddenFilter>(context.getGameInfo(), catalog,
+                                                  context.getGeneratorSettings(),
+                                                  mapGenOptions.mapTemplate->settings);
+    lootIndex = std::make_unique<LootIndex>(catalog, *forbidden);
+    unitIndex = std::make_unique<UnitIndex>(catalog, *forbidden);
 
     addHeaderInfo();
     initTiles();
@@ -99,17 +140,65 @@ MapPtr MapGenerator::generate()
     auto playerSubraceIds{createPlayer(RaceType::Neutral)};
     neutralPlayerId = playerSubraceIds.first;
     neutralSubraceId = playerSubraceIds.second;
+}
 
-    generateZones();
+MapPtr MapGenerator::finishGeneration()
+{
     // Clear map so that all tiles are unguarded
     map->calculateGuardingCreaturePositions();
     fillZones();
 
+    reportProgress(GenerationPhase::SetupDiplomacy);
     setupDiplomacy();
 
+    reportProgress(GenerationPhase::Finished);
     return std::move(map);
 }
 
+void MapGenerator::checkCancelled() const
+{
+    if (cancellation && cancellation->isCancelled()) {
+        throw GenerationCancelledException("Scenario generation was cancelled");
+    }
+}
+
+void MapGenerator::reportProgress(GenerationPhase phase, std::size_t zone, std::size_t zonesTotal)
+{
+    if (phase != GenerationPhase::Finished) {
+        checkCancelled();
+    }
+
+    if (!progressCallback) {
+        return;
+    }
+
+    // Approximate share of generation time taken by each phase
+    static constexpr double phaseWeights[] = {
+        0.10, // PlaceZones
+        0.15, // CreateBorders
+        0.45, // FillZones
+        0.15, // CreateObstacles
+        0.05, // ConnectRoads
+        0.05, // CreateRoads
+        0.05, // SetupDiplomacy
+        0.00, // Finished
+    };
+
+    const auto phaseIndex{static_cast<std::size_t>(phase)};
+
+    GenerationProgress progress{phase, zone, zonesTotal, 0.0};
+    for (std::size_t i = 0; i < phaseIndex; ++i) {
+        progress.fraction += phaseWeights[i];
+    }
+
+    if (zonesTotal) {
+        progress.fraction += phaseWeights[phaseIndex] * zone / zonesTotal;
+    }
+
+    std::lock_guard<std::mutex> lock{progressMutex};
+    progressCallback(progress);
+}
+
 void MapGenerator::addHeaderInfo()
 {
     map->name = mapGenOptions.name;
@@ -117,16 +206,17 @@ void MapGenerator::addHeaderInfo()
     map->size = mapGenOptions.size;
 
     ScenarioInfo* info = map->getScenarioInfo();
+    const GameInfo& gameInfo{context.getGameInfo()};
 
     info->setBriefing(map->description);
     // Assume these identifiers exist, they are default texts used by Scenario Editor
     // They are also less than 255 characters long, no truncation needed.
     // 'No scenario objective defined'
-    info->setObjectives(getGameInfo()->getEditorInterfaceText(CMidgardID("X005TA0777")));
+    info->setObjectives(gameInfo.getEditorInterfaceText(CMidgardID("X005TA0777")));
     // 'Congratulations! You have successfully completed the quest.'
-    info->setWinMessage(getGameInfo()->getEditorInterfaceText(CMidgardID("X005TA0778")));
+    info->setWinMessage(gameInfo.getEditorInterfaceText(CMidgardID("X005TA0778")));
     // 'You have been defeated, the objective was completed by the enemy.'
-    info->setLoseMessage(getGameInfo()->getEditorInterfaceText(CMidgardID("X005TA0779")));
+    info->setLoseMessage(gameInfo.getEditorInterfaceText(CMidgardID("X005TA0779")));
     info->setSeed(static_cast<std::uint32_t>(randomSeed));
 }
 
@@ -139,7 +229,7 @@ void MapGenerator::initTiles()
     zoneColoring.resize(total);
 }
 
-void MapGenerator::generateZones()
+void MapGenerator::createZones()
 {
     auto tmpl = mapGenOptions.mapTemplate;
 
@@ -148,22 +238,76 @@ void MapGenerator::generateZones()
     for (const auto& pair : tmpl->contents.zones) {
         const auto& options{pair.second};
 
-        auto zone = std::make_shared<TemplateZone>(this);
+        auto zone = std::make_shared<TemplateZone>(this, context);
         zone->setOptions(*options);
         zones[zone->id] = zone;
     }
+}
+
+void MapGenerator::generateZones()
+{
+    RSG_PROFILE_SCOPE("MapGenerator::generateZones");
+
+    reportProgress(GenerationPhase::PlaceZones);
+
+    createZones();
 
     ZonePlacer placer(this);
     placer.placeZones(&randomGenerator);
+    checkCancelled();
     placer.assignZones();
 
+    // Zone placer changes only zone positions, zone tiles and zone coloring
+    auto placement{std::make_shared<GenerationCheckpoint>()};
+    for (const auto& [id, zone] : zones) {
+        placement->zones.push_back(GenerationCheckpoint::Zone{id, zone->getCenter(),
+                                                              zone->getPosition(),
+                                                              zone->getTileInfo()});
+    }
+
+    placement->zoneColoring = zoneColoring;
+    placement->randomGenerator = randomGenerator;
+    placement->size = mapGenOptions.size;
+    checkpoint = std::move(placement);
+
     if (isDebugMode()) {
         std::cout << "Zones generated successfully\n";
     }
 }
 
+void MapGenerator::restoreZones(const GenerationCheckpointPtr& placement)
+{
+    reportProgress(GenerationPhase::PlaceZones);
+
+    createZones();
+
+    if (placement->size != mapGenOptions.size || placement->zones.size() != zones.size()) {
+        throw std::runtime_error("Zone placement does not match template contents");
+    }
+
+    for (const auto& placedZone : placement->zones) {
+        auto it{zones.find(placedZone.id)};
+        if (it == zones.end()) {
+            throw std::runtime_error("Zone placement does not match template contents");
+        }
+
+        it->second->setPlacement(placedZone.center, placedZone.position, placedZone.tiles);
+    }
+
+    zoneColoring = placement->zoneColoring;
+    randomGenerator = placement->randomGenerator;
+    // Shared, not copied
+    checkpoint = placement;
+
+    if (isDebugMode()) {
+        std::cout << "Zones restored from checkpoint\n";
+    }
+}
+
 void MapGenerator::fillZones()
 {
+    RSG_PROFILE_SCOPE("MapGenerator::fillZones");
+
     if (isDebugMode()) {
         std::cout << "Started filling zones\n";
     }
@@ -181,24 +325,33 @@ void MapGenerator::fillZones()
         }
     }
 
-    for (auto& it : zones) {
-        it.second->initTowns();
+    if (mapGenOptions.fillSeed) {
+        // Fill zones again with other random streams, zone placement stays the same
+        randomGenerator = randomGenerator.getStream(SplitMix64::mix(mapGenOptions.fillSeed));
     }
 
-    // Make sure there are some free tiles in the zone
-    for (auto& it : zones) {
-        it.second->initFreeTiles();
+    // Each zone uses its own random stream, zone contents do not depend on fill order
+    for (auto& [id, zone] : zones) {
+        zone->setRandomGenerator(randomGenerator.getStream(static_cast<std::uint64_t>(id)));
     }
 
-    for (auto& it : zones) {
-        it.second->createBorder();
+    const bool parallel{mapGenOptions.fillThreads > 0};
+    if (parallel) {
+        beginParallelFill();
     }
 
+    reportProgress(GenerationPhase::CreateBorders);
+
+    forEachZone(&TemplateZone::initTowns);
+    // Make sure there are some free tiles in the zone
+    forEachZone(&TemplateZone::initFreeTiles);
+    forEachZone(&TemplateZone::createBorder);
+    // Fail before filling zones if their contents can not fit
+    forEachZone(&TemplateZone::estimateCapacity);
+
     createDirectConnections();
 
-    for (auto& it : zones) {
-        it.second->fill();
-    }
+    forEachZone(&TemplateZone::fill, GenerationPhase::FillZones);
 
     constexpr bool debugObstacles{false};
 
@@ -206,6 +359,8 @@ void MapGenerator::fillZones()
         debugTiles("before createObstacles.png");
     }
 
+    reportProgress(GenerationPhase::CreateObstacles);
+
     // TODO: this is tightenObstacles() actually
     createObstacles();
 
@@ -217,23 +372,213 @@ void MapGenerator::fillZones()
     // but as a loop through all possible tiles.
     // In this case mountains on zone boundaries can be made bigger.
     // Place actual obstacles matching zone terrain
-    for (auto& it : zones) {
-        it.second->createObstacles();
-    }
+    forEachZone(&TemplateZone::createObstacles, GenerationPhase::CreateObstacles);
 
     if constexpr (debugObstacles) {
         debugTiles("after createObstacles in zones.png");
     }
 
-    for (auto& it : zones) {
-        it.second->connectRoads();
+    forEachZone(&TemplateZone::connectRoads, GenerationPhase::ConnectRoads);
+
+    if (parallel) {
+        endParallelFill();
     }
 
+    reportProgress(GenerationPhase::CreateRoads);
     createRoads();
 }
 
+void MapGenerator::forEachZone(void (TemplateZone::*phase)(),
+                               std::optional<GenerationPhase> progressPhase)
+{
+    if (!fillBuffers.empty()) {
+        runParallelPhase(phase, progressPhase);
+        return;
+    }
+
+    std::size_t zonesDone{};
+
+    for (auto& it : zones) {
+        checkCancelled();
+        (it.second.get()->*phase)();
+
+        if (progressPhase) {
+            reportProgress(*progressPhase, ++zonesDone, zones.size());
+        }
+    }
+}
+
+void MapGenerator::runParallelPhase(void (TemplateZone::*phase)(),
+                                    std::optional<GenerationPhase> progressPhase)
+{
+    // Zones read tiles of other zones as they were at the start of the phase
+    phaseTiles = tiles;
+    phaseMapTiles = map->getTiles();
+
+    std::vector<TemplateZone*> zonesToFill;
+    for (auto& it : zones) {
+        zonesToFill.push_back(it.second.get());
+    }
+
+    std::vector<std::exception_ptr> errors(zonesToFill.size());
+    std::atomic<std::size_t> nextZone{};
+    std::atomic<std::size_t> zonesDone{};
+
+    auto fillZones = [&]() {
+        for (std::size_t i = nextZone++; i < zonesToFill.size(); i = nextZone++) {
+            currentFillBuffer = &fillBuffers[i];
+
+            try {
+                checkCancelled();
+                (zonesToFill[i]->*phase)();
+
+                if (progressPhase) {
+                    reportProgress(*progressPhase, ++zonesDone, zonesToFill.size());
+                }
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+
+            currentFillBuffer = nullptr;
+        }
+    };
+
+    const auto threadsTotal{std::min(mapGenOptions.fillThreads, zonesToFill.size())};
+
+    // Current thread fills zones too
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < threadsTotal; ++i) {
+        threads.emplace_back(fillZones);
+    }
+
+    fillZones();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Report error of the first failed zone, regardless of the order zones were filled
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Merge zone changes in zone id order, so results do not depend on threads count
+    for (auto& buffer : fillBuffers) {
+        buffer.merge(*map);
+    }
+}
+
+void MapGenerator::beginParallelFill()
+{
+    const int lanesTotal{static_cast<int>(zones.size()) + 1};
+
+    int lane{};
+    for (const auto& it : zones) {
+        fillBuffers.emplace_back(*map, it.first, lane++, lanesTotal);
+    }
+
+    // Code running between zone phases creates ids in the last lane
+    fillBuffers.emplace_back(*map, TemplateZoneId{-1}, lane, lanesTotal);
+}
+
+void MapGenerator::endParallelFill()
+{
+    // Continue creating ids after the greatest one created in lanes
+    for (int i = 0; i < static_cast<int>(CMidgardID::Type::Invalid); ++i) {
+        const auto type{static_cast<CMidgardID::Type>(i)};
+
+        int freeIndex{map->getFreeIdIndex(type)};
+        for (const auto& buffer : fillBuffers) {
+            freeIndex = std::max(freeIndex, buffer.getFreeIdIndex(type));
+        }
+
+        map->setFreeIdIndex(type, freeIndex);
+    }
+
+    fillBuffers.clear();
+    phaseTiles.clear();
+    phaseMapTiles.clear();
+}
+
+ZoneFillBuffer* MapGenerator::getFillBuffer()
+{
+    return currentFillBuffer;
+}
+
+bool MapGenerator::isOtherZoneTile(std::size_t tileIndex) const
+{
+    return currentFillBuffer && zoneColoring[tileIndex] != currentFillBuffer->getZoneId();
+}
+
+CMidgardID MapGenerator::createId(CMidgardID::Type type)
+{
+    if (currentFillBuffer) {
+        return currentFillBuffer->createId(type);
+    }
+
+    if (!fillBuffers.empty()) {
+        return fillBuffers.back().createId(type);
+    }
+
+    return map->createId(type);
+}
+
+bool MapGenerator::insertObject(std::unique_ptr<ScenarioObject>&& object)
+{
+    if (currentFillBuffer) {
+        return currentFillBuffer->insertObject(std::move(object));
+    }
+
+    return map->insertObject(std::move(object));
+}
+
+bool MapGenerator::insertObject(std::unique_ptr<Item>&& itemObject)
+{
+    // Add talisman charges each time we insert talisman item on the map
+    if (isTalisman(context.getGameInfo(), itemObject->getItemType())) {
+        const auto& itemId{itemObject->getId()};
+
+        if (currentFillBuffer) {
+            currentFillBuffer->defer([itemId](Map& map) { map.addTalismanCharge(itemId); });
+        } else {
+            map->addTalismanCharge(itemId);
+        }
+    }
+
+    return insertObject(std::unique_ptr<ScenarioObject>(std::move(itemObject)));
+}
+
+void MapGenerator::insertMapElement(const MapElement& mapElement, const CMidgardID& mapElementId)
+{
+    if (currentFillBuffer) {
+        // Element is owned by a buffered object, it stays alive until merge
+        currentFillBuffer->defer([&mapElement, mapElementId](Map& map) {
+            map.insertMapElement(mapElement, mapElementId);
+        });
+        return;
+    }
+
+    map->insertMapElement(mapElement, mapElementId);
+}
+
+void MapGenerator::addMountain(const Position& position, const Position& size, int image)
+{
+    if (currentFillBuffer) {
+        currentFillBuffer->defer([position, size, image](Map& map) {
+            map.addMountain(position, size, image);
+        });
+        return;
+    }
+
+    map->addMountain(position, size, image);
+}
+
 void MapGenerator::setupDiplomacy()
 {
+    RSG_PROFILE_SCOPE("MapGenerator::setupDiplomacy");
+
     std::vector<RaceType> races;
     map->visit(CMidgardID::Type::Player, [this, &races](const ScenarioObject* object) {
         auto player{dynamic_cast<const Player*>(object)};
@@ -243,15 +588,15 @@ void MapGenerator::setupDiplomacy()
     });
 
     const auto& customRelations{mapGenOptions.mapTemplate->contents.diplomacy.relations};
-    const GameInfo* info{getGameInfo()};
+    const GameInfo& info{context.getGameInfo()};
     Diplomacy* diplomacy{map->getDiplomacy()};
 
     for (std::size_t i = 0; i < races.size(); ++i) {
-        const RaceInfo& raceA{info->getRaceInfo(races[i])};
+        const RaceInfo& raceA{info.getRaceInfo(races[i])};
         const RaceType raceTypeA{raceA.getRaceType()};
 
         for (std::size_t j = i + 1; j < races.size(); ++j) {
-            const RaceInfo& raceB{info->getRaceInfo(races[j])};
+            const RaceInfo& raceB{info.getRaceInfo(races[j])};
             const RaceType raceTypeB{raceB.getRaceType()};
 
             const auto sameRaces = [raceTypeA, raceTypeB](const auto& relation) {
@@ -343,12 +688,16 @@ void MapGenerator::createDirectConnections()
 
 void MapGenerator::createObstacles()
 {
+    RSG_PROFILE_SCOPE("MapGenerator::createObstacles");
+
     // Tighten obstacles to improve visuals
     for (int i = 0; i < 3; ++i) {
         int blockedTiles{};
         int freeTiles{};
 
         for (int x = 0; x < map->size; ++x) {
+            checkCancelled();
+
             for (int y = 0; y < map->size; ++y) {
                 const Position tile{x, y};
                 // Only possible tiles can be changed
@@ -412,58 +761,42 @@ void MapGenerator::checkIsOnMap(const Position& position) const
 
 bool MapGenerator::isBlocked(const Position& position) const
 {
-    checkIsOnMap(position);
-
-    return tiles[posToIndex(position)].isBlocked();
+    return getTile(position).isBlocked();
 }
 
 bool MapGenerator::shouldBeBlocked(const Position& position) const
 {
-    checkIsOnMap(position);
-
-    return tiles[posToIndex(position)].shouldBeBlocked();
+    return getTile(position).shouldBeBlocked();
 }
 
 bool MapGenerator::isPossible(const Position& position) const
 {
-    checkIsOnMap(position);
-
-    return tiles[posToIndex(position)].isPossible();
+    return getTile(position).isPossible();
 }
 
 bool MapGenerator::isFree(const Position& position) const
 {
-    checkIsOnMap(position);
-
-    return tiles[posToIndex(position)].isFree();
+    return getTile(position).isFree();
 }
 
 bool MapGenerator::isUsed(const Position& position) const
 {
-    checkIsOnMap(position);
-
-    return tiles[posToIndex(position)].isUsed();
+    return getTile(position).isUsed();
 }
 
 bool MapGenerator::isRoad(const Position& position) const
 {
-    checkIsOnMap(position);
-
-    return tiles[posToIndex(position)].isRoad();
+    return getTile(position).isRoad();
 }
 
 void MapGenerator::setOccupied(const Position& position, TileType value)
 {
-    checkIsOnMap(position);
-
-    tiles[posToIndex(position)].setOccupied(value);
+    changeTile(position, [value](TileInfo& tile) { tile.setOccupied(value); });
 }
 
 void MapGenerator::setRoad(const Position& position, bool value)
 {
-    checkIsOnMap(position);
-
-    tiles[posToIndex(position)].setRoad(value);
+    changeTile(position, [value](TileInfo& tile) { tile.setRoad(value); });
 }
 
 void MapGenerator::foreachNeighbor(const Position& position, std::function<void(Position&)> f)
@@ -522,20 +855,18 @@ void MapGenerator::foreachDiagonalNeighbor(const Position& position,
 
 float MapGenerator::getNearestObjectDistance(const Position& position) const
 {
-    checkIsOnMap(position);
-
-    return tiles[posToIndex(position)].getNearestObjectDistance();
+    return getTile(position).getNearestObjectDistance();
 }
 
 void MapGenerator::setNearestObjectDistance(const Position& position, float value)
 {
-    checkIsOnMap(position);
-
-    tiles[posToIndex(position)].setNearestObjectDistance(value);
+    changeTile(position, [value](TileInfo& tile) { tile.setNearestObjectDistance(value); });
 }
 
 void MapGenerator::createRoads()
 {
+    RSG_PROFILE_SCOPE("MapGenerator::createRoads");
+
     const auto roadsPercentage{mapGenOptions.mapTemplate->settings.roads};
     if (roadsPercentage == 0) {
         // No roads at all, nothing to do here
@@ -545,6 +876,8 @@ void MapGenerator::createRoads()
     std::set<Position> roads;
 
     for (const auto& it : zones) {
+        checkCancelled();
+
         const auto& zoneRoads{it.second->getRoads()};
 
         for (const auto& roadInfo : zoneRoads) {
@@ -699,6 +1032,11 @@ CMidgardID MapGenerator::getSubraceId(RaceType race) const
 
 void MapGenerator::registerZone(RaceType race)
 {
+    if (currentFillBuffer) {
+        currentFillBuffer->defer([this, race](Map&) { registerZone(race); });
+        return;
+    }
+
     zonesPerRace[race]++;
     zonesTotal++;
 }
@@ -717,44 +1055,43 @@ const TileInfo& MapGenerator::getTile(const Position& position) const
 {
     checkIsOnMap(position);
 
-    return tiles[posToIndex(position)];
+    const auto index{posToIndex(position)};
+    // Other zones could be changing their tiles right now
+    return isOtherZoneTile(index) ? phaseTiles[index] : tiles[index];
 }
 
-TileInfo& MapGenerator::getTile(const Position& position)
+const Tile& MapGenerator::getMapTile(const Position& position) const
 {
     checkIsOnMap(position);
 
-    return tiles[posToIndex(position)];
+    const auto index{posToIndex(position)};
+    return isOtherZoneTile(index) ? phaseMapTiles[index] : map->getTile(position);
+}
+
+bool MapGenerator::canMoveBetween(const Position& source, const Position& destination) const
+{
+    const auto& sourceTile{getMapTile(source)};
+    const auto& destinationTile{getMapTile(destination)};
+
+    return map->checkForVisitableDir(source, destinationTile, destination)
+           && map->checkForVisitableDir(destination, sourceTile, source);
 }
 
 void MapGenerator::debugTiles(const char* fileName) const
 {
-    const auto mapSize{mapGenOptions.size};
+    const auto mapSize{static_cast<std::size_t>(mapGenOptions.size)};
+    std::vector<RgbColor> zones(mapSize * mapSize);
     std::vector<RgbColor> pixels(mapSize * mapSize);
 
-    for (int i = 0; i < mapSize; ++i) {
-        for (int j = 0; j < mapSize; ++j) {
-            const std::size_t index = i + mapSize * j;
-            const auto& tile{getTile({i, j})};
-
-            if (tile.isRoad()) {
-                pixels[index] = RgbColor(175, 175, 175); // grey
-            } else if (tile.isUsed()) {
-                pixels[index] = RgbColor(237, 177, 100); // yellow
-            } else if (tile.isBlocked()) {
-                pixels[index] = RgbColor(255, 0, 0); // red
-            } else if (tile.isFree()) {
-                pixels[index] = RgbColor(255, 255, 255); // white
-            } else if (tile.isPossible()) {
-                pixels[index] = RgbColor(255, 179, 185); // pink
-            } else {
-                pixels[index] = RgbColor(0, 0, 0); // black for all other
-            }
-        }
-    }
+    PreviewRasterizer rasterizer;
+    rasterizer.update(*this,
+                      PreviewImage{reinterpret_cast<std::uint8_t*>(zones.data()),
+                                   mapSize * sizeof(RgbColor)},
+                      PreviewImage{reinterpret_cast<std::uint8_t*>(pixels.data()),
+                                   mapSize * sizeof(RgbColor)});
 
-    Image zonesImage(mapSize, mapSize, pixels);
-    zonesImage.write(fileName);
+    Image tilesImage(mapSize, mapSize, std::move(pixels));
+    tilesImage.write(fileName);
 }
 
 } // namespace rsg
@@ -19,21 +19,36 @@
 
 #pragma once
 
+#include "forbiddenfilter.h"
 #include "gameinfo.h"
+#include "generationcontext.h"
+#include "generationprogress.h"
+#include "lootindex.h"
 #include "randomgenerator.h"
 #include "scenario/item.h"
 #include "scenario/map.h"
 #include "tileinfo.h"
+#include "unitindex.h"
+#include "vposition.h"
+#include "zonefillbuffer.h"
 #include "zoneplacer.h"
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <vector>
 
 namespace rsg {
 
 using PlayerSubraceIdPair = std::pair<CMidgardID /* player id */, CMidgardID /* subrace id */>;
 
+class CancellationToken;
 struct MapTemplate;
 
+// Largest scenario size generated in large map mode
+constexpr int maxLargeMapSize{1024};
+
 // Map generator options
 struct MapGenOptions
 {
@@ -43,58 +58,133 @@ struct MapGenOptions
     int size{48};
     WaterContent waterContent{WaterContent::Random};
     MonsterStrength monsterStrength{MonsterStrength::Random};
+    // Threads that fill zones in parallel, 0 fills zones one by one.
+    // Parallel fill produces the same scenario for any number of threads
+    std::size_t fillThreads{};
+    // Zones are filled using random streams derived from fill seed,
+    // 0 uses streams of scenario seed. Zone placement does not depend on it
+    std::uint64_t fillSeed{};
+    // Allows sizes above maxScenarioSize up to maxLargeMapSize.
+    // Zones are filled using algorithms that scale with map area,
+    // such scenarios can be generated and inspected but not saved
+    bool largeMap{};
 };
 
+// Generator state right after zones are placed.
+// Placement depends only on template contents, scenario size and seed,
+// so zones can be filled again from it with another fill seed.
+// Checkpoint is immutable and can be shared by generators in several threads
+struct GenerationCheckpoint
+{
+    struct Zone
+    {
+        TemplateZoneId id{};
+        VPosition center;
+        Position position;
+        std::set<Position> tiles;
+    };
+
+    std::vector<Zone> zones;
+    std::vector<TemplateZoneId> zoneColoring;
+    RandomGenerator randomGenerator;
+    int size{};
+};
+
+using GenerationCheckpointPtr = std::shared_ptr<const GenerationCheckpoint>;
+
 class MapGenerator
 {
 public:
-    MapGenerator(MapGenOptions& mapGenOptions,
+    MapGenerator(const GenerationContext& context,
+                 MapGenOptions& mapGenOptions,
                  time_t randomSeed = std::time(nullptr),
                  bool debug = false)
-        : mapGenOptions{mapGenOptions}
+        : context{context}
+        , mapGenOptions{mapGenOptions}
         , randomSeed{randomSeed}
         , debug{debug}
     {
         randomGenerator.setSeed(static_cast<std::size_t>(randomSeed));
     }
 
-    CMidgardID createId(CMidgardID::Type type)
+    const GenerationContext& getContext() const
     {
-        return map->createId(type);
+        return context;
     }
 
-    bool insertObject(std::unique_ptr<ScenarioObject>&& object)
+    // Token must outlive generation, nullptr disables cancellation
+    void setCancellationToken(const CancellationToken* token)
     {
-        return map->insertObject(std::move(object));
+        cancellation = token;
     }
 
-    bool insertObject(std::unique_ptr<Item>&& itemObject)
+    // Throws GenerationCancelledException if generation was cancelled
+    void checkCancelled() const;
+
+    void setProgressCallback(GenerationProgressCallback callback)
+    {
+        progressCallback = std::move(callback);
+    }
+
+    // Checks for cancellation and reports progress of specified phase
+    void reportProgress(GenerationPhase phase, std::size_t zone = 0, std::size_t zonesTotal = 0);
+
+    CMidgardID createId(CMidgardID::Type type);
+
+    bool insertObject(std::unique_ptr<ScenarioObject>&& object);
+    bool insertObject(std::unique_ptr<Item>&& itemObject);
+
+    void insertMapElement(const MapElement& mapElement, const CMidgardID& mapElementId);
+    void addMountain(const Position& position, const Position& size, int image);
+
+    // Returns object with specified id, including objects of currently filled zone
+    // that are not merged into the map yet
+    template <typename T>
+    T* find(const CMidgardID& objectId)
     {
-        // Add talisman charges each time we insert talisman item on the map
-        if (isTalisman(itemObject->getItemType())) {
-            map->addTalismanCharge(itemObject->getId());
+        if (auto buffer{getFillBuffer()}) {
+            if (auto object{buffer->find(objectId)}) {
+                return dynamic_cast<T*>(object);
+            }
         }
 
-        return map->insertObject(std::move(itemObject));
+        return map->find<T>(objectId);
     }
 
     void paintTerrain(const Position& position, TerrainType terrain, GroundType ground)
     {
-        map->paintTerrain(position, terrain, ground);
+        changeMapTile(position, [terrain, ground](Tile& tile) {
+            tile.setTerrainGround(terrain, ground);
+        });
     }
 
     void paintTerrain(const std::vector<Position>& tiles, TerrainType terrain, GroundType ground)
     {
-        map->paintTerrain(tiles, terrain, ground);
+        for (const auto& tile : tiles) {
+            paintTerrain(tile, terrain, ground);
+        }
     }
 
     PlayerSubraceIdPair createPlayer(RaceType race);
 
     MapPtr generate();
+    // Generates scenario using zone placement of a previous generator
+    // with the same template contents, size and seed. Skips zone placement entirely
+    MapPtr generate(const GenerationCheckpointPtr& placement);
 
+    // Returns zone placement of this generator, nullptr until zones are placed
+    const GenerationCheckpointPtr& getCheckpoint() const
+    {
+        return checkpoint;
+    }
+
+    void prepareGeneration();
+    MapPtr finishGeneration();
     void addHeaderInfo();
     void initTiles();
+    void createZones();
     void generateZones();
+    void restoreZones(const GenerationCheckpointPtr& placement);
     void fillZones();
     void setupDiplomacy();
     void createDirectConnections();
@@ -156,8 +246,12 @@ public:
     std::size_t getZoneCount(RaceType race);
     std::size_t getTotalZoneCount() const;
 
+    // Tiles are changed using changeTile only, so changes of other zone tiles are deferred
     const TileInfo& getTile(const Position& position) const;
-    TileInfo& getTile(const Position& position);
+
+    // Returns scenario map tile, other zone tiles are read from phaseMapTiles
+    const Tile& getMapTile(const Position& position) const;
+    bool canMoveBetween(const Position& source, const Position& destination) const;
 
     // Creates png image with specified filename where each pixel represents TileInfo
     void debugTiles(const char* fileName) const;
@@ -172,15 +266,76 @@ public:
         return debug;
     }
 
+    // Returns buffer of zone filled by current thread, nullptr if zones are not filled in parallel
+    static ZoneFillBuffer* getFillBuffer();
+
+    // Runs zone phase for each zone, one by one or in parallel.
+    // Reports progress after each zone if progress phase is specified
+    void forEachZone(void (TemplateZone::*phase)(),
+                     std::optional<GenerationPhase> progressPhase = std::nullopt);
+    void runParallelPhase(void (TemplateZone::*phase)(),
+                          std::optional<GenerationPhase> progressPhase);
+    void beginParallelFill();
+    void endParallelFill();
+
+    // Returns true if tile with specified index is read or changed from a zone being filled
+    // in parallel while belonging to another zone
+    bool isOtherZoneTile(std::size_t tileIndex) const;
+
+    // Changes tile, changes of other zone tiles are deferred until the end of a parallel phase
+    template <typename F>
+    void changeTile(const Position& position, F&& change)
+    {
+        checkIsOnMap(position);
+
+        const auto index{posToIndex(position)};
+        if (isOtherZoneTile(index)) {
+            getFillBuffer()->defer([this, index, change](Map&) { change(tiles[index]); });
+            return;
+        }
+
+        change(tiles[index]);
+    }
+
+    // Same as changeTile, but for scenario map tiles
+    template <typename F>
+    void changeMapTile(const Position& position, F&& change)
+    {
+        checkIsOnMap(position);
+
+        if (isOtherZoneTile(posToIndex(position))) {
+            getFillBuffer()->defer([position, change](Map& map) { change(map.getTile(position)); });
+            return;
+        }
+
+        change(map->getTile(position));
+    }
+
+    const GenerationContext& context;
     std::vector<TileInfo> tiles;
+    // Tiles at the start of a parallel phase, zones read tiles of other zones from here
+    std::vector<TileInfo> phaseTiles;
+    // Scenario map tiles at the start of a parallel phase, same as phaseTiles
+    std::vector<Tile> phaseMapTiles;
+    // One buffer per zone in zone id order, the last one creates ids between phases
+    std::vector<ZoneFillBuffer> fillBuffers;
     std::vector<TemplateZoneId> zoneColoring;
     ZonesMap zones;
     std::map<RaceType, std::size_t> zonesPerRace;
     std::map<RaceType, PlayerSubraceIdPair> raceToPlayers;
     MapPtr map;
+    // Built for current template at the start of generation
+    std::unique_ptr<ForbiddenFilter> forbidden;
+    std::unique_ptr<LootIndex> lootIndex;
+    std::unique_ptr<UnitIndex> unitIndex;
     RandomGenerator randomGenerator;
     MapGenOptions mapGenOptions;
+    GenerationCheckpointPtr checkpoint;
     time_t randomSeed;
+    const CancellationToken* cancellation{};
+    GenerationProgressCallback progressCallback;
+    // Zones filled in parallel report progress one at a time
+    std::mutex progressMutex;
     CMidgardID neutralPlayerId;
     CMidgardID neutralSubraceId;
     std::size_t zonesTotal{}; // Zones with capital town only
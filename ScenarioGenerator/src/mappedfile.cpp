@@ -0,0 +1,86 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mappedfile.h"
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+namespace rsg {
+
+MappedFile::MappedFile(const std::filesystem::path& filePath)
+{
+    HANDLE file{CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr)};
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        close();
+        return;
+    }
+
+    HANDLE mapping{CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+    if (!mapping) {
+        close();
+        return;
+    }
+
+    mappingHandle = mapping;
+
+    void* view{MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)};
+    if (!view) {
+        close();
+        return;
+    }
+
+    contents = static_cast<const std::uint8_t*>(view);
+    contentsSize = static_cast<std::size_t>(fileSize.QuadPart);
+}
+
+void MappedFile::close()
+{
+    if (contents) {
+        UnmapViewOfFile(contents);
+    }
+
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+    }
+
+    if (fileHandle) {
+        CloseHandle(fileHandle);
+    }
+
+    contents = nullptr;
+    contentsSize = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+} // namespace rsg
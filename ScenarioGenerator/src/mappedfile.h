@@ -0,0 +1,63 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace rsg {
+
+// Read-only file contents mapped into memory.
+// Pages are loaded by the system on first access
+class MappedFile
+{
+public:
+    MappedFile(const std::filesystem::path& filePath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    operator bool() const
+    {
+        return contents != nullptr;
+    }
+
+    const std::uint8_t* data() const
+    {
+        return contents;
+    }
+
+    std::size_t size() const
+    {
+        return contentsSize;
+    }
+
+private:
+    void close();
+
+    const std::uint8_t* contents{};
+    std::size_t contentsSize{};
+    void* fileHandle{};
+    void* mappingHandle{};
+};
+
+} // namespace rsg
@@ -900,6 +900,11 @@ MapTemplateSettings readTemplateSettings(const std::filesystem::path& templatePa
         throw TemplateException(err.what());
     }
 
+    return readTemplateSettings(lua);
+}
+
+MapTemplateSettings readTemplateSettings(const sol::state& lua)
+{
     MapTemplateSettings settings{};
     readSettings(settings, lua);
 
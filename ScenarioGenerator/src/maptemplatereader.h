@@ -37,6 +37,10 @@ void bindLuaApi(sol::state& lua);
 MapTemplateSettings readTemplateSettings(const std::filesystem::path& templatePath,
                                          sol::state& lua);
 
+// Reads settings of scenario template that was already executed in lua state.
+// Throws exception in case of errors.
+MapTemplateSettings readTemplateSettings(const sol::state& lua);
+
 // Executes 'getContents' function of scenario template (.lua) file.
 // Populates MapTemplateContents depending on actual MapTemplateSettings.
 // Throws exception in case of errors.
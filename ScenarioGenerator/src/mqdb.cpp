@@ -18,7 +18,10 @@
  */
 
 #include "mqdb.h"
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <limits>
 #include <stdexcept>
 
 namespace rsg {
@@ -363,6 +366,205 @@ bool Mqdb::getRecordData(const TocRecord& record, std::vector<char>& data)
     return true;
 }
 
+MappedMqdb::MappedMqdb(const std::filesystem::path& ffFilePath)
+    : file{ffFilePath}
+{
+    if (!file) {
+        throw std::runtime_error("Could not map MQDB file");
+    }
+
+    MqdbHeader header{};
+    std::memcpy(&header, getContents(0, sizeof(header)).data(), sizeof(header));
+
+    if (header.signature != mqdbFileSignature) {
+        throw std::runtime_error("Not a MQDB file");
+    }
+
+    if (header.version != mqdbFileVersion) {
+        throw std::runtime_error("Wrong MQDB file version");
+    }
+}
+
+const TocRecord* MappedMqdb::findTocRecord(RecordId recordId) const
+{
+    std::call_once(tableOfContentsRead, [this]() { readTableOfContents(); });
+
+    const auto it{tableOfContents.find(recordId)};
+
+    return it != tableOfContents.end() ? &it->second : nullptr;
+}
+
+const TocRecord* MappedMqdb::findTocRecord(std::string_view recordName) const
+{
+    std::call_once(nameListRead, [this]() { readNameList(); });
+
+    const auto it{recordNames.find(recordName)};
+    if (it == recordNames.end()) {
+        return nullptr;
+    }
+
+    // Check only the record that was asked for instead of touching every record header
+    auto record{findTocRecord(it->second)};
+    return record && getRecordHeader(*record).used ? record : nullptr;
+}
+
+std::string_view MappedMqdb::getRecordData(RecordId recordId) const
+{
+    auto record{findTocRecord(recordId)};
+    if (!record) {
+        return {};
+    }
+
+    return getContents(record->offset + sizeof(MqrcHeader), record->size);
+}
+
+std::string_view MappedMqdb::getRecordData(std::string_view recordName) const
+{
+    auto record{findTocRecord(recordName)};
+    if (!record) {
+        return {};
+    }
+
+    return getContents(record->offset + sizeof(MqrcHeader), record->size);
+}
+
+std::vector<std::string_view> MappedMqdb::getImageNames() const
+{
+    const std::string_view contents{getRecordData(indexOptRecordName)};
+    if (contents.empty()) {
+        // No index record present
+        return {};
+    }
+
+    const char* contentsPtr{contents.data()};
+
+    size_t byteOffset{};
+    // Nothing is read past the record, even if index is truncated or corrupt
+    auto checkRemaining = [&contents, &byteOffset](size_t bytes) {
+        if (contents.size() - byteOffset < bytes) {
+            throw std::runtime_error("MQDB index record is truncated");
+        }
+    };
+
+    checkRemaining(sizeof(std::uint32_t));
+    const auto total{readUint32(contentsPtr, byteOffset)};
+
+    // Id, empty name and packed image offset and size
+    constexpr size_t minEntrySize{3 * sizeof(std::uint32_t) + 1};
+
+    std::vector<std::string_view> names;
+    names.reserve(std::min<size_t>(total, contents.size() / minEntrySize));
+
+    for (std::uint32_t i = 0; i < total; ++i) {
+        checkRemaining(sizeof(std::uint32_t));
+        const RecordId id{readUint32(contentsPtr, byteOffset)};
+
+        const char* name = &contentsPtr[byteOffset];
+        const auto nameLength{strnlen(name, contents.size() - byteOffset)};
+
+        // +1 for null terminator, skip offset and size of packed image
+        const auto entryRest{nameLength + 1 + 2 * sizeof(std::uint32_t)};
+        checkRemaining(entryRest);
+        byteOffset += entryRest;
+
+        if (id != std::numeric_limits<RecordId>::max()) {
+            // Entry has valid id, this is an image entry
+            names.emplace_back(name, nameLength);
+        }
+    }
+
+    return names;
+}
+
+void MappedMqdb::readTableOfContents() const
+{
+    size_t byteOffset{};
+    const auto tocOffset{readUint32(getContents(sizeof(MqdbHeader), sizeof(std::uint32_t)).data(),
+                                    byteOffset)};
+
+    byteOffset = 0;
+    const auto entriesTotal{
+        readUint32(getContents(tocOffset, sizeof(std::uint32_t)).data(), byteOffset)};
+
+    const auto entries{
+        getContents(tocOffset + sizeof(std::uint32_t), entriesTotal * sizeof(TocRecord))};
+
+    tableOfContents.reserve(entriesTotal);
+
+    for (std::uint32_t i = 0; i < entriesTotal; ++i) {
+        TocRecord record{};
+        std::memcpy(&record, entries.data() + i * sizeof(TocRecord), sizeof(TocRecord));
+
+        if (!tableOfContents.try_emplace(record.recordId, record).second) {
+            throw std::runtime_error("MQDB ToC contains records with non-unique ids");
+        }
+    }
+}
+
+void MappedMqdb::readNameList() const
+{
+    auto namesList{findTocRecord(static_cast<RecordId>(SpecialId::NameList))};
+    if (!namesList) {
+        // MQDB file must contain name list record
+        throw std::runtime_error("Could not find MQDB names list ToC record");
+    }
+
+    const std::string_view contents{getRecordData(namesList->recordId)};
+    const char* contentsPtr{contents.data()};
+
+    size_t byteOffset{};
+    const auto namesTotal{readUint32(contentsPtr, byteOffset)};
+
+    constexpr std::size_t nameLength{256};
+    constexpr std::size_t entrySize{nameLength + sizeof(RecordId)};
+    if (sizeof(std::uint32_t) + namesTotal * entrySize > contents.size()) {
+        throw std::runtime_error("MQDB names list is truncated");
+    }
+
+    recordNames.reserve(namesTotal);
+
+    for (std::uint32_t i = 0; i < namesTotal; ++i) {
+        const char* name{&contentsPtr[byteOffset]};
+        byteOffset += nameLength;
+
+        const RecordId recordId{readUint32(contentsPtr, byteOffset)};
+
+        const std::string_view nameView{name, strnlen(name, nameLength - 1)};
+
+        auto [it, inserted] = recordNames.try_emplace(nameView, recordId);
+        if (inserted) {
+            continue;
+        }
+
+        // Duplicate names are rare, prefer the first used record among them the same way Mqdb does
+        auto existing{findTocRecord(it->second)};
+        if (!existing || !getRecordHeader(*existing).used) {
+            it->second = recordId;
+        }
+    }
+}
+
+const MqrcHeader& MappedMqdb::getRecordHeader(const TocRecord& record) const
+{
+    auto header{reinterpret_cast<const MqrcHeader*>(
+        getContents(record.offset, sizeof(MqrcHeader)).data())};
+
+    if (header->signature != mqrcSignature) {
+        throw std::runtime_error("Read wrong MQRC signature");
+    }
+
+    return *header;
+}
+
+std::string_view MappedMqdb::getContents(std::size_t offset, std::size_t size) const
+{
+    if (offset > file.size() || size > file.size() - offset) {
+        throw std::runtime_error("MQDB record is out of file bounds");
+    }
+
+    return std::string_view{reinterpret_cast<const char*>(file.data() + offset), size};
+}
+
 } // namespace mqdb
 
 } // namespace rsg
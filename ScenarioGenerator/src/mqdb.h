@@ -19,9 +19,12 @@
 
 #pragma once
 
+#include "mappedfile.h"
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -228,6 +231,63 @@ public:
     std::filesystem::path ffFilePath;
 };
 
+/**
+ * Read-only access to MQDB (.ff) file mapped into memory.
+ * Unlike Mqdb, nothing except file header is read on construction.
+ * Table of contents and names index are built on first use,
+ * record contents are returned as views into the mapping without copying.
+ * Views are valid while MappedMqdb object exists.
+ */
+class MappedMqdb
+{
+public:
+    /** Throws std::runtime_error exception if file could not be mapped or is not a MQDB file. */
+    MappedMqdb(const std::filesystem::path& ffFilePath);
+
+    /**
+     * Searches for table of contents record by specified id.
+     * @returns found record or nullptr.
+     */
+    const TocRecord* findTocRecord(RecordId recordId) const;
+
+    /** Searches for table of contents record of a used MQRC record by name. */
+    const TocRecord* findTocRecord(std::string_view recordName) const;
+
+    /** Returns record contents or empty view if record could not be found. */
+    std::string_view getRecordData(RecordId recordId) const;
+    std::string_view getRecordData(std::string_view recordName) const;
+
+    /** Returns names of images listed in '-INDEX.OPT' record, if present. */
+    std::vector<std::string_view> getImageNames() const;
+
+private:
+    /**
+     * Reads table of contents.
+     * Throws std::runtime_error exception in case of errors or duplicates.
+     */
+    void readTableOfContents() const;
+
+    /**
+     * Builds names index from names list record.
+     * Throws std::runtime_error exception in case of errors.
+     */
+    void readNameList() const;
+
+    /** Returns header of MQRC record or throws std::runtime_error if it is out of file bounds. */
+    const MqrcHeader& getRecordHeader(const TocRecord& record) const;
+
+    /** Returns view of file contents, throws std::runtime_error if it is out of file bounds. */
+    std::string_view getContents(std::size_t offset, std::size_t size) const;
+
+    MappedFile file;
+
+    mutable std::once_flag tableOfContentsRead;
+    mutable std::unordered_map<RecordId, TocRecord> tableOfContents;
+
+    mutable std::once_flag nameListRead;
+    mutable std::unordered_map<std::string_view, RecordId> recordNames;
+};
+
 } // namespace mqdb
 
 } // namespace rsg
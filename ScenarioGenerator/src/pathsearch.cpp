@@ -0,0 +1,119 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pathsearch.h"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace rsg {
+
+void PathSearch::begin(int size)
+{
+    mapSize = size;
+    closedTiles.clear();
+
+    if (++searchIndex == 0) {
+        // Index wrapped around, marks of old searches are not distinguishable anymore
+        std::fill(nodes.begin(), nodes.end(), Node{});
+        searchIndex = 1;
+    }
+}
+
+void PathSearch::close(const Position& position)
+{
+    auto& node{getNode(position)};
+    if (node.closed == searchIndex) {
+        return;
+    }
+
+    node.closed = searchIndex;
+    closedTiles.push_back(position);
+}
+
+void PathSearch::setDistance(const Position& position, float distance, const Position& cameFrom)
+{
+    auto& node{getNode(position)};
+
+    node.reached = searchIndex;
+    node.distance = distance;
+    node.cameFrom = cameFrom;
+}
+
+PathSearch::Node& PathSearch::getNode(const Position& position)
+{
+    if (!findNode(position)) {
+        grow(position);
+    }
+
+    return nodes[getNodeIndex(position)];
+}
+
+void PathSearch::grow(const Position& position)
+{
+    // Area is clamped to the map, tiles outside of it would be written past the nodes
+    if (position.x < 0 || position.x >= mapSize || position.y < 0 || position.y >= mapSize) {
+        std::stringstream stream;
+        stream << "Path search tile " << position << " is outside the map";
+
+        throw std::runtime_error(stream.str());
+    }
+
+    const bool empty{nodes.empty()};
+
+    Position newMin{empty ? position : areaMin};
+    Position newMax{empty ? position : areaMax};
+
+    newMin.x = std::min(newMin.x, position.x);
+    newMin.y = std::min(newMin.y, position.y);
+    newMax.x = std::max(newMax.x, position.x);
+    newMax.y = std::max(newMax.y, position.y);
+
+    // Grow with a margin, so area is not reallocated for each new tile
+    constexpr int minMargin{16};
+    const int margin{std::max(minMargin, std::max(newMax.x - newMin.x, newMax.y - newMin.y) / 2)};
+
+    newMin.x = std::max(0, newMin.x - margin);
+    newMin.y = std::max(0, newMin.y - margin);
+    newMax.x = std::min(mapSize - 1, newMax.x + margin);
+    newMax.y = std::min(mapSize - 1, newMax.y + margin);
+
+    const auto newWidth{static_cast<std::size_t>(newMax.x - newMin.x + 1)};
+    const auto newHeight{static_cast<std::size_t>(newMax.y - newMin.y + 1)};
+
+    std::vector<Node> newNodes(newWidth * newHeight);
+
+    if (!empty) {
+        const auto width{static_cast<std::size_t>(areaMax.x - areaMin.x + 1)};
+
+        for (int y = areaMin.y; y <= areaMax.y; ++y) {
+            const auto source{nodes.begin() + getNodeIndex(Position{areaMin.x, y})};
+            const auto destination{static_cast<std::size_t>(areaMin.x - newMin.x)
+                                   + static_cast<std::size_t>(y - newMin.y) * newWidth};
+
+            std::copy(source, source + width, newNodes.begin() + destination);
+        }
+    }
+
+    nodes.swap(newNodes);
+    areaMin = newMin;
+    areaMax = newMax;
+}
+
+} // namespace rsg
@@ -0,0 +1,114 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "position.h"
+#include <cstdint>
+#include <vector>
+
+namespace rsg {
+
+// Bookkeeping of a path search: visited tiles, distances and previous tiles of paths.
+// Keeps them in arrays covering searched area of the map instead of sets and maps,
+// area grows with the search and is reused by the next searches of the same zone
+class PathSearch
+{
+public:
+    // Starts new search, results of the previous one are forgotten
+    void begin(int mapSize);
+
+    bool isClosed(const Position& position) const
+    {
+        const auto node{findNode(position)};
+        return node && node->closed == searchIndex;
+    }
+
+    void close(const Position& position);
+
+    // Returns true and distance if position was reached in current search
+    bool getDistance(const Position& position, float& distance) const
+    {
+        const auto node{findNode(position)};
+        if (!node || node->reached != searchIndex) {
+            return false;
+        }
+
+        distance = node->distance;
+        return true;
+    }
+
+    // Returns tile the position was reached from, (-1 -1) for start of the search
+    Position getCameFrom(const Position& position) const
+    {
+        const auto node{findNode(position)};
+        return node && node->reached == searchIndex ? node->cameFrom : Position{-1, -1};
+    }
+
+    void setDistance(const Position& position, float distance, const Position& cameFrom);
+
+    // Tiles closed in current search, in order they were closed
+    const std::vector<Position>& getClosedTiles() const
+    {
+        return closedTiles;
+    }
+
+private:
+    struct Node
+    {
+        std::uint32_t reached{};
+        std::uint32_t closed{};
+        float distance{};
+        Position cameFrom;
+    };
+
+    const Node* findNode(const Position& position) const
+    {
+        if (position.x < areaMin.x || position.x > areaMax.x || position.y < areaMin.y
+            || position.y > areaMax.y) {
+            return nullptr;
+        }
+
+        return &nodes[getNodeIndex(position)];
+    }
+
+    Node& getNode(const Position& position);
+
+    std::size_t getNodeIndex(const Position& position) const
+    {
+        const auto width{static_cast<std::size_t>(areaMax.x - areaMin.x + 1)};
+
+        return static_cast<std::size_t>(position.x - areaMin.x)
+               + static_cast<std::size_t>(position.y - areaMin.y) * width;
+    }
+
+    // Grows area to contain specified position, keeping current search results
+    void grow(const Position& position);
+
+    std::vector<Node> nodes;
+    std::vector<Position> closedTiles;
+    // Area is empty until the first tile is reached
+    Position areaMin{0, 0};
+    Position areaMax{-1, -1};
+    int mapSize{};
+    // Nodes belong to current search only when marked with its index
+    std::uint32_t searchIndex{};
+};
+
+} // namespace rsg
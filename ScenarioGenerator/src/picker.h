@@ -20,34 +20,99 @@
 #pragma once
 
 #include "randomgenerator.h"
-#include <algorithm>
 #include <functional>
 #include <initializer_list>
+#include <iterator>
+#include <type_traits>
 #include <vector>
 
 namespace rsg {
 
+template <typename Iterator>
+using PoolElement = std::remove_pointer_t<typename std::iterator_traits<Iterator>::value_type>;
+
+template <typename T>
+using FilterList = std::initializer_list<std::function<bool(const T*)>>;
+
+// Returns true if element is not discarded by any of the filters.
+// Filters are evaluated in order, until first of them discards element
+template <typename T>
+bool isSuitable(const T* element, const FilterList<T>& filters)
+{
+    for (const auto& filter : filters) {
+        if (filter(element)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Picks random element from [begin : end) range that satisfies specified filters.
+// Each suitable element has the same chance to be picked.
+// Range is neither copied nor traversed twice: reservoir sampling keeps the chosen element
+// while filters are evaluated lazily for each element.
+// Returns nullptr if there are no suitable elements.
+template <typename Iterator>
+PoolElement<Iterator>* pick(Iterator begin,
+                            Iterator end,
+                            RandomGenerator& random,
+                            const FilterList<PoolElement<Iterator>>& filters)
+{
+    PoolElement<Iterator>* picked{};
+    std::size_t suitableTotal{};
+
+    for (auto it = begin; it != end; ++it) {
+        if (!isSuitable(*it, filters)) {
+            continue;
+        }
+
+        // N-th suitable element replaces the picked one with 1/N chance
+        ++suitableTotal;
+        if (suitableTotal == 1 || random.nextBounded(suitableTotal) == 0) {
+            picked = *it;
+        }
+    }
+
+    return picked;
+}
+
 // Picks random element from pool that satisfies specified filters.
 // Returns nullptr if there are no suitable elements.
 template <typename T>
-T* pick(const std::vector<T*>& pool,
-        RandomGenerator& random,
-        const std::initializer_list<std::function<bool(const T*)>>& filters)
+T* pick(const std::vector<T*>& pool, RandomGenerator& random, const FilterList<T>& filters)
 {
-    std::vector<T*> filteredPool{pool};
+    return pick(pool.cbegin(), pool.cend(), random, filters);
+}
 
-    for (auto& filter : filters) {
-        filteredPool.erase(std::remove_if(filteredPool.begin(), filteredPool.end(), filter),
-                           filteredPool.end());
+// Picks random element from several [first : second) iterator ranges.
+// Each element has the same chance to be picked, regardless of its range size.
+// Returns nullptr if all ranges are empty.
+template <typename RangeIterator>
+auto pickFromRanges(RangeIterator begin, RangeIterator end, RandomGenerator& random)
+    -> std::decay_t<decltype(*begin->first)>
+{
+    std::size_t elementsTotal{};
+    for (auto it = begin; it != end; ++it) {
+        elementsTotal += static_cast<std::size_t>(std::distance(it->first, it->second));
     }
 
-    if (filteredPool.empty()) {
-        // Filters are too tight, nothing to pick
+    if (!elementsTotal) {
         return nullptr;
     }
 
-    const std::size_t index{random.nextInteger(std::size_t{0}, filteredPool.size() - 1)};
-    return filteredPool[index];
+    // Single draw over all elements, then find the range it belongs to
+    std::size_t index{random.nextInteger(std::size_t{0}, elementsTotal - 1)};
+    for (auto it = begin; it != end; ++it) {
+        const auto size{static_cast<std::size_t>(std::distance(it->first, it->second))};
+        if (index < size) {
+            return *std::next(it->first, index);
+        }
+
+        index -= size;
+    }
+
+    return nullptr;
 }
 
 } // namespace rsg
@@ -0,0 +1,137 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "position.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace rsg {
+
+// Positions grouped into square cells covering the map,
+// so positions near a tile are found by checking a few nearby cells instead of all of them
+class PositionGrid
+{
+public:
+    PositionGrid(int mapSize, int cellSize)
+        : cellSize{cellSize}
+        , cellsPerSide{(mapSize + cellSize - 1) / cellSize}
+        , cells(static_cast<std::size_t>(cellsPerSide) * cellsPerSide)
+    { }
+
+    void insert(const Position& position)
+    {
+        cells[getCellIndex(position.x / cellSize, position.y / cellSize)].push_back(position);
+        ++positionsTotal;
+    }
+
+    bool empty() const
+    {
+        return positionsTotal == 0;
+    }
+
+    // Returns true if grid has a position with squared distance not greater than specified
+    bool hasPositionWithin(const Position& position, std::uint32_t distanceSquared) const
+    {
+        const auto radius{static_cast<int>(std::ceil(std::sqrt(distanceSquared)))};
+
+        const int minX{std::max(0, (position.x - radius) / cellSize)};
+        const int minY{std::max(0, (position.y - radius) / cellSize)};
+        const int maxX{std::min(cellsPerSide - 1, (position.x + radius) / cellSize)};
+        const int maxY{std::min(cellsPerSide - 1, (position.y + radius) / cellSize)};
+
+        for (int y = minY; y <= maxY; ++y) {
+            for (int x = minX; x <= maxX; ++x) {
+                for (const auto& other : cells[getCellIndex(x, y)]) {
+                    if (position.distanceSquared(other) <= distanceSquared) {
+                        return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
+    // Returns closest position or (-1, -1) if grid is empty
+    Position findClosest(const Position& position) const
+    {
+        Position result{-1, -1};
+        auto bestDistance{std::numeric_limits<std::uint32_t>::max()};
+
+        const int cellX{std::clamp(position.x / cellSize, 0, cellsPerSide - 1)};
+        const int cellY{std::clamp(position.y / cellSize, 0, cellsPerSide - 1)};
+
+        auto checkCell = [this, &position, &result, &bestDistance](int x, int y) {
+            if (x < 0 || x >= cellsPerSide || y < 0 || y >= cellsPerSide) {
+                return;
+            }
+
+            for (const auto& other : cells[getCellIndex(x, y)]) {
+                const auto distance{position.distanceSquared(other)};
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    result = other;
+                }
+            }
+        };
+
+        // Check rings of cells around the position
+        for (int ring = 0; ring < cellsPerSide && positionsTotal; ++ring) {
+            if (ring == 0) {
+                checkCell(cellX, cellY);
+            } else {
+                for (int x = cellX - ring; x <= cellX + ring; ++x) {
+                    checkCell(x, cellY - ring);
+                    checkCell(x, cellY + ring);
+                }
+
+                for (int y = cellY - ring + 1; y < cellY + ring; ++y) {
+                    checkCell(cellX - ring, y);
+                    checkCell(cellX + ring, y);
+                }
+            }
+
+            // Positions in the next rings are farther than ring * cellSize
+            const auto ringDistance{static_cast<std::uint32_t>(ring * cellSize)};
+            if (result.isValid() && bestDistance <= ringDistance * ringDistance) {
+                break;
+            }
+        }
+
+        return result;
+    }
+
+private:
+    std::size_t getCellIndex(int x, int y) const
+    {
+        return static_cast<std::size_t>(x) + static_cast<std::size_t>(cellsPerSide) * y;
+    }
+
+    int cellSize;
+    int cellsPerSide;
+    std::vector<std::vector<Position>> cells;
+    std::size_t positionsTotal{};
+};
+
+} // namespace rsg
@@ -0,0 +1,167 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "previewrasterizer.h"
+#include "image.h"
+#include "mapgenerator.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace rsg {
+
+static_assert(sizeof(RgbColor) == 3, "Color tables are copied into RGB images as is");
+
+// Tile colors of drawn tiles are never equal to it, so they are drawn again after reset
+static constexpr std::uint8_t notDrawn{0xff};
+static constexpr std::size_t zoneColorsTotal{256};
+
+// Index in tile colors table: tile type or road
+static std::uint8_t getTileColorIndex(const TileInfo& tile)
+{
+    static constexpr std::uint8_t road{4};
+    return tile.isRoad() ? road : static_cast<std::uint8_t>(tile.getTileType());
+}
+
+static std::uint8_t getZoneColorIndex(TemplateZoneId zoneId)
+{
+    return static_cast<std::uint8_t>(std::clamp<TemplateZoneId>(zoneId, 0, zoneColorsTotal - 1));
+}
+
+// clang-format off
+static const RgbColor tileColorTable[] = {
+    RgbColor{255, 255, 255}, // Free, white
+    RgbColor{255, 179, 185}, // Possible, pink
+    RgbColor{255, 0, 0},     // Blocked, red
+    RgbColor{237, 177, 100}, // Used, yellow
+    RgbColor{175, 175, 175}, // Road, grey
+};
+// clang-format on
+
+static const std::array<RgbColor, zoneColorsTotal>& getZoneColorTable()
+{
+    static const auto colors{[]() {
+        // clang-format off
+        static const RgbColor palette[] = {
+            RgbColor{255, 0, 0},        // red
+            RgbColor{0, 255, 0},        // green
+            RgbColor{0, 0, 255},        // blue
+            RgbColor{255, 255, 255},    // white
+            RgbColor{0, 0, 0},          // black
+            RgbColor{127, 127, 127},    // gray
+            RgbColor{255, 255, 0},      // yellow
+            RgbColor{0, 255, 255},      // cyan
+            RgbColor{255, 0, 255},      // magenta
+            RgbColor{255, 153, 0},      // orange
+            RgbColor{127, 0, 0},        // dark red
+            RgbColor{0, 127, 0},        // dark green
+            RgbColor{0, 0, 127},        // dark blue
+            RgbColor{64, 64, 64},       // dark gray
+            RgbColor{127, 127, 0},      // dark yellow
+            RgbColor{0, 127, 127},      // dark cyan
+            RgbColor{127, 0, 127},      // violet
+            RgbColor{127, 64, 0},       // brown
+        };
+        // clang-format on
+
+        std::array<RgbColor, zoneColorsTotal> table;
+        for (std::size_t i = 0; i < table.size(); ++i) {
+            if (i < std::size(palette)) {
+                table[i] = palette[i];
+            } else {
+                // Shades of gray for the rest of zones, from 32 to 242 and over again
+                constexpr std::size_t shadesTotal{22};
+                const auto shade{(i - std::size(palette)) % shadesTotal};
+                const auto c{static_cast<std::uint8_t>(32 + 10 * shade)};
+                table[i] = RgbColor{c, c, c};
+            }
+        }
+
+        return table;
+    }()};
+
+    return colors;
+}
+
+PreviewRect PreviewRasterizer::update(const MapGenerator& generator,
+                                      const PreviewImage& zonesImage,
+                                      const PreviewImage& tilesImage)
+{
+    const int mapSize{generator.mapGenOptions.size};
+    const auto tilesTotal{static_cast<std::size_t>(mapSize) * mapSize};
+
+    if (generator.tiles.size() < tilesTotal || generator.zoneColoring.size() < tilesTotal) {
+        // Tiles are not created yet
+        return {};
+    }
+
+    if (tileColors.size() != tilesTotal) {
+        zoneColors.assign(tilesTotal, 0);
+        tileColors.assign(tilesTotal, notDrawn);
+    }
+
+    const auto& zonesTable{getZoneColorTable()};
+
+    int minX{mapSize};
+    int minY{mapSize};
+    int maxX{-1};
+    int maxY{-1};
+
+    for (int y = 0; y < mapSize; ++y) {
+        const std::size_t rowStart{static_cast<std::size_t>(y) * mapSize};
+        std::uint8_t* zonesRow{zonesImage.pixels + y * zonesImage.stride};
+        std::uint8_t* tilesRow{tilesImage.pixels + y * tilesImage.stride};
+
+        for (int x = 0; x < mapSize; ++x) {
+            const std::size_t index{rowStart + x};
+            const auto zoneColor{getZoneColorIndex(generator.zoneColoring[index])};
+            const auto tileColor{getTileColorIndex(generator.tiles[index])};
+
+            if (zoneColor == zoneColors[index] && tileColor == tileColors[index]) {
+                continue;
+            }
+
+            zoneColors[index] = zoneColor;
+            tileColors[index] = tileColor;
+
+            std::memcpy(zonesRow + x * sizeof(RgbColor), &zonesTable[zoneColor], sizeof(RgbColor));
+            std::memcpy(tilesRow + x * sizeof(RgbColor), &tileColorTable[tileColor],
+                        sizeof(RgbColor));
+
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = y;
+        }
+    }
+
+    if (maxX < 0) {
+        return {};
+    }
+
+    return PreviewRect{minX, minY, maxX - minX + 1, maxY - minY + 1};
+}
+
+void PreviewRasterizer::reset()
+{
+    zoneColors.clear();
+    tileColors.clear();
+}
+
+} // namespace rsg
@@ -0,0 +1,72 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rsg {
+
+class MapGenerator;
+
+// Rectangle of map tiles
+struct PreviewRect
+{
+    bool isEmpty() const
+    {
+        return width <= 0 || height <= 0;
+    }
+
+    int x{};
+    int y{};
+    int width{};
+    int height{};
+};
+
+// Caller image with a 8 bit RGB pixel for each map tile.
+// Rows are 'stride' bytes apart, so padded rows of QImage can be written directly
+struct PreviewImage
+{
+    std::uint8_t* pixels{};
+    std::size_t stride{};
+};
+
+// Draws zones and tile states of generator into preview images row by row using color tables.
+// Remembers colors of drawn tiles, so each update writes only pixels of changed tiles
+class PreviewRasterizer
+{
+public:
+    // Images must be of map size. The first update after reset draws them completely.
+    // Returns rectangle of tiles changed since previous update, empty if nothing changed
+    PreviewRect update(const MapGenerator& generator,
+                       const PreviewImage& zonesImage,
+                       const PreviewImage& tilesImage);
+
+    // Forgets drawn tiles, next update draws whole images
+    void reset();
+
+private:
+    // Color table indices of drawn tiles
+    std::vector<std::uint8_t> zoneColors;
+    std::vector<std::uint8_t> tileColors;
+};
+
+} // namespace rsg
@@ -0,0 +1,355 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "profiler.h"
+
+#ifdef RSG_PROFILING
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <ostream>
+
+#ifdef RSG_TRACK_ALLOCATIONS
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace rsg {
+
+#ifdef RSG_TRACK_ALLOCATIONS
+// Plain data without constructor, usable from operator new at any time
+static thread_local AllocationCounters threadAllocations{};
+
+AllocationCounters& getThreadAllocations()
+{
+    return threadAllocations;
+}
+
+// Block size is stored before the memory given to caller to account it on delete
+static constexpr std::size_t allocationHeaderSize{alignof(std::max_align_t)};
+
+static void* trackedAllocate(std::size_t size) noexcept
+{
+    auto block{static_cast<unsigned char*>(std::malloc(size + allocationHeaderSize))};
+    if (!block) {
+        return nullptr;
+    }
+
+    *reinterpret_cast<std::size_t*>(block) = size;
+
+    auto& counters{threadAllocations};
+    ++counters.allocations;
+    counters.bytes += size;
+    counters.liveBytes += static_cast<std::int64_t>(size);
+    counters.peakLiveBytes = std::max(counters.peakLiveBytes, counters.liveBytes);
+
+    return block + allocationHeaderSize;
+}
+
+static void trackedFree(void* memory) noexcept
+{
+    if (!memory) {
+        return;
+    }
+
+    auto block{static_cast<unsigned char*>(memory) - allocationHeaderSize};
+    threadAllocations.liveBytes -= static_cast<std::int64_t>(
+        *reinterpret_cast<std::size_t*>(block));
+
+    std::free(block);
+}
+
+static void* trackedNew(std::size_t size)
+{
+    // Zero sized allocations must return distinct pointers
+    size = std::max(size, std::size_t{1});
+
+    for (;;) {
+        if (void* memory = trackedAllocate(size)) {
+            return memory;
+        }
+
+        auto handler{std::get_new_handler()};
+        if (!handler) {
+            throw std::bad_alloc{};
+        }
+
+        handler();
+    }
+}
+#endif
+
+
+static void writeJsonString(std::ostream& stream, const std::string& string)
+{
+    stream << '"';
+
+    for (const char c : string) {
+        switch (c) {
+        case '"':
+            stream << "\\\"";
+            break;
+        case '\\':
+            stream << "\\\\";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                stream << ' ';
+            } else {
+                stream << c;
+            }
+            break;
+        }
+    }
+
+    stream << '"';
+}
+
+Profiler& Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler()
+    : startTime{Clock::now()}
+{ }
+
+Profiler::ThreadEvents& Profiler::getThreadEvents()
+{
+    // Buffers are owned by profiler and outlive threads that recorded them
+    thread_local ThreadEvents* threadEvents{};
+
+    if (!threadEvents) {
+        std::lock_guard<std::mutex> lock{threadsMutex};
+
+        threads.push_back(std::make_unique<ThreadEvents>());
+        threadEvents = threads.back().get();
+        threadEvents->threadIndex = threads.size();
+    }
+
+    return *threadEvents;
+}
+
+void Profiler::record(const char* name,
+                      std::string&& detail,
+                      Clock::time_point start,
+                      Clock::time_point end,
+                      const ScopeAllocations& allocations)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    const std::int64_t startUs{duration_cast<microseconds>(start - startTime).count()};
+    const std::int64_t durationUs{duration_cast<microseconds>(end - start).count()};
+
+    auto& threadEvents{getThreadEvents()};
+
+    std::lock_guard<std::mutex> lock{threadEvents.mutex};
+    threadEvents.events.push_back(Event{name, std::move(detail), startUs, durationUs, allocations});
+}
+
+bool Profiler::writeTrace(const std::filesystem::path& traceFilePath) const
+{
+    std::ofstream stream(traceFilePath);
+    if (!stream) {
+        return false;
+    }
+
+    stream << "{\"traceEvents\":[";
+
+    bool first{true};
+
+    std::lock_guard<std::mutex> threadsLock{threadsMutex};
+    for (const auto& thread : threads) {
+        std::lock_guard<std::mutex> lock{thread->mutex};
+
+        for (const auto& event : thread->events) {
+            stream << (first ? "\n" : ",\n") << "{\"name\":\"" << event.name
+                   << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->threadIndex
+                   << ",\"ts\":" << event.start << ",\"dur\":" << event.duration;
+
+#ifdef RSG_TRACK_ALLOCATIONS
+            stream << ",\"args\":{\"allocations\":" << event.allocations.allocations
+                   << ",\"bytes\":" << event.allocations.bytes
+                   << ",\"peakBytes\":" << event.allocations.peakBytes;
+
+            if (!event.detail.empty()) {
+                stream << ",\"detail\":";
+                writeJsonString(stream, event.detail);
+            }
+
+            stream << '}';
+#else
+            if (!event.detail.empty()) {
+                stream << ",\"args\":{\"detail\":";
+                writeJsonString(stream, event.detail);
+                stream << '}';
+            }
+#endif
+
+            stream << '}';
+            first = false;
+        }
+    }
+
+    stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return static_cast<bool>(stream);
+}
+
+void Profiler::writeSummary(std::ostream& stream) const
+{
+    struct ScopeTotals
+    {
+        std::size_t calls{};
+        std::int64_t total{};
+        std::int64_t max{};
+        std::uint64_t allocations{};
+        std::uint64_t bytes{};
+        std::int64_t peakBytes{};
+    };
+
+    // Scope names are literals, same names from different translation units
+    // may have different addresses, so they are compared as strings
+    std::map<std::string, ScopeTotals> totals;
+
+    {
+        std::lock_guard<std::mutex> threadsLock{threadsMutex};
+        for (const auto& thread : threads) {
+            std::lock_guard<std::mutex> lock{thread->mutex};
+
+            for (const auto& event : thread->events) {
+                auto& scope{totals[event.name]};
+                ++scope.calls;
+                scope.total += event.duration;
+                scope.max = std::max(scope.max, event.duration);
+                scope.allocations += event.allocations.allocations;
+                scope.bytes += event.allocations.bytes;
+                scope.peakBytes = std::max(scope.peakBytes, event.allocations.peakBytes);
+            }
+        }
+    }
+
+    std::vector<std::pair<std::string, ScopeTotals>> sorted(totals.begin(), totals.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second.total > b.second.total;
+    });
+
+    constexpr double msInUs{1000.0};
+
+    stream << std::left << std::setw(40) << "Scope" << std::right << std::setw(10) << "Calls"
+           << std::setw(14) << "Total ms" << std::setw(14) << "Average ms" << std::setw(14)
+           << "Max ms";
+#ifdef RSG_TRACK_ALLOCATIONS
+    stream << std::setw(14) << "Allocations" << std::setw(14) << "Total KB" << std::setw(14)
+           << "Max peak KB";
+#endif
+    stream << '\n';
+
+    stream << std::fixed << std::setprecision(3);
+    for (const auto& [name, scope] : sorted) {
+        stream << std::left << std::setw(40) << name << std::right << std::setw(10)
+               << scope.calls << std::setw(14) << scope.total / msInUs << std::setw(14)
+               << scope.total / msInUs / scope.calls << std::setw(14) << scope.max / msInUs;
+#ifdef RSG_TRACK_ALLOCATIONS
+        constexpr double bytesInKb{1024.0};
+        stream << std::setw(14) << scope.allocations << std::setw(14) << scope.bytes / bytesInKb
+               << std::setw(14) << scope.peakBytes / bytesInKb;
+#endif
+        stream << '\n';
+    }
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> threadsLock{threadsMutex};
+    for (const auto& thread : threads) {
+        std::lock_guard<std::mutex> lock{thread->mutex};
+        thread->events.clear();
+    }
+}
+
+} // namespace rsg
+
+#ifdef RSG_TRACK_ALLOCATIONS
+// Replacements of global allocation functions.
+// Over-aligned allocations use library versions and are not counted
+void* operator new(std::size_t size)
+{
+    return rsg::trackedNew(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return rsg::trackedNew(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return rsg::trackedNew(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return rsg::trackedNew(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* memory) noexcept
+{
+    rsg::trackedFree(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    rsg::trackedFree(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    rsg::trackedFree(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    rsg::trackedFree(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    rsg::trackedFree(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    rsg::trackedFree(memory);
+}
+#endif // RSG_TRACK_ALLOCATIONS
+
+#endif // RSG_PROFILING
@@ -0,0 +1,185 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Scoped timers are compiled only when RSG_PROFILING is defined,
+// otherwise profiling macros expand to nothing.
+// RSG_TRACK_ALLOCATIONS additionally replaces global operator new and delete
+// to count allocations, allocated bytes and peak live memory of each scope
+#if defined(RSG_TRACK_ALLOCATIONS) && !defined(RSG_PROFILING)
+#error "RSG_TRACK_ALLOCATIONS requires RSG_PROFILING"
+#endif
+
+#ifdef RSG_PROFILING
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rsg {
+
+// Allocations made inside a scope by its own thread, including nested scopes
+struct ScopeAllocations
+{
+    std::uint64_t allocations{};
+    std::uint64_t bytes{};
+    // Maximum of live memory reached inside scope, relative to live memory at its start
+    std::int64_t peakBytes{};
+};
+
+#ifdef RSG_TRACK_ALLOCATIONS
+// Counters of the current thread, updated by global operator new and delete.
+// Memory freed by other thread than allocated it decreases live bytes of that thread
+struct AllocationCounters
+{
+    std::uint64_t allocations;
+    std::uint64_t bytes;
+    std::int64_t liveBytes;
+    std::int64_t peakLiveBytes;
+};
+
+AllocationCounters& getThreadAllocations();
+#endif
+
+// Collects time spent in named scopes from all threads.
+// Each thread records into its own buffer, results should be written
+// when no generation is running
+class Profiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static Profiler& instance();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // Name must be a string literal, detail is shown in trace only
+    void record(const char* name,
+                std::string&& detail,
+                Clock::time_point start,
+                Clock::time_point end,
+                const ScopeAllocations& allocations = {});
+
+    // Writes events in Chrome trace_event format,
+    // open it in chrome://tracing or ui.perfetto.dev
+    bool writeTrace(const std::filesystem::path& traceFilePath) const;
+    // Writes calls, total, average and max time of each scope, sorted by total time.
+    // With allocation tracking also writes allocations, allocated and max peak bytes
+    void writeSummary(std::ostream& stream) const;
+
+    void clear();
+
+private:
+    struct Event
+    {
+        const char* name;
+        std::string detail;
+        std::int64_t start; // Microseconds since profiler creation
+        std::int64_t duration;
+        ScopeAllocations allocations;
+    };
+
+    struct ThreadEvents
+    {
+        std::mutex mutex;
+        std::vector<Event> events;
+        std::size_t threadIndex{};
+    };
+
+    Profiler();
+
+    ThreadEvents& getThreadEvents();
+
+    const Clock::time_point startTime;
+    mutable std::mutex threadsMutex;
+    std::vector<std::unique_ptr<ThreadEvents>> threads;
+};
+
+// Records time between construction and destruction
+class ProfileScope
+{
+public:
+    // Profiler is created before the first scope starts, so times are never negative
+    explicit ProfileScope(const char* name, std::string&& detail = {})
+        : profiler{Profiler::instance()}
+        , name{name}
+        , detail{std::move(detail)}
+        , start{Profiler::Clock::now()}
+    {
+#ifdef RSG_TRACK_ALLOCATIONS
+        auto& counters{getThreadAllocations()};
+        startAllocations = counters;
+        // Peak is measured from the scope start, outer peak is restored on exit
+        counters.peakLiveBytes = counters.liveBytes;
+#endif
+    }
+
+    ~ProfileScope()
+    {
+        const auto end{Profiler::Clock::now()};
+
+        ScopeAllocations allocations;
+#ifdef RSG_TRACK_ALLOCATIONS
+        auto& counters{getThreadAllocations()};
+        allocations.allocations = counters.allocations - startAllocations.allocations;
+        allocations.bytes = counters.bytes - startAllocations.bytes;
+        allocations.peakBytes = counters.peakLiveBytes - startAllocations.liveBytes;
+        counters.peakLiveBytes = std::max(counters.peakLiveBytes, startAllocations.peakLiveBytes);
+#endif
+
+        profiler.record(name, std::move(detail), start, end, allocations);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profiler& profiler;
+    const char* name;
+    std::string detail;
+    Profiler::Clock::time_point start;
+#ifdef RSG_TRACK_ALLOCATIONS
+    AllocationCounters startAllocations{};
+#endif
+};
+
+} // namespace rsg
+
+#define RSG_PROFILE_CONCAT_IMPL(a, b) a##b
+#define RSG_PROFILE_CONCAT(a, b) RSG_PROFILE_CONCAT_IMPL(a, b)
+#define RSG_PROFILE_SCOPE(name)                                                                    \
+    ::rsg::ProfileScope RSG_PROFILE_CONCAT(profileScope, __LINE__)(name)
+// Detail expression is not evaluated when profiling is disabled
+#define RSG_PROFILE_SCOPE_DETAIL(name, detail)                                                     \
+    ::rsg::ProfileScope RSG_PROFILE_CONCAT(profileScope, __LINE__)(name, detail)
+
+#else
+
+#define RSG_PROFILE_SCOPE(name)
+#define RSG_PROFILE_SCOPE_DETAIL(name, detail)
+
+#endif // RSG_PROFILING
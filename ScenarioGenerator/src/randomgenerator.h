@@ -19,14 +19,15 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <ctime>
 #include <functional>
-#include <numeric>
-#include <random>
+#include <limits>
 #include <thread>
 #include <type_traits>
+#include <unordered_set>
 #include <vector>
 
 namespace rsg {
@@ -54,58 +55,139 @@ struct RandomValue
     }
 };
 
+// SplitMix64 generator.
+// Its state is a plain counter, so independent streams are derived by mixing stream ids into seed
+class SplitMix64
+{
+public:
+    using result_type = std::uint64_t;
+
+    static constexpr std::uint64_t gamma{0x9e3779b97f4a7c15ull};
+
+    explicit SplitMix64(std::uint64_t seed = 0)
+        : state{seed}
+    { }
+
+    static constexpr result_type min()
+    {
+        return std::numeric_limits<result_type>::min();
+    }
+
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    // Scrambles bits of specified value, used for output and for stream seeds
+    static constexpr std::uint64_t mix(std::uint64_t value)
+    {
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+
+    void seed(std::uint64_t value)
+    {
+        state = value;
+    }
+
+    result_type operator()()
+    {
+        state += gamma;
+        return mix(state);
+    }
+
+private:
+    std::uint64_t state;
+};
+
 class RandomGenerator
 {
 public:
-    using RandI64 = std::function<std::int64_t()>;
-    using Rand = std::function<double()>;
-    using Engine = std::mt19937;
+    using Engine = SplitMix64;
 
     RandomGenerator()
     {
         resetSeed();
     }
 
+    explicit RandomGenerator(std::uint64_t seed)
+    {
+        setSeed(seed);
+    }
+
     // Returns random integer value according to its range
     template <typename T, std::enable_if_t<std::is_integral<T>::value, bool> = true>
     T pickValue(const RandomValue<T>& value)
     {
-        return static_cast<T>(getInt64Range(value.min, value.max)());
+        return nextInteger(value.min, value.max);
     }
 
     // Returns floating point value according to its range
     template <typename T, std::enable_if_t<std::is_floating_point<T>::value, bool> = true>
     T pickValue(const RandomValue<T>& value)
     {
-        return static_cast<T>(getDoubleRange(value.min, value.max)());
+        return static_cast<T>(nextDouble(value.min, value.max));
     }
 
-    // Returns functor that produces random integer values in [min : max] range
-    RandI64 getInt64Range(std::int64_t min, std::int64_t max)
+    // Returns random integer value in [min : max] range
+    template <typename T, std::enable_if_t<std::is_integral<T>::value, bool> = true>
+    T nextInteger(T min, T max)
     {
-        using Distribution = std::uniform_int_distribution<std::int64_t>;
+        assert(min <= max);
 
-        return std::bind(Distribution(min, max), std::ref(engine));
-    }
+        // Computed in 64-bit unsigned domain, narrow signed types are not promoted to int.
+        // Signed values convert modulo 2^64, so difference is correct for any integral type
+        const std::uint64_t range{static_cast<std::uint64_t>(max)
+                                  - static_cast<std::uint64_t>(min)};
+        // Range of full 64-bit type overflows to 0, nextBounded handles it
+        const auto offset{nextBounded(range + 1)};
 
-    // Returns functor that produces random floating point values in [min : max] range
-    Rand getDoubleRange(double min, double max)
-    {
-        using Distribution = std::uniform_real_distribution<double>;
-
-        return std::bind(Distribution(min, max), std::ref(engine));
+        return static_cast<T>(static_cast<std::uint64_t>(min) + offset);
     }
 
-    template <typename T, std::enable_if_t<std::is_integral<T>::value, bool> = true>
-    T nextInteger(T min, T max)
+    // Returns random integer value in [0 : bound) range, zero bound stands for 2^64.
+    // Uses Lemire's multiply-and-shift method, division only happens for rare rejections
+    std::uint64_t nextBounded(std::uint64_t bound)
     {
-        return static_cast<T>(getInt64Range(min, max)());
+        if (!bound) {
+            return engine();
+        }
+
+        if (bound <= std::numeric_limits<std::uint32_t>::max()) {
+            const auto bound32{static_cast<std::uint32_t>(bound)};
+
+            std::uint64_t product{(engine() >> 32) * bound};
+            auto low{static_cast<std::uint32_t>(product)};
+            if (low < bound32) {
+                const std::uint32_t threshold{(0u - bound32) % bound32};
+                while (low < threshold) {
+                    product = (engine() >> 32) * bound;
+                    low = static_cast<std::uint32_t>(product);
+                }
+            }
+
+            return product >> 32;
+        }
+
+        // Wide ranges are rare, plain rejection sampling is enough for them
+        const std::uint64_t threshold{(0 - bound) % bound};
+
+        std::uint64_t value{engine()};
+        while (value < threshold) {
+            value = engine();
+        }
+
+        return value % bound;
     }
 
-    // Returns random floating point value in [min : max] range
+    // Returns random floating point value in [min : max) range
     double nextDouble(double min, double max)
     {
-        return getDoubleRange(min, max)();
+        // Top 53 bits fill double mantissa
+        const double unit{static_cast<double>(engine() >> 11) * 0x1.0p-53};
+
+        return min + (max - min) * unit;
     }
 
     // Returns true with chance specified by percent
@@ -115,6 +197,13 @@ public:
         return nextDouble(0, 99) < percent;
     }
 
+    // Returns independent generator for specified stream, for example zone or generation phase.
+    // Stream depends only on seed and stream id, not on values generated so far
+    RandomGenerator getStream(std::uint64_t streamId) const
+    {
+        return RandomGenerator{SplitMix64::mix(seed ^ SplitMix64::mix(streamId + Engine::gamma))};
+    }
+
     void resetSeed()
     {
         auto threadId{std::this_thread::get_id()};
@@ -123,9 +212,10 @@ public:
         setSeed(threadIdHash * (std::size_t)std::time(nullptr));
     }
 
-    void setSeed(std::size_t seed)
+    void setSeed(std::uint64_t value)
     {
-        engine.seed(seed);
+        seed = value;
+        engine.seed(value);
     }
 
     Engine& getEngine()
@@ -135,6 +225,7 @@ public:
 
 private:
     Engine engine;
+    std::uint64_t seed{};
 };
 
 // Reorders elements in container randomly.
@@ -144,30 +235,38 @@ static inline void randomShuffle(std::vector<T>& container, RandomGenerator& ran
     std::shuffle(container.begin(), container.end(), rand.getEngine());
 }
 
-// Returns a randomly chosen vector of n positive integers summing exactly to total
-// From:
-// https://stackoverflow.com/questions/3589214/generate-random-numbers-summing-to-a-predefined-value
+// Returns a randomly chosen vector of n positive integers summing exactly to total.
+// Dividers are sampled from [1 : total] range using Floyd's algorithm,
+// so the work depends only on n and not on total
 static inline std::vector<std::size_t> constrainedSum(std::size_t n,
                                                       std::size_t total,
                                                       RandomGenerator& rand)
 {
-    std::vector<std::size_t> tmp(total);
-    std::iota(tmp.begin(), tmp.end(), 1);
+    const std::size_t dividersTotal{std::min(n - 1, total)};
 
-    std::vector<std::size_t> dividers;
-    std::sample(tmp.begin(), tmp.end(), std::back_inserter(dividers), n - 1, rand.getEngine());
+    std::unordered_set<std::size_t> picked;
+    picked.reserve(dividersTotal);
 
-    std::sort(dividers.begin(), dividers.end());
+    for (std::size_t i = total - dividersTotal + 1; i <= total; ++i) {
+        const auto divider{rand.nextInteger(std::size_t{1}, i)};
 
-    std::vector<std::size_t> a = dividers;
-    a.push_back(total);
-
-    std::vector<std::size_t> b = dividers;
-    b.insert(b.begin(), 0);
+        // Already picked, use i instead. Dividers picked so far are all less than i
+        picked.insert(picked.count(divider) ? i : divider);
+    }
 
+    // Dividers are sorted once, set order does not matter
     std::vector<std::size_t> result;
-    for (std::size_t i = 0; i < a.size(); ++i) {
-        result.push_back(a[i] - b[i]);
+    result.reserve(dividersTotal + 1);
+    result.assign(picked.begin(), picked.end());
+    std::sort(result.begin(), result.end());
+    result.push_back(total);
+
+    // Turn dividers into distances between them
+    std::size_t previous{};
+    for (auto& value : result) {
+        const auto divider{value};
+        value -= previous;
+        previous = divider;
     }
 
     return result;
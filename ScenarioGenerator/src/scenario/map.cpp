@@ -26,6 +26,7 @@
 #include "mountains.h"
 #include "plan.h"
 #include "player.h"
+#include "profiler.h"
 #include "questlog.h"
 #include "scenarioinfo.h"
 #include "scenariovariables.h"
@@ -37,6 +38,7 @@
 #include "turnsummary.h"
 #include <cassert>
 #include <sstream>
+#include <stdexcept>
 
 namespace rsg {
 
@@ -84,6 +86,14 @@ Map::Map()
 
 void Map::serialize(const std::filesystem::path& scenarioFilePath)
 {
+    RSG_PROFILE_SCOPE("Map::serialize");
+
+    if (size > maxScenarioSize) {
+        throw std::runtime_error("Scenario of size " + std::to_string(size)
+                                 + " can not be saved, game supports sizes up to "
+                                 + std::to_string(maxScenarioSize));
+    }
+
     Serializer serializer{scenarioFilePath};
 
     std::vector<RaceType> races;
@@ -94,8 +104,6 @@ void Map::serialize(const std::filesystem::path& scenarioFilePath)
         races.push_back(getRaceType(player->getRace()));
     });
 
-    const GameInfo* info{getGameInfo()};
-
     // Populate scenario info
     for (std::size_t i = 0; i < races.size(); ++i) {
         scenarioInfo->addPlayer(i, races[i]);
@@ -142,12 +150,21 @@ void Map::calculateGuardingCreaturePositions()
 
 CMidgardID Map::createId(CMidgardID::Type type)
 {
-    auto freeTypeIndex{freeIdTypeIndices[static_cast<std::size_t>(type)]++};
-    assert(freeTypeIndex >= 0 && freeTypeIndex <= std::numeric_limits<std::uint16_t>::max());
+    return createId(type, freeIdTypeIndices[static_cast<std::size_t>(type)]++);
+}
+
+CMidgardID Map::createId(CMidgardID::Type type, int typeIndex) const
+{
+    assert(typeIndex >= 0);
+
+    if (typeIndex > maxIdTypeIndex) {
+        throw std::runtime_error("Scenario has too many objects of type "
+                                 + std::to_string(static_cast<int>(type)));
+    }
 
     return CMidgardID{CMidgardID::Category::Scenario,
                       static_cast<std::uint8_t>(scenarioId.getCategoryIndex()), type,
-                      static_cast<std::uint16_t>(freeTypeIndex)};
+                      static_cast<std::uint16_t>(typeIndex)};
 }
 
 bool Map::insertObject(ScenarioObjectPtr&& object)
@@ -68,6 +68,11 @@ struct Tile
     bool blocked{};
 };
 
+// Largest scenario size supported by the game and scenario file format
+constexpr int maxScenarioSize{144};
+// Largest type index of scenario object ids
+constexpr int maxIdTypeIndex{0xffff};
+
 struct MapHeader
 {
     MapHeader() = default;
@@ -92,6 +97,20 @@ public:
     void calculateGuardingCreaturePositions();
 
     CMidgardID createId(CMidgardID::Type type);
+    // Creates id of specified type with specified type index, free indices are not changed.
+    // Throws std::runtime_error if index is above maxIdTypeIndex
+    CMidgardID createId(CMidgardID::Type type, int typeIndex) const;
+
+    // Returns type index that will be used for the next id of specified type
+    int getFreeIdIndex(CMidgardID::Type type) const
+    {
+        return freeIdTypeIndices[static_cast<std::size_t>(type)];
+    }
+
+    void setFreeIdIndex(CMidgardID::Type type, int typeIndex)
+    {
+        freeIdTypeIndices[static_cast<std::size_t>(type)] = typeIndex;
+    }
 
     bool insertObject(ScenarioObjectPtr&& object);
     void insertMapElement(const MapElement& mapElement, const CMidgardID& mapElementId);
@@ -146,6 +165,12 @@ public:
     const Tile& getTile(const Position& position) const;
     Tile& getTile(const Position& position);
 
+    // Returns all tiles, row by row
+    const std::vector<Tile>& getTiles() const
+    {
+        return tiles;
+    }
+
     bool canMoveBetween(const Position& source, const Position& destination) const;
     bool checkForVisitableDir(const Position& source,
                               const Tile& tile,
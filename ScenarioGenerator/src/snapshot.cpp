@@ -0,0 +1,59 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "snapshot.h"
+#include <fstream>
+#include <random>
+
+namespace rsg {
+
+bool writeSnapshotFile(const std::filesystem::path& snapshotPath, const SnapshotWriter& writer)
+{
+    std::filesystem::path temporaryPath{snapshotPath};
+    temporaryPath += "." + std::to_string(std::random_device{}()) + ".tmp";
+
+    bool written{};
+    {
+        std::ofstream stream(temporaryPath, std::ios_base::binary);
+        if (!stream) {
+            return false;
+        }
+
+        stream.write(writer.data.data(), writer.data.size());
+        stream.close();
+        written = static_cast<bool>(stream);
+    }
+
+    std::error_code error;
+    if (!written) {
+        // Do not leave partially written file behind
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    std::filesystem::rename(temporaryPath, snapshotPath, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace rsg
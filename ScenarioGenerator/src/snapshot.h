@@ -0,0 +1,168 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "rsgid.h"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace rsg {
+
+// Binary snapshots of data that is expensive to compute, stored between runs.
+// Values are written as is, snapshots are not portable between builds
+class SnapshotWriter
+{
+public:
+    template <typename T>
+    void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        const auto bytes{reinterpret_cast<const char*>(&value)};
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+
+    void write(const std::string& string)
+    {
+        write(static_cast<std::uint32_t>(string.size()));
+        data.insert(data.end(), string.begin(), string.end());
+    }
+
+    void write(const CMidgardID& id)
+    {
+        write(id.getValue());
+    }
+
+    template <typename T>
+    void write(const std::set<T>& set)
+    {
+        write(static_cast<std::uint32_t>(set.size()));
+        for (const auto& element : set) {
+            write(element);
+        }
+    }
+
+    template <typename T>
+    void write(const std::vector<T>& array)
+    {
+        write(static_cast<std::uint32_t>(array.size()));
+        for (const auto& element : array) {
+            write(element);
+        }
+    }
+
+    std::vector<char> data;
+};
+
+// Reads snapshot contents directly from file mapping.
+// Throws std::runtime_error if snapshot is truncated
+class SnapshotReader
+{
+public:
+    SnapshotReader(const std::uint8_t* data, std::size_t size)
+        : data{data}
+        , size{size}
+    { }
+
+    template <typename T>
+    void read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        std::memcpy(&value, advance(sizeof(T)), sizeof(T));
+    }
+
+    void read(std::string& string)
+    {
+        const std::uint32_t length{readCount()};
+        string.assign(reinterpret_cast<const char*>(advance(length)), length);
+    }
+
+    void read(CMidgardID& id)
+    {
+        std::uint32_t value{};
+        read(value);
+        id = CMidgardID{value};
+    }
+
+    template <typename T>
+    void read(std::set<T>& set)
+    {
+        const std::uint32_t count{readCount()};
+        for (std::uint32_t i = 0; i < count; ++i) {
+            T element{};
+            read(element);
+            set.insert(set.end(), element);
+        }
+    }
+
+    template <typename T>
+    void read(std::vector<T>& array)
+    {
+        const std::uint32_t count{readCount()};
+        array.resize(count);
+        for (auto& element : array) {
+            read(element);
+        }
+    }
+
+    std::uint32_t readCount()
+    {
+        std::uint32_t count{};
+        read(count);
+        return count;
+    }
+
+    template <typename T>
+    T readValue()
+    {
+        T value{};
+        read(value);
+        return value;
+    }
+
+private:
+    const std::uint8_t* advance(std::size_t length)
+    {
+        if (length > size - offset) {
+            throw std::runtime_error("Snapshot is truncated");
+        }
+
+        const std::uint8_t* current{data + offset};
+        offset += length;
+        return current;
+    }
+
+    const std::uint8_t* data;
+    std::size_t size;
+    std::size_t offset{};
+};
+
+// Writes snapshot contents to specified file.
+// Temporary file is written first, other processes could read snapshot at the same time
+bool writeSnapshotFile(const std::filesystem::path& snapshotPath, const SnapshotWriter& writer);
+
+} // namespace rsg
@@ -20,10 +20,12 @@
 #pragma once
 
 #include "enums.h"
+#include <cstddef>
 
 namespace rsg {
 
 class CMidgardID;
+class GameInfo;
 
 // Information about spell from GSpells.dbf
 class SpellInfo
@@ -38,8 +40,19 @@ public:
 
     virtual int getLevel() const = 0;
 
+    // Returns stable index of spell in game catalog
+    std::size_t getCatalogIndex() const
+    {
+        return catalogIndex;
+    }
+
 protected:
     SpellInfo() = default;
+
+private:
+    friend void assignCatalogIndices(GameInfo& gameInfo);
+
+    std::size_t catalogIndex{};
 };
 
 } // namespace rsg
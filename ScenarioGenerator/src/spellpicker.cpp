@@ -18,45 +18,37 @@
  */
 
 #include "spellpicker.h"
-#include "containers.h"
-#include "gameinfo.h"
-#include "generatorsettings.h"
-#include "randomgenerator.h"
+#include "generationcontext.h"
+#include "picker.h"
+#include <limits>
 
 namespace rsg {
 
-static SpellInfo* pickSpell(const SpellInfoArray& spellsPool,
-                            RandomGenerator& random,
-                            const SpellFilterList& filters)
+SpellInfo* pickSpell(const GenerationContext& context,
+                     RandomGenerator& random,
+                     const SpellFilterList& filters)
 {
-    SpellInfoArray pool{spellsPool};
-
-    for (auto& filter : filters) {
-        pool.erase(std::remove_if(pool.begin(), pool.end(), filter), pool.end());
-    }
-
-    if (pool.empty()) {
-        // Filters are too tight, nothing to pick
-        return nullptr;
-    }
-
-    const auto index{static_cast<std::size_t>(random.getInt64Range(0, pool.size() - 1)())};
-    return pool[index];
+    return pick(context.getCatalog().getSpells(), random, filters);
 }
 
-SpellInfo* pickSpell(RandomGenerator& random, const SpellFilterList& filters)
+SpellInfo* pickSpell(const GenerationContext& context,
+                     SpellType spellType,
+                     RandomGenerator& random,
+                     const SpellFilterList& filters)
 {
-    return pickSpell(getGameInfo()->getSpells(), random, filters);
+    return pick(context.getCatalog().getSpells(spellType), random, filters);
 }
 
-SpellInfo* pickSpell(SpellType spellType, RandomGenerator& random, const SpellFilterList& filters)
+SpellInfo* pickSpell(const GenerationContext& context,
+                     int maxValue,
+                     RandomGenerator& random,
+                     const SpellFilterList& filters)
 {
-    return pickSpell(getGameInfo()->getSpells(spellType), random, filters);
-}
+    const auto& spells{context.getCatalog().getSpells()};
+    // Spells are sorted by value, skip expensive ones without checking filters
+    const auto [begin, end] = getValueRange(spells, std::numeric_limits<int>::min(), maxValue);
 
-bool noForbiddenSpell(const SpellInfo* info)
-{
-    return contains(getGeneratorSettings().forbiddenSpells, info->getSpellId());
+    return pick(begin, end, random, filters);
 }
 
 } // namespace rsg
@@ -25,6 +25,7 @@
 
 namespace rsg {
 
+class GenerationContext;
 class SpellInfo;
 class RandomGenerator;
 
@@ -34,13 +35,18 @@ using SpellFilterFunc = std::function<bool(const SpellInfo*)>;
 using SpellFilterList = std::initializer_list<SpellFilterFunc>;
 
 // Picks any random spell after applying filters
-SpellInfo* pickSpell(RandomGenerator& random, const SpellFilterList& filters);
+SpellInfo* pickSpell(const GenerationContext& context,
+                     RandomGenerator& random,
+                     const SpellFilterList& filters);
 // Picks random spell of specific type
-SpellInfo* pickSpell(SpellType spellType, RandomGenerator& random, const SpellFilterList& filters);
-
-// These below are predefined filters
-
-// Remove spells that are forbidden in generator settings from pick
-bool noForbiddenSpell(const SpellInfo* info);
+SpellInfo* pickSpell(const GenerationContext& context,
+                     SpellType spellType,
+                     RandomGenerator& random,
+                     const SpellFilterList& filters);
+// Picks random spell with value not greater than maxValue
+SpellInfo* pickSpell(const GenerationContext& context,
+                     int maxValue,
+                     RandomGenerator& random,
+                     const SpellFilterList& filters);
 
 } // namespace rsg
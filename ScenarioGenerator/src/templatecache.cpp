@@ -0,0 +1,391 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "templatecache.h"
+#include "exceptions.h"
+#include "mappedfile.h"
+#include "maptemplatereader.h"
+#include "snapshot.h"
+#include <cstdio>
+#include <fstream>
+#include <lua.hpp>
+#include <sol/sol.hpp>
+
+namespace rsg {
+
+// Increase version each time layout or meaning of stored data changes
+static constexpr std::uint32_t entrySignature{0x54475352}; // 'RSGT'
+static constexpr std::uint32_t entryVersion{1};
+
+// Registry table with hashes of modules loaded through the cache, in load order
+static const char modulesKey[] = "rsgTemplateCacheModules";
+
+static std::string readFile(const std::filesystem::path& file)
+{
+    std::ifstream stream(file, std::ios_base::binary);
+    return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+// FNV-1a, stays the same between runs and builds
+static std::uint64_t hashBytes(std::uint64_t hash, const char* bytes, std::size_t length)
+{
+    for (std::size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<std::uint8_t>(bytes[i]);
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+static std::uint64_t getSourceHash(const std::string& chunkName, const std::string& source)
+{
+    // Chunk name is a part of bytecode debug info
+    const auto hash{hashBytes(0xcbf29ce484222325ull, chunkName.c_str(), chunkName.size() + 1)};
+    return hashBytes(hash, source.data(), source.size());
+}
+
+static std::uint64_t combineHash(std::uint64_t seed, std::uint64_t value)
+{
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+static int writeBytecode(lua_State*, const void* data, std::size_t size, void* userData)
+{
+    static_cast<std::string*>(userData)->append(static_cast<const char*>(data), size);
+    return 0;
+}
+
+static void writeSettings(SnapshotWriter& writer, const MapTemplateSettings& settings)
+{
+    writer.write(settings.forbiddenUnits);
+    writer.write(settings.forbiddenItems);
+    writer.write(settings.forbiddenSpells);
+    writer.write(settings.races);
+    writer.write(settings.name);
+    writer.write(settings.description);
+    writer.write(settings.maxPlayers);
+    writer.write(settings.sizeMin);
+    writer.write(settings.sizeMax);
+    writer.write(settings.size);
+    writer.write(settings.roads);
+    writer.write(settings.startingGold);
+    writer.write(settings.startingNativeMana);
+    writer.write(settings.forest);
+}
+
+static void readSettings(SnapshotReader& reader, MapTemplateSettings& settings)
+{
+    reader.read(settings.forbiddenUnits);
+    reader.read(settings.forbiddenItems);
+    reader.read(settings.forbiddenSpells);
+    reader.read(settings.races);
+    reader.read(settings.name);
+    reader.read(settings.description);
+    reader.read(settings.maxPlayers);
+    reader.read(settings.sizeMin);
+    reader.read(settings.sizeMax);
+    reader.read(settings.size);
+    reader.read(settings.roads);
+    reader.read(settings.startingGold);
+    reader.read(settings.startingNativeMana);
+    reader.read(settings.forest);
+}
+
+static std::string popErrorMessage(lua_State* lua)
+{
+    const char* error{lua_tostring(lua, -1)};
+    std::string message{error ? error : "unknown error"};
+
+    lua_pop(lua, 1);
+    return message;
+}
+
+TemplateCache::TemplateCache(const std::filesystem::path& cacheFolder)
+    : cacheFolder{cacheFolder}
+{ }
+
+std::filesystem::path TemplateCache::getDefaultFolder()
+{
+    // Bytecode is loaded without verification, never pick up foreign files of temporary folder
+    std::error_code error;
+    auto folder{std::filesystem::temp_directory_path(error)};
+    if (error) {
+        return {};
+    }
+
+    folder /= "D2RSG";
+    std::filesystem::create_directories(folder, error);
+    if (error) {
+        return {};
+    }
+
+    return folder;
+}
+
+MapTemplateSettings TemplateCache::readTemplateSettings(const std::filesystem::path& templatePath,
+                                                        sol::state& lua)
+{
+    lua_State* state{lua.lua_state()};
+    addModuleSearcher(state);
+
+    lua_getfield(state, LUA_REGISTRYINDEX, modulesKey);
+    const auto modulesLoaded{lua_rawlen(state, -1)};
+    lua_pop(state, 1);
+
+    // Execute script
+    std::uint64_t hash{};
+    if (loadChunk(state, templatePath, hash) != LUA_OK || lua_pcall(state, 0, 0, 0) != LUA_OK) {
+        throw TemplateException(popErrorMessage(state));
+    }
+
+    // Template settings could depend on modules it required
+    std::uint64_t settingsKey{hash};
+
+    lua_getfield(state, LUA_REGISTRYINDEX, modulesKey);
+    for (auto i = modulesLoaded + 1, total = lua_rawlen(state, -1); i <= total; ++i) {
+        lua_rawgeti(state, -1, static_cast<lua_Integer>(i));
+        const auto moduleHash{static_cast<std::uint64_t>(lua_tointeger(state, -1))};
+        lua_pop(state, 1);
+
+        settingsKey = combineHash(settingsKey, moduleHash);
+    }
+    lua_pop(state, 1);
+
+    const auto entry{findEntry(hash)};
+    if (entry && entry->settings && entry->settingsKey == settingsKey) {
+        return *entry->settings;
+    }
+
+    auto settings{rsg::readTemplateSettings(lua)};
+
+    if (entry) {
+        auto updated{std::make_shared<Entry>(*entry)};
+        updated->settingsKey = settingsKey;
+        updated->settings = settings;
+
+        storeEntry(hash, updated);
+    }
+
+    return settings;
+}
+
+int TemplateCache::loadChunk(lua_State* lua,
+                             const std::filesystem::path& chunkPath,
+                             std::uint64_t& hash)
+{
+    if (!std::filesystem::exists(chunkPath)) {
+        lua_pushfstring(lua, "cannot open %s", chunkPath.string().c_str());
+        return LUA_ERRFILE;
+    }
+
+    const std::string source{readFile(chunkPath)};
+    const std::string chunkName{"@" + chunkPath.string()};
+
+    hash = getSourceHash(chunkName, source);
+
+    const auto entry{findEntry(hash)};
+    if (entry && entry->sourceSize == source.size()) {
+        if (luaL_loadbufferx(lua, entry->bytecode.data(), entry->bytecode.size(),
+                             chunkName.c_str(), "b")
+            == LUA_OK) {
+            return LUA_OK;
+        }
+
+        // Bytecode of a different Lua build, compile source again
+        lua_pop(lua, 1);
+    }
+
+    const int status{
+        luaL_loadbufferx(lua, source.data(), source.size(), chunkName.c_str(), nullptr)};
+    if (status != LUA_OK) {
+        return status;
+    }
+
+    auto compiled{std::make_shared<Entry>()};
+    compiled->sourceSize = source.size();
+    // Keep debug info, it is needed for meaningful error messages
+    lua_dump(lua, writeBytecode, &compiled->bytecode, 0);
+
+    storeEntry(hash, compiled);
+    return LUA_OK;
+}
+
+void TemplateCache::addModuleSearcher(lua_State* lua)
+{
+    if (lua_getfield(lua, LUA_REGISTRYINDEX, modulesKey) != LUA_TNIL) {
+        // Already added
+        lua_pop(lua, 1);
+        return;
+    }
+
+    lua_pop(lua, 1);
+    lua_newtable(lua);
+    lua_setfield(lua, LUA_REGISTRYINDEX, modulesKey);
+
+    if (lua_getglobal(lua, "package") != LUA_TTABLE) {
+        // Modules are not available
+        lua_pop(lua, 1);
+        return;
+    }
+
+    if (lua_getfield(lua, -1, "searchers") != LUA_TTABLE) {
+        lua_pop(lua, 2);
+        return;
+    }
+
+    // Place searcher right before the default Lua file searcher which is the second one
+    for (auto i = static_cast<lua_Integer>(lua_rawlen(lua, -1)); i >= 2; --i) {
+        lua_rawgeti(lua, -1, i);
+        lua_rawseti(lua, -2, i + 1);
+    }
+
+    lua_pushlightuserdata(lua, this);
+    lua_pushcclosure(lua, searchModule, 1);
+    lua_rawseti(lua, -2, 2);
+
+    lua_pop(lua, 2);
+}
+
+int TemplateCache::searchModule(lua_State* lua)
+{
+    auto cache{static_cast<TemplateCache*>(lua_touserdata(lua, lua_upvalueindex(1)))};
+    const char* name{luaL_checkstring(lua, 1)};
+
+    // Find module file the same way the default searcher does
+    lua_getglobal(lua, "package");
+    lua_getfield(lua, -1, "searchpath");
+    lua_pushstring(lua, name);
+    lua_getfield(lua, -3, "path");
+    lua_call(lua, 2, 1);
+
+    if (!lua_isstring(lua, -1)) {
+        // Not found, default searcher will report it
+        return 0;
+    }
+
+    std::uint64_t hash{};
+    int status{};
+    {
+        const std::filesystem::path modulePath{lua_tostring(lua, -1)};
+        status = cache->loadChunk(lua, modulePath, hash);
+    }
+
+    if (status != LUA_OK) {
+        return luaL_error(lua, "error loading module '%s' from file '%s':\n\t%s", name,
+                          lua_tostring(lua, -2), lua_tostring(lua, -1));
+    }
+
+    lua_getfield(lua, LUA_REGISTRYINDEX, modulesKey);
+    const auto modulesLoaded{static_cast<lua_Integer>(lua_rawlen(lua, -1))};
+    lua_pushinteger(lua, static_cast<lua_Integer>(hash));
+    lua_rawseti(lua, -2, modulesLoaded + 1);
+    lua_pop(lua, 1);
+
+    // Return module loader and file name that is passed to it
+    lua_insert(lua, -2);
+    return 2;
+}
+
+TemplateCache::EntryPtr TemplateCache::findEntry(std::uint64_t hash)
+{
+    {
+        std::lock_guard<std::mutex> lock{entriesMutex};
+
+        const auto it{entries.find(hash)};
+        if (it != entries.end()) {
+            return it->second;
+        }
+    }
+
+    if (cacheFolder.empty()) {
+        return nullptr;
+    }
+
+    const MappedFile file{getEntryPath(hash)};
+    if (!file) {
+        return nullptr;
+    }
+
+    auto entry{std::make_shared<Entry>()};
+
+    try {
+        SnapshotReader reader{file.data(), file.size()};
+
+        if (reader.readValue<std::uint32_t>() != entrySignature
+            || reader.readValue<std::uint32_t>() != entryVersion
+            || reader.readValue<int>() != LUA_VERSION_NUM
+            || reader.readValue<std::uint64_t>() != hash) {
+            return nullptr;
+        }
+
+        reader.read(entry->sourceSize);
+        reader.read(entry->bytecode);
+
+        if (reader.readValue<bool>()) {
+            reader.read(entry->settingsKey);
+            readSettings(reader, entry->settings.emplace());
+        }
+    } catch (const std::exception&) {
+        // Truncated entry, treat as missing
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock{entriesMutex};
+    return entries.emplace(hash, std::move(entry)).first->second;
+}
+
+void TemplateCache::storeEntry(std::uint64_t hash, const EntryPtr& entry)
+{
+    {
+        std::lock_guard<std::mutex> lock{entriesMutex};
+        entries[hash] = entry;
+    }
+
+    if (cacheFolder.empty()) {
+        return;
+    }
+
+    SnapshotWriter writer;
+    writer.write(entrySignature);
+    writer.write(entryVersion);
+    writer.write(static_cast<int>(LUA_VERSION_NUM));
+    writer.write(hash);
+    writer.write(entry->sourceSize);
+    writer.write(entry->bytecode);
+
+    writer.write(entry->settings.has_value());
+    if (entry->settings) {
+        writer.write(entry->settingsKey);
+        writeSettings(writer, *entry->settings);
+    }
+
+    // Not critical, template will be compiled again next time
+    writeSnapshotFile(getEntryPath(hash), writer);
+}
+
+std::filesystem::path TemplateCache::getEntryPath(std::uint64_t hash) const
+{
+    char fileName[64] = {0};
+    std::snprintf(fileName, std::size(fileName) - 1, "rsgTemplate%016llx.cache",
+                  static_cast<unsigned long long>(hash));
+
+    return cacheFolder / fileName;
+}
+
+} // namespace rsg
@@ -0,0 +1,89 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "maptemplate.h"
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+struct lua_State;
+
+namespace sol {
+class state;
+}
+
+namespace rsg {
+
+// Compiled scenario templates.
+// Keeps bytecode of template chunks and of modules they require, along with template settings.
+// Entries are keyed by hash of chunk source and are stored in memory and in cache folder,
+// unchanged templates are loaded on repeated runs without parsing.
+// Cache must outlive lua states it was used with, it can be shared between threads
+class TemplateCache
+{
+public:
+    // Empty folder path keeps entries in memory only
+    TemplateCache(const std::filesystem::path& cacheFolder = {});
+
+    // Returns cache folder dedicated to generator inside temporary folder, creates it if needed.
+    // Returns empty path if folder could not be created
+    static std::filesystem::path getDefaultFolder();
+
+    // Same as rsg::readTemplateSettings, but loads template and modules it requires
+    // through the cache and reuses settings read earlier.
+    // Throws exception in case of errors.
+    MapTemplateSettings readTemplateSettings(const std::filesystem::path& templatePath,
+                                             sol::state& lua);
+
+private:
+    struct Entry
+    {
+        std::uint64_t sourceSize{};
+        std::string bytecode;
+        // Template settings are valid only for the same template and required modules
+        std::uint64_t settingsKey{};
+        std::optional<MapTemplateSettings> settings;
+    };
+
+    using EntryPtr = std::shared_ptr<const Entry>;
+
+    // Loads chunk from specified file and pushes it on the lua stack.
+    // Pushes error message instead of chunk in case of errors, like luaL_loadfile
+    int loadChunk(lua_State* lua, const std::filesystem::path& chunkPath, std::uint64_t& hash);
+    // Adds searcher that loads modules through the cache, if not added yet
+    void addModuleSearcher(lua_State* lua);
+
+    EntryPtr findEntry(std::uint64_t hash);
+    void storeEntry(std::uint64_t hash, const EntryPtr& entry);
+    std::filesystem::path getEntryPath(std::uint64_t hash) const;
+
+    static int searchModule(lua_State* lua);
+
+    std::filesystem::path cacheFolder;
+    std::map<std::uint64_t, EntryPtr> entries;
+    std::mutex entriesMutex;
+};
+
+} // namespace rsg
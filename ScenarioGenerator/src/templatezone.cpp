@@ -25,7 +25,6 @@
 #include "exceptions.h"
 #include "generatorsettings.h"
 #include "item.h"
-#include "itempicker.h"
 #include "knownspells.h"
 #include "landmarkpicker.h"
 #include "mage.h"
@@ -34,17 +33,22 @@
 #include "mercenary.h"
 #include "merchant.h"
 #include "player.h"
+#include "positiongrid.h"
+#include "profiler.h"
 #include "resourcemarket.h"
 #include "spellpicker.h"
 #include "subrace.h"
 #include "texts.h"
 #include "trainer.h"
 #include "unit.h"
+#include "unitindex.h"
 #include "unitpicker.h"
 #include "village.h"
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <iterator>
+#include <numeric>
 #include <sstream>
 
 namespace rsg {
@@ -57,6 +61,27 @@ static Facing getRandomFacing(RandomGenerator& rand)
     return static_cast<Facing>(rand.nextInteger(minFacing, maxFacing));
 }
 
+// Converts value window used for stack units into integer range of unit values
+static std::pair<int, int> getUnitValueRange(float minValue, std::size_t maxValue)
+{
+    const std::size_t maxIntValue{static_cast<std::size_t>(std::numeric_limits<int>::max())};
+
+    return {static_cast<int>(std::ceil(minValue)),
+            static_cast<int>(std::min(maxValue, maxIntValue))};
+}
+
+// Returns placements of units that could be picked for specified group position
+static std::uint8_t getGroupPlacements(bool canPlaceBig, bool frontline)
+{
+    if (canPlaceBig) {
+        // We don't care about front or back line and unit attack reach in case of big unit
+        return UnitIndex::Any;
+    }
+
+    // Pick melee units for frontline, ranged and support ones for backline
+    return frontline ? UnitIndex::Melee : UnitIndex::Ranged | UnitIndex::Support;
+}
+
 // Returns true if all tiles near mapElement entrance are blocked or used not by forest
 static bool isEntranceBlocked(const MapElement& mapElement, const MapGenerator& mapGenerator)
 {
@@ -77,7 +102,7 @@ static bool isEntranceBlocked(const MapElement& mapElement, const MapGenerator&
         }
 
         if (mapGenerator.isUsed(pos)) {
-            const Tile& tile{mapGenerator.map->getTile(pos)};
+            const Tile& tile{mapGenerator.getMapTile(pos)};
 
             if (tile.ground != GroundType::Forest) {
                 // Used and not a forest? Stack, landmark, other object?
@@ -194,6 +219,8 @@ void TemplateZone::initTowns()
 
 void TemplateZone::initFreeTiles()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::initFreeTiles", "zone " + std::to_string(id));
+
     std::copy_if(tileInfo.begin(), tileInfo.end(),
                  std::inserter(possibleTiles, possibleTiles.end()),
                  [this](const Position& position) {
@@ -226,8 +253,7 @@ void TemplateZone::createBorder()
             if (mapGenerator->isPossible(tile)) {
                 switch (borderType) {
                 case ZoneBorderType::Water: {
-                    Tile& mapTile = mapGenerator->map->getTile(tile);
-                    mapTile.setTerrainGround(TerrainType::Neutral, GroundType::Water);
+                    mapGenerator->paintTerrain(tile, TerrainType::Neutral, GroundType::Water);
                     mapGenerator->setOccupied(tile, TileType::Free);
                     ++openBorders;
                     break;
@@ -243,7 +269,7 @@ void TemplateZone::createBorder()
                     break;
 
                 case ZoneBorderType::SemiOpen: {
-                    const bool gap{mapGenerator->randomGenerator.chance(gapChance)};
+                    const bool gap{randomGenerator.chance(gapChance)};
 
                     mapGenerator->setOccupied(tile, gap ? TileType::Free : TileType::Blocked);
                     if (gap) {
@@ -271,13 +297,71 @@ void TemplateZone::createBorder()
     }
 }
 
+void TemplateZone::estimateCapacity()
+{
+    // Tiles that objects could occupy after zone borders were created
+    const auto usableTiles{static_cast<std::size_t>(
+        std::count_if(tileInfo.begin(), tileInfo.end(), [this](const Position& position) {
+            return mapGenerator->isPossible(position);
+        }))};
+
+    // Objects are kept at least one tile apart from each other,
+    // actual distance between them is larger, so this is the lowest estimate
+    auto objectTiles = [](std::size_t count, int size, int gap) {
+        const std::size_t side = static_cast<std::size_t>(size + gap);
+        return count * side * side;
+    };
+
+    // Non-starting zones already have first city placed
+    const std::size_t placedCities{
+        type == TemplateZoneType::PlayerStart || type == TemplateZoneType::AiStart ? 0u : 1u};
+    const std::size_t cities{neutralCities.size() > placedCities
+                                 ? neutralCities.size() - placedCities
+                                 : 0u};
+    const std::size_t sites{merchants.size() + mages.size() + mercenaries.size() + trainers.size()
+                            + markets.size() + ruins.size()};
+
+    std::size_t minesTotal{};
+    for (const auto& mine : mines) {
+        minesTotal += mine.second;
+    }
+
+    std::size_t stacksTotal{};
+    for (const auto& stackGroup : stacks.stackGroups) {
+        stacksTotal += stackGroup.count;
+    }
+
+    // Crystals are 1x1, their 3x3 placement area already holds the gap around them
+    const std::size_t requiredTiles{objectTiles(cities, 4, 1) + objectTiles(sites, 3, 1)
+                                    + objectTiles(minesTotal, 1, 1)
+                                    + objectTiles(stacksTotal, 1, 0)
+                                    + objectTiles(bags.count, 1, 1)};
+
+    if (mapGenerator->isDebugMode()) {
+        const auto slack{static_cast<std::ptrdiff_t>(usableTiles)
+                         - static_cast<std::ptrdiff_t>(requiredTiles)};
+
+        std::cout << "Zone id " << id << ", usable tiles " << usableTiles << ", required "
+                  << requiredTiles << ", slack " << slack << '\n';
+    }
+
+    if (requiredTiles > usableTiles) {
+        throw LackOfSpaceException(std::string("Zone ") + std::to_string(id) + " needs at least "
+                                   + std::to_string(requiredTiles) + " tiles for its contents, "
+                                   + std::to_string(usableTiles) + " available", id);
+    }
+}
+
 void TemplateZone::fill()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::fill", "zone " + std::to_string(id));
+
     initTerrain();
 
     // Zone center should be always clear to allow other tiles to connect
     initFreeTiles();
     fractalize();
+    mapGenerator->checkCancelled();
     placeCities();
     placeMerchants();
     placeMages();
@@ -286,8 +370,11 @@ void TemplateZone::fill()
     placeMarkets();
     placeRuins();
     placeMines();
+    mapGenerator->checkCancelled();
     createRequiredObjects();
+    mapGenerator->checkCancelled();
     placeStacks();
+    mapGenerator->checkCancelled();
     placeBags();
 
     if (mapGenerator->isDebugMode()) {
@@ -297,6 +384,8 @@ void TemplateZone::fill()
 
 void TemplateZone::createObstacles()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::createObstacles", "zone " + std::to_string(id));
+
     if (mapGenerator->isDebugMode()) {
         std::cout << "Place decorations\n";
         checkObjectsAccess(*mapGenerator, *mapGenerator->map);
@@ -305,7 +394,7 @@ void TemplateZone::createObstacles()
     // Place decorations first
     for (const auto& decoration : decorations) {
         decoration->decorate(*this, *mapGenerator, *mapGenerator->map,
-                             mapGenerator->randomGenerator);
+                             randomGenerator);
     }
 
     decorations.clear();
@@ -323,7 +412,7 @@ void TemplateZone::createObstacles()
     std::map<int /* mountain size */, MountainsVector> obstaclesBySize;
     std::vector<MountainPair> possibleObstacles;
 
-    const auto& knownMountains = getGeneratorSettings().mountains;
+    const auto& knownMountains = context.getGeneratorSettings().mountains;
     for (const auto& mountain : knownMountains) {
         obstaclesBySize[mountain.size].push_back(mountain);
     }
@@ -339,7 +428,7 @@ void TemplateZone::createObstacles()
               });
 
     auto tryPlaceMountainHere = [this, &possibleObstacles](const Position& tile, int index) {
-        auto& rand{mapGenerator->randomGenerator};
+        auto& rand{randomGenerator};
 
         const auto it{getRandomElement(possibleObstacles[index].second, rand)};
 
@@ -355,7 +444,7 @@ void TemplateZone::createObstacles()
                 return info->getSize().x != size || info->getSize().y != size;
             };
 
-            auto info{pickMountainLandmark(rand, {noWrongSize})};
+            auto info{pickMountainLandmark(context, rand, {noWrongSize})};
             assert(info != nullptr);
 
             auto landmarkId{mapGenerator->createId(CMidgardID::Type::Landmark)};
@@ -373,6 +462,7 @@ void TemplateZone::createObstacles()
     for (const auto& tile : tileInfo) {
         // Fill tiles that should be blocked with obstacles
         if (mapGenerator->shouldBeBlocked(tile)) {
+            mapGenerator->checkCancelled();
 
             // Start from biggets obstacles
             for (int i = 0; i < (int)possibleObstacles.size(); ++i) {
@@ -419,7 +509,7 @@ void TemplateZone::createObstacles()
         return;
     }
 
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     for (auto& tile : tileInfo) {
         if (mapGenerator->isPossible(tile)) {
@@ -437,16 +527,20 @@ void TemplateZone::createObstacles()
 
             mapGenerator->setOccupied(tile, TileType::Used);
 
-            auto& mapTile = mapGenerator->map->getTile(tile);
+            const auto treeImage{getRandomTreeImageIndex(context.getGeneratorSettings(), rand)};
 
-            mapTile.setTerrainGround(TerrainType::Neutral, GroundType::Forest);
-            mapTile.treeImage = getRandomTreeImageIndex(rand);
+            mapGenerator->changeMapTile(tile, [treeImage](Tile& mapTile) {
+                mapTile.setTerrainGround(TerrainType::Neutral, GroundType::Forest);
+                mapTile.treeImage = treeImage;
+            });
         }
     }
 }
 
 void TemplateZone::connectRoads()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::connectRoads", "zone " + std::to_string(id));
+
     if (mapGenerator->isDebugMode()) {
         std::cout << "Started building roads\n";
     }
@@ -455,6 +549,8 @@ void TemplateZone::connectRoads()
     std::set<Position> processed;
 
     while (!roadNodesCopy.empty()) {
+        mapGenerator->checkCancelled();
+
         auto node{*roadNodesCopy.begin()};
         roadNodesCopy.erase(node);
 
@@ -663,7 +759,7 @@ void TemplateZone::placeObject(std::unique_ptr<Fortification>&& fortification,
     // Add road node using entrance point
     addRoadNode(fortification->getEntrance());
 
-    mapGenerator->map->insertMapElement(*fortification.get(), fortification->getId());
+    mapGenerator->insertMapElement(*fortification.get(), fortification->getId());
     // Store object in scenario map
     mapGenerator->insertObject(std::move(fortification));
 }
@@ -698,7 +794,7 @@ void TemplateZone::placeObject(std::unique_ptr<Stack>&& stack,
         updateDistances(position);
     }
 
-    mapGenerator->map->insertMapElement(*stack.get(), stack->getId());
+    mapGenerator->insertMapElement(*stack.get(), stack->getId());
     // Store object in scenario map
     mapGenerator->insertObject(std::move(stack));
 }
@@ -733,7 +829,7 @@ void TemplateZone::placeObject(std::unique_ptr<Crystal>&& crystal,
         updateDistances(position);
     }
 
-    mapGenerator->map->insertMapElement(*crystal.get(), crystal->getId());
+    mapGenerator->insertMapElement(*crystal.get(), crystal->getId());
     // Store object in scenario map
     mapGenerator->insertObject(std::move(crystal));
 }
@@ -780,7 +876,7 @@ void TemplateZone::placeObject(std::unique_ptr<Ruin>&& ruin,
         updateDistances(position);
     }
 
-    mapGenerator->map->insertMapElement(*ruin.get(), ruin->getId());
+    mapGenerator->insertMapElement(*ruin.get(), ruin->getId());
     // Store object in scenario map
     mapGenerator->insertObject(std::move(ruin));
 }
@@ -830,7 +926,7 @@ void TemplateZone::placeObject(std::unique_ptr<Site>&& site,
     // Add road node using entrance point
     addRoadNode(site->getEntrance());
 
-    mapGenerator->map->insertMapElement(*site.get(), site->getId());
+    mapGenerator->insertMapElement(*site.get(), site->getId());
     // Store object in scenario map
     mapGenerator->insertObject(std::move(site));
 }
@@ -865,7 +961,7 @@ void TemplateZone::placeObject(std::unique_ptr<Bag>&& bag,
         updateDistances(position);
     }
 
-    mapGenerator->map->insertMapElement(*bag.get(), bag->getId());
+    mapGenerator->insertMapElement(*bag.get(), bag->getId());
     // Store object in scenario map
     mapGenerator->insertObject(std::move(bag));
 }
@@ -913,7 +1009,7 @@ void TemplateZone::placeObject(std::unique_ptr<Landmark>&& landmark,
         updateDistances(position);
     }
 
-    mapGenerator->map->insertMapElement(*landmark.get(), landmark->getId());
+    mapGenerator->insertMapElement(*landmark.get(), landmark->getId());
     // Store object in scenario map
     mapGenerator->insertObject(std::move(landmark));
 }
@@ -934,7 +1030,7 @@ void TemplateZone::placeMountain(const Position& position, const Position& size,
         }
     }
 
-    mapGenerator->map->addMountain(position, size, image);
+    mapGenerator->addMountain(position, size, image);
 }
 
 bool TemplateZone::guardObject(const MapElement& mapElement, const GroupInfo& guardInfo)
@@ -996,21 +1092,20 @@ bool TemplateZone::connectWithCenter(const Position& position,
                                      bool onlyStraight,
                                      bool passThroughBlocked)
 {
+    RSG_PROFILE_SCOPE("TemplateZone::connectWithCenter");
+
     // A* algorithm
 
-    // Nodes that are already evaluated
-    std::set<Position> closed;
+    // Evaluated nodes, navigated nodes and distances to them
+    auto& search{pathSearch};
+    search.begin(mapGenerator->mapGenOptions.size);
     // The set of tentative nodes to be evaluated, initially containing the start node
     PriorityQueue queue;
-    // Map of navigated nodes
-    std::map<Position, Position> cameFrom;
-    std::map<Position, float> distances;
 
     // First node points to finish condition.
     // Invalid position of (-1 -1) used as stop element
-    cameFrom[position] = Position(-1, -1);
+    search.setDistance(position, 0.f, Position(-1, -1));
     queue.push(std::make_pair(position, 0.f));
-    distances[position] = 0.f;
 
     while (!queue.empty()) {
         auto node = queue.top();
@@ -1018,22 +1113,25 @@ bool TemplateZone::connectWithCenter(const Position& position,
         queue.pop();
 
         const auto& currentNode{node.first};
-        closed.insert(currentNode);
+        search.close(currentNode);
 
         // Reached center of the zone, stop
         if (currentNode == pos) {
             // Trace the path using the saved parent information and return path
             Position backTracking{currentNode};
-            while (cameFrom[backTracking].isValid()) {
+            while (search.getCameFrom(backTracking).isValid()) {
                 mapGenerator->setOccupied(backTracking, TileType::Free);
-                backTracking = cameFrom[backTracking];
+                backTracking = search.getCameFrom(backTracking);
             }
 
             return true;
         } else {
-            auto functor = [this, &queue, &closed, &cameFrom, &currentNode, &distances,
+            float currentDistance{};
+            search.getDistance(currentNode, currentDistance);
+
+            auto functor = [this, &queue, &search, &currentNode, currentDistance,
                             passThroughBlocked](Position& p) {
-                if (contains(closed, p)) {
+                if (search.isClosed(p)) {
                     return;
                 }
 
@@ -1053,18 +1151,17 @@ bool TemplateZone::connectWithCenter(const Position& position,
                 }
 
                 // We prefer to use already free paths
-                const float distance{distances[currentNode] + movementCost};
+                const float distance{currentDistance + movementCost};
                 auto bestDistanceSoFar{std::numeric_limits<int>::max()};
 
-                auto it{distances.find(p)};
-                if (it != distances.end()) {
-                    bestDistanceSoFar = static_cast<int>(it->second);
+                float knownDistance{};
+                if (search.getDistance(p, knownDistance)) {
+                    bestDistanceSoFar = static_cast<int>(knownDistance);
                 }
 
                 if (distance < bestDistanceSoFar) {
-                    cameFrom[p] = currentNode;
+                    search.setDistance(p, distance, currentNode);
                     queue.push(std::make_pair(p, distance));
-                    distances[p] = distance;
                 }
             };
 
@@ -1203,19 +1300,18 @@ bool TemplateZone::crunchPath(const Position& source,
 
 bool TemplateZone::connectPath(const Position& source, bool onlyStraight)
 {
+    RSG_PROFILE_SCOPE("TemplateZone::connectPath");
+
     // A* algorithm
 
-    // The set of nodes already evaluated
-    std::set<Position> closed;
+    // Nodes already evaluated, navigated nodes and distances to them
+    auto& search{pathSearch};
+    search.begin(mapGenerator->mapGenOptions.size);
     // The set of tentative nodes to be evaluated, initially containing the start node
     PriorityQueue open;
-    // The map of navigated nodes
-    std::map<Position, Position> cameFrom;
-    std::map<Position, float> distances;
 
     // First node points to finish condition
-    cameFrom[source] = Position{-1, -1};
-    distances[source] = 0.f;
+    search.setDistance(source, 0.f, Position{-1, -1});
     open.push({source, 0.f});
 
     // Cost from start along best known path.
@@ -1226,23 +1322,26 @@ bool TemplateZone::connectPath(const Position& source, bool onlyStraight)
         open.pop();
         const auto currentNode{node.first};
 
-        closed.insert(currentNode);
+        search.close(currentNode);
 
         // We reached free paths, stop
         if (mapGenerator->isFree(currentNode)) {
             // Trace the path using the saved parent information and return path
             auto backTracking{currentNode};
-            while (cameFrom[backTracking].isValid()) {
+            while (search.getCameFrom(backTracking).isValid()) {
                 mapGenerator->setOccupied(backTracking, TileType::Free);
-                backTracking = cameFrom[backTracking];
+                backTracking = search.getCameFrom(backTracking);
             }
 
             mapGenerator->setOccupied(backTracking, TileType::Free);
             return true;
         }
 
-        auto functor = [this, &open, &closed, &cameFrom, &currentNode, &distances](Position& pos) {
-            if (contains(closed, pos)) {
+        float currentDistance{};
+        search.getDistance(currentNode, currentDistance);
+
+        auto functor = [this, &open, &search, &currentNode, currentDistance](Position& pos) {
+            if (search.isClosed(pos)) {
                 return;
             }
 
@@ -1251,18 +1350,17 @@ bool TemplateZone::connectPath(const Position& source, bool onlyStraight)
                 return;
             }
 
-            const auto distance{static_cast<int>(distances[currentNode]) + 1};
+            const auto distance{static_cast<int>(currentDistance) + 1};
             int bestDistanceSoFar{std::numeric_limits<int>::max()};
 
-            auto it{distances.find(pos)};
-            if (it != distances.end()) {
-                bestDistanceSoFar = static_cast<int>(it->second);
+            float knownDistance{};
+            if (search.getDistance(pos, knownDistance)) {
+                bestDistanceSoFar = static_cast<int>(knownDistance);
             }
 
             if (distance < bestDistanceSoFar) {
-                cameFrom[pos] = currentNode;
+                search.setDistance(pos, static_cast<float>(distance), currentNode);
                 open.push({pos, static_cast<float>(distance)});
-                distances[pos] = static_cast<float>(distance);
             }
         };
 
@@ -1274,7 +1372,7 @@ bool TemplateZone::connectPath(const Position& source, bool onlyStraight)
     }
 
     // These tiles are sealed off and can't be connected anymore
-    for (const auto& tile : closed) {
+    for (const auto& tile : search.getClosedTiles()) {
         if (mapGenerator->isPossible(tile)) {
             mapGenerator->setOccupied(tile, TileType::Blocked);
         }
@@ -1292,17 +1390,17 @@ std::unique_ptr<Stack> TemplateZone::createStack(const GroupInfo& stackInfo, boo
         return nullptr;
     }
 
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     int strength = static_cast<int>(rand.pickValue(stackValue));
 
     // Roll number of units
-    int soldiersStrength{strength - getGameInfo()->getMinLeaderValue()};
+    const GameInfo& gameInfo{context.getGameInfo()};
+    int soldiersStrength{strength - gameInfo.getMinLeaderValue()};
 
     // Determine maximum possible soldier units in stack.
     // Make sure we do not roll too many soldier units for stack with low strength
-    const int maxUnitsPossible = std::min(5,
-                                          soldiersStrength / getGameInfo()->getMinSoldierValue());
+    const int maxUnitsPossible = std::min(5, soldiersStrength / gameInfo.getMinSoldierValue());
     // Pick how many soldier units will be in stack along with leader.
     // This will affect leader pick and resulting stack contents
     int soldiersTotal{rand.nextInteger(0, maxUnitsPossible)};
@@ -1365,26 +1463,28 @@ std::unique_ptr<Stack> TemplateZone::createStack(const GroupInfo& stackInfo, boo
     // and reduce number of stacks with single ranged or support leader
     tightenGroup(unusedValue, positions, soldiers, stackInfo.subraceTypes);
 
-    if (mapGenerator->isDebugMode()) {
-        // +1 because of leader
-        int unitsCreated{1};
-        int createdValue = leaderInfo->getValue();
+    // +1 because of leader
+    int unitsCreated{1};
+    int createdValue = leaderInfo->getValue();
 
-        for (std::size_t position = 0; position < soldiers.size(); ++position) {
-            const auto* unitInfo{soldiers[position]};
-            if (!unitInfo) {
-                continue;
-            }
+    for (std::size_t position = 0; position < soldiers.size(); ++position) {
+        const auto* unitInfo{soldiers[position]};
+        if (!unitInfo) {
+            continue;
+        }
 
-            ++unitsCreated;
-            createdValue += unitInfo->getValue();
+        ++unitsCreated;
+        createdValue += unitInfo->getValue();
 
-            if (unitInfo->isBig()) {
-                // Skip second part of big unit
-                ++position;
-            }
+        if (unitInfo->isBig()) {
+            // Skip second part of big unit
+            ++position;
         }
+    }
+
+    statistics.stacks.push_back(CreatedValue{strength, createdValue});
 
+    if (mapGenerator->isDebugMode()) {
         std::cout << "Stack value " << strength << ", created " << createdValue << ", unused "
                   << strength - createdValue << ". Units " << unitsTotal << ", created "
                   << unitsCreated << '\n';
@@ -1412,7 +1512,7 @@ std::unique_ptr<Stack> TemplateZone::createStack(const GroupInfo& stackInfo, boo
 
     if (leaderInfo->getLeadership() < leadershipRequired) {
         const int diff = leadershipRequired - leaderInfo->getLeadership();
-        Unit* leaderUnit = mapGenerator->map->find<Unit>(stack->getLeader());
+        Unit* leaderUnit = mapGenerator->find<Unit>(stack->getLeader());
 
         for (int i = 0; i < diff; ++i) {
             leaderUnit->addModifier(CMidgardID("G000UM9031")); // +1 Leadership
@@ -1441,7 +1541,7 @@ std::unique_ptr<Stack> TemplateZone::createStack(const UnitInfo& leaderInfo,
                                                  const GroupUnits& groupUnits,
                                                  bool neutralOwner)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // Create stack
     auto stackId{mapGenerator->createId(CMidgardID::Type::Stack)};
@@ -1456,7 +1556,7 @@ std::unique_ptr<Stack> TemplateZone::createStack(const UnitInfo& leaderInfo,
 
     leader->setImplId(leaderInfo.getUnitId());
     leader->setHp(leaderInfo.getHp());
-    leader->setName(getUnitName(leaderInfo, rand, neutralOwner));
+    leader->setName(getUnitName(context.getGameInfo(), leaderInfo, rand, neutralOwner));
 
     mapGenerator->insertObject(std::move(leader));
 
@@ -1473,7 +1573,7 @@ const UnitInfo* TemplateZone::createStackLeader(std::size_t& unusedValue,
                                                 const std::vector<std::size_t>& unitValues,
                                                 const std::set<SubRaceType>& allowedSubraces)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // How many failed attempts considered as a stop condition
     constexpr std::size_t totalFails{5};
@@ -1491,24 +1591,11 @@ const UnitInfo* TemplateZone::createStackLeader(std::size_t& unusedValue,
         for (std::size_t i = 0; i < unitValues.size(); ++i) {
             const std::size_t value = unitValues[i] + unused;
             const float minValue = value * minValueCoeff;
-
-            auto filter = [allowedSubraces, minValue, value](const UnitInfo* info) {
-                if (!allowedSubraces.empty()) {
-                    if (!contains(allowedSubraces, info->getSubrace())) {
-                        return true;
-                    }
-                }
-
-                return static_cast<float>(info->getValue()) < minValue || info->getValue() > value;
-            };
-
-            auto noForbiddenOnTemplate = [this](const UnitInfo* info) {
-                return contains(mapGenerator->mapGenOptions.mapTemplate->settings.forbiddenUnits,
-                                info->getUnitId());
-            };
+            const auto [minLeaderValue, maxLeaderValue] = getUnitValueRange(minValue, value);
 
             const UnitInfo* leaderInfo{
-                pickLeader(rand, {filter, noForbiddenOnTemplate, noForbiddenUnit})};
+                mapGenerator->unitIndex->pickLeader(rand, allowedSubraces, UnitIndex::Any,
+                                                    minLeaderValue, maxLeaderValue)};
             if (leaderInfo) {
                 // Accumulate unused value after picking a leader
                 unusedValue = value - leaderInfo->getValue();
@@ -1531,9 +1618,10 @@ const UnitInfo* TemplateZone::createStackLeader(std::size_t& unusedValue,
     // Could not pick any leader.
     // Either constraints are too tight, or something wrong with value (or unit values)
     // Pick weakest one just to create the stack and do not lose its value
-    const auto& leaders{getGameInfo()->getLeaders()};
-    auto it = std::find_if(leaders.begin(), leaders.end(), [](const UnitInfo* info) {
-        return info->getValue() == getGameInfo()->getMinLeaderValue();
+    const GameInfo& gameInfo{context.getGameInfo()};
+    const auto& leaders{gameInfo.getLeaders()};
+    auto it = std::find_if(leaders.begin(), leaders.end(), [&gameInfo](const UnitInfo* info) {
+        return info->getValue() == gameInfo.getMinLeaderValue();
     });
     if (it != leaders.end()) {
         std::cerr << "Could not pick leader, place weakest\n";
@@ -1551,16 +1639,13 @@ void TemplateZone::createGroup(std::size_t& unusedValue,
                                const std::vector<std::size_t>& unitValues,
                                const std::set<SubRaceType>& allowedSubraces)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // Pick soldier units 1 by 1, starting from value that was not used for leader
     for (std::size_t i = 0; i < unitValues.size() && !positions.empty(); ++i) {
         auto value = unitValues[i] + unusedValue;
         auto minValue = value * 0.75f;
-
-        auto noWrongValue = [minValue, value](const UnitInfo* info) {
-            return info->getValue() < minValue || info->getValue() > value;
-        };
+        const auto [minUnitValue, maxUnitValue] = getUnitValueRange(minValue, value);
 
         // Pick random position in group
         int position = *getRandomElement(positions, rand);
@@ -1571,44 +1656,9 @@ void TemplateZone::createGroup(std::size_t& unusedValue,
         // We can place big unit if front and back line positions are free
         const auto canPlaceBig = positions.count(position) && positions.count(secondPosition);
 
-        auto filter = [allowedSubraces, canPlaceBig, frontline](const UnitInfo* info) {
-            if (!allowedSubraces.empty()) {
-                if (allowedSubraces.find(info->getSubrace()) == allowedSubraces.end()) {
-                    // Remove units of subraces that are not allowed
-                    return true;
-                }
-            }
-
-            if (!canPlaceBig && info->isBig()) {
-                // Remove big units if we can not place them
-                return true;
-            }
-
-            // We don't care about front or back line and unit attack reach in case of big unit
-            if (canPlaceBig) {
-                return false;
-            }
-
-            if (frontline && info->getAttackReach() != ReachType::Adjacent) {
-                // Remove ranged units from frontline
-                return true;
-            }
-
-            if (!frontline && info->getAttackReach() == ReachType::Adjacent) {
-                // Remove melee units from backline
-                return true;
-            }
-
-            return false;
-        };
-
-        auto noForbiddenOnTemplate = [this](const UnitInfo* info) {
-            return contains(mapGenerator->mapGenOptions.mapTemplate->settings.forbiddenUnits,
-                            info->getUnitId());
-        };
-
-        const UnitInfo* info = pickUnit(rand, {filter, noWrongValue, noForbiddenOnTemplate,
-                                               noForbiddenUnit});
+        const UnitInfo* info = mapGenerator->unitIndex->pickSoldier(
+            rand, allowedSubraces, getGroupPlacements(canPlaceBig, frontline), minUnitValue,
+            maxUnitValue);
         if (info) {
             // We picked a unit, update unused value
             unusedValue = value - info->getValue();
@@ -1647,7 +1697,7 @@ void TemplateZone::tightenGroup(std::size_t& unusedValue,
                                 GroupUnits& groupUnits,
                                 const std::set<SubRaceType>& allowedSubraces)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // Start with somewhat relaxed minimum value.
     // Gradually decrease min value expectation as we struggle to pick units
@@ -1658,13 +1708,10 @@ void TemplateZone::tightenGroup(std::size_t& unusedValue,
     const int totalFails{5};
 
     while (failedAttempts < totalFails && !positions.empty()
-           && unusedValue >= getGameInfo()->getMinSoldierValue()) {
+           && unusedValue >= context.getGameInfo().getMinSoldierValue()) {
         auto value = unusedValue;
         auto minValue = value * minValueCoeff;
-
-        auto noWrongValue = [minValue, value](const UnitInfo* info) {
-            return info->getValue() < minValue || info->getValue() > value;
-        };
+        const auto [minUnitValue, maxUnitValue] = getUnitValueRange(minValue, value);
 
         int position = *getRandomElement(positions, rand);
 
@@ -1674,44 +1721,9 @@ void TemplateZone::tightenGroup(std::size_t& unusedValue,
         // We can place big unit if front and back line positions are free
         const auto canPlaceBig = positions.count(position) && positions.count(secondPosition);
 
-        auto filter = [allowedSubraces, canPlaceBig, frontline](const UnitInfo* info) {
-            if (!allowedSubraces.empty()) {
-                if (allowedSubraces.find(info->getSubrace()) == allowedSubraces.end()) {
-                    // Remove units of subraces that are not allowed
-                    return true;
-                }
-            }
-
-            if (!canPlaceBig && info->isBig()) {
-                // Remove big units if we can not place them
-                return true;
-            }
-
-            // We don't care about front or back line and unit attack reach in case of big unit
-            if (canPlaceBig) {
-                return false;
-            }
-
-            if (frontline && info->getAttackReach() != ReachType::Adjacent) {
-                // Remove ranged units from frontline
-                return true;
-            }
-
-            if (!frontline && info->getAttackReach() == ReachType::Adjacent) {
-                // Remove melee units from backline
-                return true;
-            }
-
-            return false;
-        };
-
-        auto noForbiddenOnTemplate = [this](const UnitInfo* info) {
-            return contains(mapGenerator->mapGenOptions.mapTemplate->settings.forbiddenUnits,
-                            info->getUnitId());
-        };
-
-        const UnitInfo* info = pickUnit(rand, {filter, noWrongValue, noForbiddenOnTemplate,
-                                               noForbiddenUnit});
+        const UnitInfo* info = mapGenerator->unitIndex->pickSoldier(
+            rand, allowedSubraces, getGroupPlacements(canPlaceBig, frontline), minUnitValue,
+            maxUnitValue);
         if (info) {
             // We picked a unit, update unused value
             unusedValue = value - info->getValue();
@@ -1780,7 +1792,7 @@ void TemplateZone::createGroupUnits(Group& group, const GroupUnits& groupUnits)
 
 Village* TemplateZone::placeCity(const Position& position, const CityInfo& cityInfo)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // Create city of specified tier, assign position, owner, subrace
     auto villageId{mapGenerator->createId(CMidgardID::Type::Fortification)};
@@ -1799,7 +1811,7 @@ Village* TemplateZone::placeCity(const Position& position, const CityInfo& cityI
     village->setTier(cityInfo.tier);
 
     if (cityInfo.name.empty()) {
-        village->setName(*getRandomElement(getGameInfo()->getCityNames(), rand));
+        village->setName(*getRandomElement(context.getGameInfo().getCityNames(), rand));
     } else {
         village->setName(cityInfo.name);
     }
@@ -1899,12 +1911,12 @@ Village* TemplateZone::placeCity(const Position& position, const CityInfo& cityI
 
 Site* TemplateZone::placeMerchant(const Position& position, const MerchantInfo& merchantInfo)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     auto merchantId{mapGenerator->createId(CMidgardID::Type::Site)};
     auto merchant{std::make_unique<Merchant>(merchantId)};
 
-    const SiteText& text = *getRandomElement(getGameInfo()->getMerchantTexts(), rand);
+    const SiteText& text = *getRandomElement(context.getGameInfo().getMerchantTexts(), rand);
     if (merchantInfo.name.empty()) {
         merchant->setTitle(text.name);
     } else {
@@ -1917,7 +1929,8 @@ Site* TemplateZone::placeMerchant(const Position& position, const MerchantInfo&
         merchant->setDescription(merchantInfo.description);
     }
 
-    merchant->setImgIso(*getRandomElement(getGeneratorSettings().merchants.images, rand));
+    const auto& images{context.getGeneratorSettings().merchants.images};
+    merchant->setImgIso(*getRandomElement(images, rand));
     merchant->setAiPriority(merchantInfo.aiPriority);
 
     // Create merchant items
@@ -1935,12 +1948,12 @@ Site* TemplateZone::placeMerchant(const Position& position, const MerchantInfo&
 
 Site* TemplateZone::placeMage(const Position& position, const MageInfo& mageInfo)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     auto mageId{mapGenerator->createId(CMidgardID::Type::Site)};
     auto mage{std::make_unique<Mage>(mageId)};
 
-    const SiteText& text = *getRandomElement(getGameInfo()->getMageTexts(), rand);
+    const SiteText& text = *getRandomElement(context.getGameInfo().getMageTexts(), rand);
 
     if (mageInfo.name.empty()) {
         mage->setTitle(text.name);
@@ -1954,7 +1967,7 @@ Site* TemplateZone::placeMage(const Position& position, const MageInfo& mageInfo
         mage->setDescription(mageInfo.description);
     }
 
-    mage->setImgIso(*getRandomElement(getGeneratorSettings().mages.images, rand));
+    mage->setImgIso(*getRandomElement(context.getGeneratorSettings().mages.images, rand));
     mage->setAiPriority(mageInfo.aiPriority);
 
     // Generate random spells of specified types
@@ -1989,20 +2002,15 @@ Site* TemplateZone::placeMage(const Position& position, const MageInfo& mageInfo
             return info->getLevel() < level.min || info->getLevel() > level.max;
         };
 
-        auto noForbiddenOnTemplate = [this](const SpellInfo* info) {
-            return contains(mapGenerator->mapGenOptions.mapTemplate->settings.forbiddenSpells,
-                            info->getSpellId());
+        auto noForbiddenSpell = [this](const SpellInfo* info) {
+            return mapGenerator->forbidden->isForbidden(info);
         };
 
         while (currentValue <= desiredValue) {
             const int remainingValue = desiredValue - currentValue;
 
-            auto noWrongValue = [remainingValue](const SpellInfo* info) {
-                return info->getValue() > remainingValue;
-            };
-
-            auto spell{pickSpell(rand, {noWrongType, noWrongLevel, noWrongValue,
-                                        noForbiddenOnTemplate, noForbiddenSpell, noDuplicates})};
+            auto spell{pickSpell(context, remainingValue, rand,
+                                 {noWrongType, noWrongLevel, noForbiddenSpell, noDuplicates})};
             if (!spell) {
                 // Could not pick anything, stop
                 break;
@@ -2027,12 +2035,12 @@ Site* TemplateZone::placeMage(const Position& position, const MageInfo& mageInfo
 
 Site* TemplateZone::placeMercenary(const Position& position, const MercenaryInfo& mercInfo)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     auto mercenaryId{mapGenerator->createId(CMidgardID::Type::Site)};
     auto mercenary{std::make_unique<Mercenary>(mercenaryId)};
 
-    const SiteText& text = *getRandomElement(getGameInfo()->getMercenaryTexts(), rand);
+    const SiteText& text = *getRandomElement(context.getGameInfo().getMercenaryTexts(), rand);
 
     if (mercInfo.name.empty()) {
         mercenary->setTitle(text.name);
@@ -2046,7 +2054,8 @@ Site* TemplateZone::placeMercenary(const Position& position, const MercenaryInfo
         mercenary->setDescription(mercInfo.description);
     }
 
-    mercenary->setImgIso(*getRandomElement(getGeneratorSettings().mercenaries.images, rand));
+    const auto& images{context.getGeneratorSettings().mercenaries.images};
+    mercenary->setImgIso(*getRandomElement(images, rand));
     mercenary->setAiPriority(mercInfo.aiPriority);
 
     // Generate random mercenary units of specified subraces
@@ -2066,7 +2075,7 @@ Site* TemplateZone::placeMercenary(const Position& position, const MercenaryInfo
         };
 
         while (currentValue <= desiredValue) {
-            auto unit{pickUnit(rand, {noWrongType})};
+            auto unit{pickUnit(context, rand, {noWrongType})};
             if (!unit) {
                 // Could not pick anything, stop
                 break;
@@ -2091,12 +2100,12 @@ Site* TemplateZone::placeMercenary(const Position& position, const MercenaryInfo
 
 Site* TemplateZone::placeTrainer(const Position& position, const TrainerInfo& trainerInfo)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     auto trainerId{mapGenerator->createId(CMidgardID::Type::Site)};
     auto trainer{std::make_unique<Trainer>(trainerId)};
 
-    const SiteText& text = *getRandomElement(getGameInfo()->getTrainerTexts(), rand);
+    const SiteText& text = *getRandomElement(context.getGameInfo().getTrainerTexts(), rand);
 
     if (trainerInfo.name.empty()) {
         trainer->setTitle(text.name);
@@ -2110,7 +2119,7 @@ Site* TemplateZone::placeTrainer(const Position& position, const TrainerInfo& tr
         trainer->setDescription(trainerInfo.description);
     }
 
-    trainer->setImgIso(*getRandomElement(getGeneratorSettings().trainers.images, rand));
+    trainer->setImgIso(*getRandomElement(context.getGeneratorSettings().trainers.images, rand));
     trainer->setAiPriority(trainerInfo.aiPriority);
 
     auto trainerPtr{trainer.get()};
@@ -2122,12 +2131,12 @@ Site* TemplateZone::placeTrainer(const Position& position, const TrainerInfo& tr
 
 Site* TemplateZone::placeMarket(const Position& position, const ResourceMarketInfo& marketInfo)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     auto marketId{mapGenerator->createId(CMidgardID::Type::Site)};
     auto market{std::make_unique<ResourceMarket>(marketId)};
 
-    const SiteText& text = *getRandomElement(getGameInfo()->getMarketTexts(), rand);
+    const SiteText& text = *getRandomElement(context.getGameInfo().getMarketTexts(), rand);
 
     if (marketInfo.name.empty()) {
         market->setTitle(text.name);
@@ -2141,7 +2150,8 @@ Site* TemplateZone::placeMarket(const Position& position, const ResourceMarketIn
         market->setDescription(marketInfo.description);
     }
 
-    market->setImgIso(*getRandomElement(getGeneratorSettings().resourceMarkets.images, rand));
+    const auto& images{context.getGeneratorSettings().resourceMarkets.images};
+    market->setImgIso(*getRandomElement(images, rand));
     market->setAiPriority(marketInfo.aiPriority);
 
     market->setExchangeRates(marketInfo.exchangeRates);
@@ -2166,19 +2176,19 @@ Site* TemplateZone::placeMarket(const Position& position, const ResourceMarketIn
 
 Ruin* TemplateZone::placeRuin(const Position& position, const RuinInfo& ruinInfo)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     auto ruinId{mapGenerator->createId(CMidgardID::Type::Ruin)};
     auto ruin{std::make_unique<Ruin>(ruinId)};
 
-    const SiteText& text = *getRandomElement(getGameInfo()->getRuinTexts(), rand);
+    const SiteText& text = *getRandomElement(context.getGameInfo().getRuinTexts(), rand);
     if (ruinInfo.name.empty()) {
         ruin->setTitle(text.name);
     } else {
         ruin->setTitle(ruinInfo.name);
     }
 
-    ruin->setImage(*getRandomElement(getGeneratorSettings().ruins.images, rand));
+    ruin->setImage(*getRandomElement(context.getGeneratorSettings().ruins.images, rand));
     ruin->setAiPriority(ruinInfo.aiPriority);
 
     const auto& guardValue{ruinInfo.guard.value};
@@ -2241,12 +2251,12 @@ Bag* TemplateZone::placeBag(const Position& position)
     auto bagId{mapGenerator->createId(CMidgardID::Type::Bag)};
     auto bag{std::make_unique<Bag>(bagId)};
 
-    const auto& bags = getGeneratorSettings().bags;
+    const auto& bags = context.getGeneratorSettings().bags;
 
-    const auto& bagImages = mapGenerator->map->getTile(position).isWater() ? bags.waterImages
-                                                                           : bags.images;
+    const auto& bagImages = mapGenerator->getMapTile(position).isWater() ? bags.waterImages
+                                                                         : bags.images;
 
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
     // Pick random bag image with respect to ground type
     bag->setImage(*getRandomElement(bagImages, rand));
 
@@ -2259,7 +2269,7 @@ Bag* TemplateZone::placeBag(const Position& position)
 std::vector<std::pair<CMidgardID, int>> TemplateZone::createLoot(const LootInfo& loot,
                                                                  bool forMerchant)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     std::vector<std::pair<CMidgardID, int>> items;
 
@@ -2283,44 +2293,22 @@ std::vector<std::pair<CMidgardID, int>> TemplateZone::createLoot(const LootInfo&
         const int desiredValue{static_cast<int>(rand.pickValue(value))};
         int currentValue{};
 
-        auto noWrongType = [types = &loot.itemTypes, forMerchant](const ItemInfo* info) {
-            if (forMerchant && info->getItemType() == ItemType::Valuable) {
-                // Do not generate valuables as merchant goods
-                return true;
-            }
-
-            if (types->empty()) {
-                return false;
-            }
-
-            // Remove items of types that is not allowed
-            return types->find(info->getItemType()) == types->end();
-        };
-
-        auto noForbiddenOnTemplate = [this](const ItemInfo* info) {
-            return contains(mapGenerator->mapGenOptions.mapTemplate->settings.forbiddenItems,
-                            info->getItemId());
-        };
-
+        // Items outside of single item value range are never picked
         const auto& itemValue{loot.itemValue};
+        const int minItemValue{itemValue ? static_cast<int>(itemValue.min) : 0};
 
         int picked{};
         while (currentValue <= desiredValue) {
             const int remainingValue = desiredValue - currentValue;
 
-            auto noWrongValue = [remainingValue, &itemValue](const ItemInfo* info) {
-                if (itemValue
-                    && (info->getValue() < itemValue.min || info->getValue() > itemValue.max)) {
-                    // If user specified single item value range,
-                    // filter items that are outside of it
-                    return true;
-                }
-
-                return info->getValue() > static_cast<int>(remainingValue);
-            };
+            int maxItemValue{remainingValue};
+            if (itemValue && itemValue.max < static_cast<std::uint32_t>(remainingValue)) {
+                maxItemValue = static_cast<int>(itemValue.max);
+            }
 
-            auto item{pickItem(rand, {noWrongType, noWrongValue, noSpecialItem,
-                                      noForbiddenOnTemplate, noForbiddenItem})};
+            // Do not generate valuables as merchant goods
+            auto item{mapGenerator->lootIndex->pick(rand, loot.itemTypes, forMerchant,
+                                                    minItemValue, maxItemValue)};
             if (!item) {
                 // Could not pick anything, stop
                 break;
@@ -2331,6 +2319,8 @@ std::vector<std::pair<CMidgardID, int>> TemplateZone::createLoot(const LootInfo&
             items.push_back({item->getItemId(), 1});
         }
 
+        statistics.loot.push_back(CreatedValue{desiredValue, currentValue});
+
         if (mapGenerator->isDebugMode()) {
             std::cout << "Loot value " << desiredValue << ", created " << currentValue << ", "
                       << picked << " items\n";
@@ -2364,6 +2354,13 @@ void TemplateZone::initTerrain()
 
 void TemplateZone::fractalize()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::fractalize", "zone " + std::to_string(id));
+
+    if (mapGenerator->mapGenOptions.largeMap) {
+        fractalizeLargeMap();
+        return;
+    }
+
     for (const auto& tile : tileInfo) {
         if (mapGenerator->isFree(tile)) {
             freePaths.insert(tile);
@@ -2394,9 +2391,11 @@ void TemplateZone::fractalize()
         // Junction is not fractalized,
         // has only one straight path everything else remains blocked
         while (!possibleTiles.empty()) {
+            mapGenerator->checkCancelled();
+
             // Link tiles in random order
             std::vector<Position> tilesToMakePath(possibleTiles.begin(), possibleTiles.end());
-            randomShuffle(tilesToMakePath, mapGenerator->randomGenerator);
+            randomShuffle(tilesToMakePath, randomGenerator);
 
             Position nodeFound{-1, -1};
 
@@ -2514,9 +2513,112 @@ void TemplateZone::fractalize()
     }
 }
 
+void TemplateZone::fractalizeLargeMap()
+{
+    for (const auto& tile : tileInfo) {
+        if (mapGenerator->isFree(tile)) {
+            freePaths.insert(tile);
+        }
+    }
+
+    // This should come from zone connections
+    assert(!freePaths.empty());
+
+    const int mapSize{mapGenerator->mapGenOptions.size};
+    // Same distances as in fractalize(), compared against integer squared distances
+    const std::uint32_t minDistance{75};
+    const std::uint32_t blockDistance{18};
+
+    // Cell sizes are close to distances checked against tiles stored in grids
+    PositionGrid clearedTiles(mapSize, 9);
+    PositionGrid paths(mapSize, 5);
+    for (const auto& tile : freePaths) {
+        clearedTiles.insert(tile);
+        paths.insert(tile);
+    }
+
+    std::vector<Position> nodes;
+
+    if (type != TemplateZoneType::Junction) {
+        std::vector<Position> possibleTiles;
+        for (const auto& tile : tileInfo) {
+            if (mapGenerator->isPossible(tile)) {
+                possibleTiles.push_back(tile);
+            }
+        }
+
+        // Shuffle once instead of before each node, tiles close to already placed nodes are skipped
+        randomShuffle(possibleTiles, randomGenerator);
+
+        std::size_t tilesChecked{};
+        for (const auto& tile : possibleTiles) {
+            if (++tilesChecked % 4096 == 0) {
+                mapGenerator->checkCancelled();
+            }
+
+            if (clearedTiles.hasPositionWithin(tile, minDistance)) {
+                continue;
+            }
+
+            nodes.push_back(tile);
+            clearedTiles.insert(tile);
+        }
+    }
+
+    std::vector<Position> subnodes;
+    std::set<Position> newPaths;
+
+    // Cut straight paths towards the center
+    for (const auto& node : nodes) {
+        mapGenerator->checkCancelled();
+
+        // Only two nearest nodes are needed, node itself is the first one
+        subnodes = nodes;
+        const auto nearbyTotal{std::min<std::size_t>(subnodes.size(), 3)};
+        std::partial_sort(subnodes.begin(), subnodes.begin() + nearbyTotal, subnodes.end(),
+                          [&node](const Position& a, const Position& b) {
+                              return node.distanceSquared(a) < node.distanceSquared(b);
+                          });
+
+        newPaths.clear();
+        // Connect with all the paths
+        crunchPath(node, paths.findClosest(node), true, &newPaths);
+        // Connect with nearby nodes
+        for (std::size_t i = 1; i < nearbyTotal; ++i) {
+            // Do not allow to make another path network
+            crunchPath(node, subnodes[i], true, &newPaths);
+        }
+
+        for (const auto& tile : newPaths) {
+            if (freePaths.insert(tile).second) {
+                paths.insert(tile);
+            }
+        }
+    }
+
+    // Make sure they are clear
+    for (const auto& node : nodes) {
+        mapGenerator->setOccupied(node, TileType::Free);
+    }
+
+    // Now block most distant tiles away from passages
+    for (const auto& tile : tileInfo) {
+        if (!mapGenerator->isPossible(tile) || freePaths.count(tile)) {
+            continue;
+        }
+
+        if (!paths.hasPositionWithin(tile, blockDistance)) {
+            // This tile is far enough from passages
+            mapGenerator->setOccupied(tile, TileType::Blocked);
+        }
+    }
+}
+
 void TemplateZone::placeCapital()
 {
-    auto& rand{mapGenerator->randomGenerator};
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::placeCapital", "zone " + std::to_string(id));
+
+    auto& rand{randomGenerator};
 
     // Create capital id
     auto capitalId{mapGenerator->createId(CMidgardID::Type::Fortification)};
@@ -2528,20 +2630,20 @@ void TemplateZone::placeCapital()
     fort->setOwner(ownerId);
 
     if (capital.name.empty()) {
-        fort->setName(*getRandomElement(getGameInfo()->getCityNames(), rand));
+        fort->setName(*getRandomElement(context.getGameInfo().getCityNames(), rand));
     } else {
         fort->setName(capital.name);
     }
 
     fort->setAiPriority(capital.aiPriority);
 
-    auto ownerPlayer{mapGenerator->map->find<Player>(ownerId)};
+    auto ownerPlayer{mapGenerator->find<Player>(ownerId)};
     assert(ownerPlayer != nullptr);
 
     auto playerRace{mapGenerator->getRaceType(ownerPlayer->getRace())};
 
-    const auto& raceInfo{getGameInfo()->getRaceInfo(playerRace)};
-    const auto& unitsInfo{getGameInfo()->getUnits()};
+    const auto& raceInfo{context.getGameInfo().getRaceInfo(playerRace)};
+    const auto& unitsInfo{context.getGameInfo().getUnits()};
 
     const auto& garrison{capital.garrison};
 
@@ -2593,7 +2695,7 @@ void TemplateZone::placeCapital()
     auto leader{std::make_unique<Unit>(leaderId)};
     leader->setImplId(leaderInfo->getUnitId());
     leader->setHp(leaderInfo->getHp());
-    leader->setName(getUnitName(*leaderInfo, rand, false));
+    leader->setName(getUnitName(context.getGameInfo(), *leaderInfo, rand, false));
     mapGenerator->insertObject(std::move(leader));
 
     // Create starting stack
@@ -2639,7 +2741,7 @@ void TemplateZone::placeCapital()
     placeObject(std::move(stack), fort->getPosition());
 
     // If there are known spells specified for player, add them
-    KnownSpells* knownSpells{mapGenerator->map->find<KnownSpells>(ownerPlayer->getSpellsId())};
+    KnownSpells* knownSpells{mapGenerator->find<KnownSpells>(ownerPlayer->getSpellsId())};
     assert(knownSpells);
 
     for (const auto& spellId : capital.spells) {
@@ -2649,6 +2751,8 @@ void TemplateZone::placeCapital()
 
 void TemplateZone::placeCities()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::placeCities", "zone " + std::to_string(id));
+
     if (mapGenerator->isDebugMode()) {
         std::cout << "Creating cities\n";
     }
@@ -2666,7 +2770,7 @@ void TemplateZone::placeCities()
         while (true) {
             if (!findPlaceForObject(mapElement, minDistance, position)) {
                 throw LackOfSpaceException(std::string("Failed to place city in zone ")
-                                           + std::to_string(id) + " due to lack of space");
+                                           + std::to_string(id) + " due to lack of space", id);
             }
 
             if (tryToPlaceObjectAndConnectToPath(mapElement, position)
@@ -2685,6 +2789,8 @@ void TemplateZone::placeCities()
 
 void TemplateZone::placeMerchants()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::placeMerchants", "zone " + std::to_string(id));
+
     for (const auto& merchantInfo : merchants) {
         MapElement mapElement{Position{3, 3}};
         Position position;
@@ -2693,7 +2799,7 @@ void TemplateZone::placeMerchants()
         while (true) {
             if (!findPlaceForObject(mapElement, minDistance, position)) {
                 throw LackOfSpaceException(std::string("Failed to place merchant in zone ")
-                                           + std::to_string(id) + " due to lack of space");
+                                           + std::to_string(id) + " due to lack of space", id);
             }
 
             if (tryToPlaceObjectAndConnectToPath(mapElement, position)
@@ -2712,6 +2818,8 @@ void TemplateZone::placeMerchants()
 
 void TemplateZone::placeMages()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::placeMages", "zone " + std::to_string(id));
+
     for (const auto& mageInfo : mages) {
         MapElement mapElement{Position{3, 3}};
         Position position;
@@ -2720,7 +2828,7 @@ void TemplateZone::placeMages()
         while (true) {
             if (!findPlaceForObject(mapElement, minDistance, position)) {
                 throw LackOfSpaceException(std::string("Failed to place mage in zone ")
-                                           + std::to_string(id) + " due to lack of space");
+                                           + std::to_string(id) + " due to lack of space", id);
             }
 
             if (tryToPlaceObjectAndConnectToPath(mapElement, position)
@@ -2739,6 +2847,8 @@ void TemplateZone::placeMages()
 
 void TemplateZone::placeMercenaries()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::placeMercenaries", "zone " + std::to_string(id));
+
     for (const auto& mercInfo : mercenaries) {
         MapElement mapElement{Position{3, 3}};
         Position position;
@@ -2747,7 +2857,7 @@ void TemplateZone::placeMercenaries()
         while (true) {
             if (!findPlaceForObject(mapElement, minDistance, position)) {
                 throw LackOfSpaceException(std::string("Failed to place mercenary in zone ")
-                                           + std::to_string(id) + " due to lack of space");
+                                           + std::to_string(id) + " due to lack of space", id);
             }
 
             if (tryToPlaceObjectAndConnectToPath(mapElement, position)
@@ -2766,6 +2876,8 @@ void TemplateZone::placeMercenaries()
 
 void TemplateZone::placeTrainers()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::placeTrainers", "zone " + std::to_string(id));
+
     for (const auto& trainerInfo : trainers) {
         MapElement mapElement{Position{3, 3}};
         Position position;
@@ -2774,7 +2886,7 @@ void TemplateZone::placeTrainers()
         while (true) {
             if (!findPlaceForObject(mapElement, minDistance, position)) {
                 throw LackOfSpaceException(std::string("Failed to place trainer in zone ")
-                                           + std::to_string(id) + " due to lack of space");
+                                           + std::to_string(id) + " due to lack of space", id);
             }
 
             if (tryToPlaceObjectAndConnectToPath(mapElement, position)
@@ -2793,6 +2905,8 @@ void TemplateZone::placeTrainers()
 
 void TemplateZone::placeMarkets()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::placeMarkets", "zone " + std::to_string(id));
+
     for (const auto& marketInfo : markets) {
         MapElement mapElement{Position{3, 3}};
         Position position;
@@ -2801,7 +2915,7 @@ void TemplateZone::placeMarkets()
         while (true) {
             if (!findPlaceForObject(mapElement, minDistance, position)) {
                 throw LackOfSpaceException(std::string("Failed to place resource market in zone ")
-                                           + std::to_string(id) + " due to lack of space");
+                                           + std::to_string(id) + " due to lack of space", id);
             }
 
             if (tryToPlaceObjectAndConnectToPath(mapElement, position)
@@ -2820,6 +2934,8 @@ void TemplateZone::placeMarkets()
 
 void TemplateZone::placeRuins()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::placeRuins", "zone " + std::to_string(id));
+
     for (const auto& ruinInfo : ruins) {
         MapElement mapElement{Position{3, 3}};
         Position position;
@@ -2828,7 +2944,7 @@ void TemplateZone::placeRuins()
         while (true) {
             if (!findPlaceForObject(mapElement, minDistance, position)) {
                 throw LackOfSpaceException(std::string("Failed to place ruin in zone ")
-                                           + std::to_string(id) + " due to lack of space");
+                                           + std::to_string(id) + " due to lack of space", id);
             }
 
             if (tryToPlaceObjectAndConnectToPath(mapElement, position)
@@ -2847,6 +2963,8 @@ void TemplateZone::placeRuins()
 
 bool TemplateZone::placeMines()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::placeMines", "zone " + std::to_string(id));
+
     const auto zoneHasOwner{ownerId != emptyId};
     auto& map{mapGenerator->map};
     auto nativeResource{map->getNativeResource(RaceType::Neutral)};
@@ -2896,6 +3014,8 @@ bool TemplateZone::placeMines()
 
 void TemplateZone::placeStacks()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::placeStacks", "zone " + std::to_string(id));
+
     // Compute how many stacks we have in total
     const std::size_t stacksTotal = std::accumulate(stacks.stackGroups.begin(),
                                                     stacks.stackGroups.end(), 0u,
@@ -2915,7 +3035,7 @@ void TemplateZone::placeStacks()
         while (true) {
             if (!findPlaceForObject(mapElement, minDistance, position)) {
                 throw LackOfSpaceException(std::string("Failed to place stacks in zone ")
-                                           + std::to_string(id) + " due to lack of space");
+                                           + std::to_string(id) + " due to lack of space", id);
             }
 
             if (tryToPlaceObjectAndConnectToPath(mapElement, position)
@@ -2929,7 +3049,7 @@ void TemplateZone::placeStacks()
         }
     }
 
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // Make sure stacks from different groups are mixed on the map
     randomShuffle(positions, rand);
@@ -2967,7 +3087,7 @@ void TemplateZone::placeStacks()
             stack->setSubrace(subraceId);
 
             if (!stackGroup.name.empty()) {
-                Unit* leader{mapGenerator->map->find<Unit>(stack->getLeader())};
+                Unit* leader{mapGenerator->find<Unit>(stack->getLeader())};
                 if (leader) {
                     leader->setName(stackGroup.name);
                 }
@@ -3036,6 +3156,8 @@ void TemplateZone::placeStacks()
 
 void TemplateZone::placeBags()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::placeBags", "zone " + std::to_string(id));
+
     if (!bags.count) {
         return;
     }
@@ -3067,7 +3189,7 @@ void TemplateZone::placeBags()
         requiredItems.insert(requiredItems.end(), amount, id);
     }
 
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // Place required items in the bags randomly
     for (const auto& id : requiredItems) {
@@ -3086,7 +3208,7 @@ void TemplateZone::placeBags()
         while (true) {
             if (!findPlaceForObject(mapElement, minDistance, position)) {
                 throw LackOfSpaceException(std::string("Failed to place bags in zone ")
-                                           + std::to_string(id) + " due to lack of space");
+                                           + std::to_string(id) + " due to lack of space", id);
             }
 
             if (tryToPlaceObjectAndConnectToPath(mapElement, position)
@@ -3123,6 +3245,9 @@ void TemplateZone::placeBags()
 
 bool TemplateZone::createRequiredObjects()
 {
+    RSG_PROFILE_SCOPE_DETAIL("TemplateZone::createRequiredObjects",
+                             "zone " + std::to_string(id));
+
     if (mapGenerator->isDebugMode()) {
         std::cout << "Creating required objects\n";
     }
@@ -3147,7 +3272,7 @@ bool TemplateZone::createRequiredObjects()
             if (!findPlaceForObject(objectSize.isValid() ? MapElement{objectSize} : *mapElement,
                                     minDistance, position)) {
                 throw LackOfSpaceException(std::string("Failed to fill zone ") + std::to_string(id)
-                                           + " due to lack of space");
+                                           + " due to lack of space", id);
             }
 
             // If specific size was requested, place object at the center of found area
@@ -3168,7 +3293,7 @@ bool TemplateZone::createRequiredObjects()
                 break;
             } else {
                 throw LackOfSpaceException(std::string("Failed to fill zone ") + std::to_string(id)
-                                           + " due to lack of space");
+                                           + " due to lack of space", id);
             }
         }
     }
@@ -3236,7 +3361,7 @@ bool TemplateZone::createRequiredObjects()
 
             if (tiles.empty()) {
                 throw LackOfSpaceException(std::string("Failed to fill zone ") + std::to_string(id)
-                                           + " due to lack of space");
+                                           + " due to lack of space", id);
             }
 
             for (const auto& tile : tiles) {
@@ -3283,7 +3408,7 @@ bool TemplateZone::createRequiredObjects()
 
         if (!objectPlaced) {
             throw LackOfSpaceException(std::string("Failed to fill zone ") + std::to_string(id)
-                                       + " due to lack of space");
+                                       + " due to lack of space", id);
         }
     }
 
@@ -3317,16 +3442,6 @@ bool TemplateZone::findPlaceForObject(const std::set<Position>& area,
             continue;
         }
 
-        if (findAccessible) {
-            if (!isAccessibleFromSomewhere(mapElement, tile)) {
-                continue;
-            }
-
-            if (!isEntranceAccessible(mapElement, tile)) {
-                continue;
-            }
-        }
-
         const bool isPossible{mapGenerator->isPossible(tile)};
         if (!isPossible) {
             continue;
@@ -3338,13 +3453,26 @@ bool TemplateZone::findPlaceForObject(const std::set<Position>& area,
         const bool distanceMoreThanMin{distance >= minDistance};
         const bool distanceMoreThanBest{distance > bestDistance};
 
-        if (distanceMoreThanMin && distanceMoreThanBest) {
-            if (areAllTilesAvailable(mapElement, tile, blockedOffsets)) {
-                bestDistance = distance;
-                position = tile;
-                result = true;
+        if (!distanceMoreThanMin || !distanceMoreThanBest) {
+            continue;
+        }
+
+        // Accessibility checks are the most expensive ones, do them last
+        if (findAccessible) {
+            if (!isAccessibleFromSomewhere(mapElement, tile)) {
+                continue;
+            }
+
+            if (!isEntranceAccessible(mapElement, tile)) {
+                continue;
             }
         }
+
+        if (areAllTilesAvailable(mapElement, tile, blockedOffsets)) {
+            bestDistance = distance;
+            position = tile;
+            result = true;
+        }
     }
 
     return result;
@@ -3505,24 +3633,23 @@ bool TemplateZone::isInTheZone(const Position& position) const
 
 bool TemplateZone::createRoad(const Position& source, const Position& destination)
 {
+    RSG_PROFILE_SCOPE("TemplateZone::createRoad");
+
     // A* algorithm
 
-    // The set of nodes already evaluated
-    std::set<Position> closed;
+    // Nodes already evaluated, navigated nodes and distances to them
+    auto& search{pathSearch};
+    search.begin(mapGenerator->mapGenOptions.size);
     // The set of tentative nodes to be evaluated, initially containing the start node
     PriorityQueue queue;
-    // The map of navigated nodes
-    std::map<Position, Position> cameFrom;
-    std::map<Position, float> distances;
 
     // Just in case zone guard already has road under it
     // Road under nodes will be added at very end
     mapGenerator->setRoad(source, false);
 
     // First node points to finish condition
-    cameFrom[source] = Position{-1, -1};
+    search.setDistance(source, 0.f, Position{-1, -1});
     queue.push({source, 0.f});
-    distances[source] = 0.f;
     // Cost from start along best known path
 
     RoadInfo road;
@@ -3534,52 +3661,51 @@ bool TemplateZone::createRoad(const Position& source, const Position& destinatio
         queue.pop();
 
         auto& currentNode{node.first};
-        closed.insert(currentNode);
+        search.close(currentNode);
 
         if (currentNode == destination || mapGenerator->isRoad(currentNode)) {
             // The goal node was reached.
             // Trace the path using the saved parent information and return path
             Position backtracking{currentNode};
-            while (cameFrom[backtracking].isValid()) {
+            while (search.getCameFrom(backtracking).isValid()) {
                 // Add node to path
-                road.path.push({backtracking, distances[backtracking]});
+                float distance{};
+                search.getDistance(backtracking, distance);
+
+                road.path.push({backtracking, distance});
                 mapGenerator->setRoad(backtracking, true);
-                backtracking = cameFrom[backtracking];
+                backtracking = search.getCameFrom(backtracking);
             }
 
             roads.push_back(road);
             return true;
         }
 
-        const auto& currentTile{mapGenerator->map->getTile(currentNode)};
+        const auto& currentTile{mapGenerator->getMapTile(currentNode)};
         bool directNeighbourFound{false};
         float movementCost{1.f};
 
-        auto functor = [this, &queue, &distances, &closed, &cameFrom, &currentNode, &currentTile,
-                        &node, &destination, &directNeighbourFound, &movementCost](Position& p) {
-            if (contains(closed, p)) {
+        auto functor = [this, &queue, &search, &currentNode, &currentTile, &node, &destination,
+                        &directNeighbourFound, &movementCost](Position& p) {
+            if (search.isClosed(p)) {
                 // We already visited that node
                 return;
             }
 
             float distance{node.second + movementCost};
             float bestDistanceSoFar{std::numeric_limits<float>::max()};
-
-            auto it{distances.find(p)};
-            if (it != distances.end()) {
-                bestDistanceSoFar = it->second;
-            }
+            search.getDistance(p, bestDistanceSoFar);
 
             if (distance >= bestDistanceSoFar) {
                 return;
             }
 
-            auto& tile{mapGenerator->map->getTile(p)};
+            const auto& tile{mapGenerator->getMapTile(p)};
             if (tile.isWater()) {
                 return;
             }
 
-            const auto canMoveBetween{mapGenerator->map->canMoveBetween(currentNode, p)};
+            const auto canMoveBetween{mapGenerator->canMoveBetween(currentNode, p)};
 
             const auto emptyPath{mapGenerator->isFree(p) && mapGenerator->isFree(currentNode)};
             // Moving from or to visitable object
@@ -3590,8 +3716,7 @@ bool TemplateZone::createRoad(const Position& source, const Position& destinatio
             if (emptyPath || visitable || completed) {
                 // Otherwise guard position may appear already connected to other zone.
                 if (mapGenerator->getZoneId(p) == id || completed) {
-                    cameFrom[p] = currentNode;
-                    distances[p] = distance;
+                    search.setDistance(p, distance, currentNode);
                     queue.push({p, distance});
                     directNeighbourFound = true;
                 }
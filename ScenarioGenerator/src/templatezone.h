@@ -21,7 +21,10 @@
 
 #include "decoration.h"
 #include "gameinfo.h"
+#include "generationcontext.h"
+#include "pathsearch.h"
 #include "position.h"
+#include "randomgenerator.h"
 #include "scenario/bag.h"
 #include "scenario/crystal.h"
 #include "scenario/fortification.h"
@@ -65,11 +68,26 @@ struct RoadInfo
     Position destination;
 };
 
+// Value picked from template range and value of objects actually created for it
+struct CreatedValue
+{
+    int requested{};
+    int created{};
+};
+
+// Values of zone contents collected during zone fill
+struct ZoneStatistics
+{
+    std::vector<CreatedValue> stacks;
+    std::vector<CreatedValue> loot;
+};
+
 // Describes zone in a template
 struct TemplateZone : public ZoneOptions
 {
-    TemplateZone(MapGenerator* mapGenerator)
+    TemplateZone(MapGenerator* mapGenerator, const GenerationContext& context)
         : mapGenerator{mapGenerator}
+        , context{context}
     { }
 
     const VPosition& getCenter() const
@@ -94,9 +112,16 @@ struct TemplateZone : public ZoneOptions
         ZoneOptions::operator=(options);
     }
 
+    // Zone uses its own random generator, so its contents do not depend on other zones
+    void setRandomGenerator(const RandomGenerator& generator)
+    {
+        randomGenerator = generator;
+    }
+
+    // Adding tiles in ascending order takes constant time
     void addTile(const Position& position)
     {
-        tileInfo.insert(position);
+        tileInfo.insert(tileInfo.end(), position);
     }
 
     void removeTile(const Position& position)
@@ -110,6 +135,16 @@ struct TemplateZone : public ZoneOptions
         tileInfo.clear();
     }
 
+    // Restores placement made by zone placer as is
+    void setPlacement(const VPosition& zoneCenter,
+                      const Position& position,
+                      const std::set<Position>& tiles)
+    {
+        center = zoneCenter;
+        pos = position;
+        tileInfo = tiles;
+    }
+
     const std::set<Position>& getTileInfo() const
     {
         return tileInfo;
@@ -130,6 +165,9 @@ struct TemplateZone : public ZoneOptions
     void initTowns();
     void initFreeTiles();
     void createBorder();
+    // Compares tiles left for zone contents with space they need,
+    // throws LackOfSpaceException if contents can not fit
+    void estimateCapacity();
     void fill();
     void createObstacles();
     void connectRoads();
@@ -243,6 +281,8 @@ struct TemplateZone : public ZoneOptions
 
     void initTerrain();
     void fractalize();
+    // Same as fractalize but uses grids for nearest tile searches, used for large maps
+    void fractalizeLargeMap();
     void placeCapital();
     void placeCities();
     void placeMerchants();
@@ -276,6 +316,11 @@ struct TemplateZone : public ZoneOptions
 
     const std::vector<RoadInfo>& getRoads() const;
 
+    const ZoneStatistics& getStatistics() const
+    {
+        return statistics;
+    }
+
     // Returns true if tile with specified position belongs to zone
     bool isInTheZone(const Position& position) const;
 
@@ -283,6 +328,7 @@ private:
     bool createRoad(const Position& source, const Position& destination);
 
     MapGenerator* mapGenerator{};
+    const GenerationContext& context;
 
     // Template info
     TerrainType terrainType{TerrainType::Neutral};
@@ -311,7 +357,10 @@ private:
     std::set<Position> roadNodes;     // Tiles to be connected with roads
 
     std::vector<RoadInfo> roads; // All tiles with roads
+    PathSearch pathSearch;       // Reused by path searches of the zone
+    ZoneStatistics statistics;   // Values of created stacks and loot
     CMidgardID ownerId{emptyId}; // Player assigned to zone
+    RandomGenerator randomGenerator;
 };
 
 } // namespace rsg
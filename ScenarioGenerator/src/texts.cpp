@@ -26,7 +26,10 @@ namespace rsg {
 
 static const char* emptyName = "Guard";
 
-const char* getUnitName(const UnitInfo& info, RandomGenerator& rand, bool neutralOwner)
+const char* getUnitName(const GameInfo& gameInfo,
+                        const UnitInfo& info,
+                        RandomGenerator& rand,
+                        bool neutralOwner)
 {
     if (!isLeader(info)) {
         // Only leader units have names
@@ -34,7 +37,7 @@ const char* getUnitName(const UnitInfo& info, RandomGenerator& rand, bool neutra
         return emptyName;
     }
 
-    const RacesInfo& races{getGameInfo()->getRacesInfo()};
+    const RacesInfo& races{gameInfo.getRacesInfo()};
 
     const auto it{races.find(info.getRaceId())};
     if (it == races.end()) {
@@ -45,7 +48,7 @@ const char* getUnitName(const UnitInfo& info, RandomGenerator& rand, bool neutra
 
     const RaceInfo& race{*it->second.get()};
     if (neutralOwner || isRaceUnplayable(race.getRaceType())) {
-        return getGameInfo()->getGlobalText(info.getNameId());
+        return gameInfo.getGlobalText(info.getNameId());
     }
 
     const LeaderNames& leaderNames{race.getLeaderNames()};
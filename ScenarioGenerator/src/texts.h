@@ -21,9 +21,13 @@
 
 namespace rsg {
 
+class GameInfo;
 class UnitInfo;
 class RandomGenerator;
 
-const char* getUnitName(const UnitInfo& info, RandomGenerator& rand, bool neutralOwner);
+const char* getUnitName(const GameInfo& gameInfo,
+                        const UnitInfo& info,
+                        RandomGenerator& rand,
+                        bool neutralOwner);
 
 } // namespace rsg
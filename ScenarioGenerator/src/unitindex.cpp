@@ -0,0 +1,109 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unitindex.h"
+#include "forbiddenfilter.h"
+#include "picker.h"
+#include <vector>
+
+namespace rsg {
+
+static UnitIndex::Placement getPlacement(const UnitInfo& info)
+{
+    if (info.isBig()) {
+        return UnitIndex::Big;
+    }
+
+    if (info.getAttackReach() == ReachType::Adjacent) {
+        return UnitIndex::Melee;
+    }
+
+    return isSupport(info) ? UnitIndex::Support : UnitIndex::Ranged;
+}
+
+UnitIndex::UnitIndex(const Catalog& catalog, const ForbiddenFilter& forbidden)
+{
+    addUnits(leaders, catalog.getLeaders(), forbidden);
+    addUnits(soldiers, catalog.getSoldiers(), forbidden);
+}
+
+const UnitInfo* UnitIndex::pickLeader(RandomGenerator& random,
+                                      const std::set<SubRaceType>& subraces,
+                                      std::uint8_t placements,
+                                      int minValue,
+                                      int maxValue) const
+{
+    return pick(leaders, random, subraces, placements, minValue, maxValue);
+}
+
+const UnitInfo* UnitIndex::pickSoldier(RandomGenerator& random,
+                                       const std::set<SubRaceType>& subraces,
+                                       std::uint8_t placements,
+                                       int minValue,
+                                       int maxValue) const
+{
+    return pick(soldiers, random, subraces, placements, minValue, maxValue);
+}
+
+void UnitIndex::addUnits(Buckets& buckets,
+                         const UnitInfoArray& units,
+                         const ForbiddenFilter& forbidden)
+{
+    // Catalog pools are sorted by value, filtered copies stay sorted
+    for (auto unit : units) {
+        if (forbidden.isForbidden(unit)) {
+            continue;
+        }
+
+        buckets[{unit->getSubrace(), getPlacement(*unit)}].push_back(unit);
+    }
+}
+
+const UnitInfo* UnitIndex::pick(const Buckets& buckets,
+                                RandomGenerator& random,
+                                const std::set<SubRaceType>& subraces,
+                                std::uint8_t placements,
+                                int minValue,
+                                int maxValue)
+{
+    if (minValue > maxValue) {
+        return nullptr;
+    }
+
+    // Subraces are read from game data as is, mods could add more of them
+    std::vector<PoolRange<UnitInfo>> ranges;
+    ranges.reserve(buckets.size());
+
+    for (const auto& [key, pool] : buckets) {
+        const auto& [subrace, placement] = key;
+        if (!(placements & placement)) {
+            continue;
+        }
+
+        if (!subraces.empty() && subraces.find(subrace) == subraces.end()) {
+            continue;
+        }
+
+        ranges.push_back(getValueRange(pool, minValue, maxValue));
+    }
+
+    return pickFromRanges(ranges.cbegin(), ranges.cend(), random);
+}
+
+} // namespace rsg
@@ -0,0 +1,87 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "catalog.h"
+#include <cstdint>
+#include <map>
+#include <set>
+
+namespace rsg {
+
+class ForbiddenFilter;
+class RandomGenerator;
+
+// Leaders and soldiers allowed in stacks of a single template.
+// Pools are partitioned by subrace and group placement, sorted by value in ascending order.
+// Units forbidden globally or by template are excluded beforehand
+class UnitIndex
+{
+public:
+    // Unit placement in group, values can be combined into a mask for picking
+    enum Placement : std::uint8_t
+    {
+        Melee = 1,   // Small unit with adjacent attack reach
+        Ranged = 2,  // Small unit that attacks from the back line
+        Support = 4, // Small unit from the back line that heals or casts wards, boosts, etc.
+        Big = 8,
+        Any = Melee | Ranged | Support | Big,
+    };
+
+    UnitIndex(const Catalog& catalog, const ForbiddenFilter& forbidden);
+
+    // Picks random leader with value in [minValue : maxValue] range.
+    // Empty subraces set allows leaders of any subrace.
+    // Returns nullptr if there are no suitable leaders
+    const UnitInfo* pickLeader(RandomGenerator& random,
+                               const std::set<SubRaceType>& subraces,
+                               std::uint8_t placements,
+                               int minValue,
+                               int maxValue) const;
+
+    // Picks random soldier with value in [minValue : maxValue] range.
+    // Empty subraces set allows soldiers of any subrace.
+    // Returns nullptr if there are no suitable soldiers
+    const UnitInfo* pickSoldier(RandomGenerator& random,
+                                const std::set<SubRaceType>& subraces,
+                                std::uint8_t placements,
+                                int minValue,
+                                int maxValue) const;
+
+private:
+    using Key = std::pair<SubRaceType, Placement>;
+    using Buckets = std::map<Key, UnitInfoArray>;
+
+    static void addUnits(Buckets& buckets,
+                         const UnitInfoArray& units,
+                         const ForbiddenFilter& forbidden);
+
+    static const UnitInfo* pick(const Buckets& buckets,
+                                RandomGenerator& random,
+                                const std::set<SubRaceType>& subraces,
+                                std::uint8_t placements,
+                                int minValue,
+                                int maxValue);
+
+    Buckets leaders;
+    Buckets soldiers;
+};
+
+} // namespace rsg
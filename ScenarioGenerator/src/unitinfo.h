@@ -20,10 +20,12 @@
 #pragma once
 
 #include "enums.h"
+#include <cstddef>
 
 namespace rsg {
 
 class CMidgardID;
+class GameInfo;
 
 // Information about unit from GUnits, GAttacks and LAttR.dbf
 class UnitInfo
@@ -51,8 +53,19 @@ public:
     virtual bool isBig() const = 0;
     virtual bool isMale() const = 0;
 
+    // Returns stable index of unit in game catalog
+    std::size_t getCatalogIndex() const
+    {
+        return catalogIndex;
+    }
+
 protected:
     UnitInfo() = default;
+
+private:
+    friend void assignCatalogIndices(GameInfo& gameInfo);
+
+    std::size_t catalogIndex{};
 };
 
 } // namespace rsg
@@ -18,27 +18,24 @@
  */
 
 #include "unitpicker.h"
-#include "containers.h"
-#include "gameinfo.h"
-#include "generatorsettings.h"
+#include "generationcontext.h"
 #include "picker.h"
 #include <iterator>
 
 namespace rsg {
 
-UnitInfo* pickLeader(RandomGenerator& random, const UnitFilterList& filters)
+UnitInfo* pickLeader(const GenerationContext& context,
+                     RandomGenerator& random,
+                     const UnitFilterList& filters)
 {
-    return pick(getGameInfo()->getLeaders(), random, filters);
+    return pick(context.getCatalog().getLeaders(), random, filters);
 }
 
-UnitInfo* pickUnit(RandomGenerator& random, const UnitFilterList& filters)
+UnitInfo* pickUnit(const GenerationContext& context,
+                   RandomGenerator& random,
+                   const UnitFilterList& filters)
 {
-    return pick(getGameInfo()->getSoldiers(), random, filters);
-}
-
-bool noForbiddenUnit(const UnitInfo* info)
-{
-    return contains(getGeneratorSettings().forbiddenUnits, info->getUnitId());
+    return pick(context.getCatalog().getSoldiers(), random, filters);
 }
 
 bool noPlayableRaces(const UnitInfo* info)
@@ -23,6 +23,7 @@
 
 namespace rsg {
 
+class GenerationContext;
 class UnitInfo;
 class RandomGenerator;
 
@@ -32,15 +33,17 @@ using UnitFilterFunc = std::function<bool(const UnitInfo*)>;
 using UnitFilterList = std::initializer_list<UnitFilterFunc>;
 
 // Picks random leader from list after applying filters
-UnitInfo* pickLeader(RandomGenerator& random, const UnitFilterList& filters);
+UnitInfo* pickLeader(const GenerationContext& context,
+                     RandomGenerator& random,
+                     const UnitFilterList& filters);
 
 // Picks random soldier from list after applying filters
-UnitInfo* pickUnit(RandomGenerator& random, const UnitFilterList& filters);
+UnitInfo* pickUnit(const GenerationContext& context,
+                   RandomGenerator& random,
+                   const UnitFilterList& filters);
 
 // These below are predefined filters
 
-// Remove units that are forbidden in generator settings from pick
-bool noForbiddenUnit(const UnitInfo* info);
 // Removes units of playable subraces from pick
 bool noPlayableRaces(const UnitInfo* info);
 // Removes big units
@@ -0,0 +1,103 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "zonefillbuffer.h"
+#include "map.h"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace rsg {
+
+ZoneFillBuffer::ZoneFillBuffer(const Map& map, TemplateZoneId zoneId, int lane, int lanesTotal)
+    : map{&map}
+    , zoneId{zoneId}
+{
+    for (std::size_t i = 0; i < baseIndices.size(); ++i) {
+        const int freeIndex{map.getFreeIdIndex(static_cast<CMidgardID::Type>(i))};
+        const int blockSize{std::max(0, maxIdTypeIndex + 1 - freeIndex) / lanesTotal};
+
+        baseIndices[i] = freeIndex;
+        beginIndices[i] = freeIndex + blockSize * lane;
+        endIndices[i] = beginIndices[i] + blockSize;
+        nextIndices[i] = beginIndices[i];
+    }
+}
+
+CMidgardID ZoneFillBuffer::createId(CMidgardID::Type type)
+{
+    const auto typeIndex{static_cast<std::size_t>(type)};
+    if (nextIndices[typeIndex] >= endIndices[typeIndex]) {
+        std::stringstream stream;
+        stream << "Zone " << zoneId << " has too many objects of type "
+               << static_cast<int>(type) << " to fill zones in parallel";
+
+        throw std::runtime_error(stream.str());
+    }
+
+    return map->createId(type, nextIndices[typeIndex]++);
+}
+
+int ZoneFillBuffer::getFreeIdIndex(CMidgardID::Type type) const
+{
+    const auto typeIndex{static_cast<std::size_t>(type)};
+    if (nextIndices[typeIndex] == beginIndices[typeIndex]) {
+        return baseIndices[typeIndex];
+    }
+
+    return nextIndices[typeIndex];
+}
+
+bool ZoneFillBuffer::insertObject(ScenarioObjectPtr&& object)
+{
+    auto objectPtr{object.get()};
+    if (!objectsById.emplace(objectPtr->getId(), objectPtr).second) {
+        return false;
+    }
+
+    const auto index{objects.size()};
+    objects.push_back(std::move(object));
+
+    changes.push_back([this, index](Map& map) { map.insertObject(std::move(objects[index])); });
+    return true;
+}
+
+ScenarioObject* ZoneFillBuffer::find(const CMidgardID& objectId) const
+{
+    const auto it{objectsById.find(objectId)};
+    return it != objectsById.end() ? it->second : nullptr;
+}
+
+void ZoneFillBuffer::defer(Change&& change)
+{
+    changes.push_back(std::move(change));
+}
+
+void ZoneFillBuffer::merge(Map& map)
+{
+    for (auto& change : changes) {
+        change(map);
+    }
+
+    changes.clear();
+    objects.clear();
+    objectsById.clear();
+}
+
+} // namespace rsg
@@ -0,0 +1,85 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "rsgid.h"
+#include "scenarioobject.h"
+#include "zoneid.h"
+#include <array>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace rsg {
+
+class Map;
+
+// Scenario changes made by a single zone while zones are filled in parallel.
+// Ids are created in the zone's own lane: free type indices of the map are split
+// into n contiguous blocks of equal size and lane i uses block i, so zones never create
+// the same id. Lane that runs out of its block throws std::runtime_error.
+// Objects and changes of shared state are kept aside and merged in the order they were made
+class ZoneFillBuffer
+{
+public:
+    using Change = std::function<void(Map&)>;
+
+    ZoneFillBuffer(const Map& map, TemplateZoneId zoneId, int lane, int lanesTotal);
+
+    // Returns id of zone that owns the buffer
+    TemplateZoneId getZoneId() const
+    {
+        return zoneId;
+    }
+
+    CMidgardID createId(CMidgardID::Type type);
+
+    // Returns type index following the last one created in this lane,
+    // or free index of the map at buffer creation if lane did not create ids of specified type
+    int getFreeIdIndex(CMidgardID::Type type) const;
+
+    bool insertObject(ScenarioObjectPtr&& object);
+
+    // Returns buffered object with specified id or nullptr
+    ScenarioObject* find(const CMidgardID& objectId) const;
+
+    void defer(Change&& change);
+
+    // Moves buffered objects into map and applies deferred changes.
+    // Id lane stays the same, buffer can be used for the next phase
+    void merge(Map& map);
+
+private:
+    using TypeIndices = std::array<int, static_cast<std::size_t>(CMidgardID::Type::Invalid)>;
+
+    const Map* map{};
+    TemplateZoneId zoneId{};
+    TypeIndices baseIndices{};
+    // Lane block of each type is [begin : end)
+    TypeIndices beginIndices{};
+    TypeIndices endIndices{};
+    TypeIndices nextIndices{};
+
+    std::vector<ScenarioObjectPtr> objects;
+    std::unordered_map<CMidgardID, ScenarioObject*, CMidgardIDHash> objectsById;
+    std::vector<Change> changes;
+};
+
+} // namespace rsg
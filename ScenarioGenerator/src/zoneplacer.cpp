@@ -156,7 +156,7 @@ void ZonePlacer::assignZones()
     // Yes, copy them
     auto zones = mapGenerator->zones;
 
-    using DistPair = std::pair<std::shared_ptr<TemplateZone>, float>;
+    using DistPair = std::pair<TemplateZone*, float>;
     std::vector<DistPair> distances(zones.size());
 
     auto compareByDistance = [](const DistPair& a, const DistPair& b) -> bool {
@@ -182,13 +182,14 @@ void ZonePlacer::assignZones()
 
     // 1. Create Voronoi diagram
     // 2. Find current center of mass for each zone. Move zone to that center to balance zones sizes
-    for (int i = 0; i < mapWidth; ++i) {
-        for (int j = 0; j < mapHeight; ++j) {
+    // Tiles are visited row by row, in the same order they are stored in zone areas
+    for (int j = 0; j < mapHeight; ++j) {
+        for (int i = 0; i < mapWidth; ++i) {
             distances.clear();
 
             Position pos{i, j};
             for (auto& zone : zones) {
-                distances.push_back({zone.second, static_cast<float>(pos.distanceSquared(
+                distances.push_back({zone.second.get(), static_cast<float>(pos.distanceSquared(
                                                       zone.second->getPosition()))});
             }
 
@@ -209,13 +210,13 @@ void ZonePlacer::assignZones()
         zone.second->clearTiles();
     }
 
-    for (int i = 0; i < mapWidth; ++i) {
-        for (int j = 0; j < mapHeight; ++j) {
+    for (int j = 0; j < mapHeight; ++j) {
+        for (int i = 0; i < mapWidth; ++i) {
             distances.clear();
 
             Position pos{i, j};
             for (auto& zone : zones) {
-                distances.push_back({zone.second, metric(pos, zone.second->getPosition())});
+                distances.push_back({zone.second.get(), metric(pos, zone.second->getPosition())});
             }
 
             auto it{std::min_element(distances.begin(), distances.end(), compareByDistance)};
@@ -0,0 +1,890 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "batchrunner.h"
+#include "cancellationtoken.h"
+#include "exceptions.h"
+#include "generationattempts.h"
+#include "generationcontext.h"
+#include "image.h"
+#include "luastatepool.h"
+#include "mapgenerator.h"
+#include "maptemplate.h"
+#include "maptemplatereader.h"
+#include "previewrasterizer.h"
+#include "profiler.h"
+#include "templatecache.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <sol/sol.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace rsg {
+
+using BatchClock = std::chrono::steady_clock;
+
+// Template shared by all jobs that use it
+struct BatchTemplate
+{
+    MapTemplateSettings settings;
+    std::unique_ptr<LuaStatePool> states;
+    // Reason template could not be loaded
+    std::string error;
+};
+
+// Single scenario to generate
+struct BatchTask
+{
+    const BatchJob* job{};
+    std::size_t jobIndex{};
+    std::time_t seed{};
+};
+
+struct BatchReport
+{
+    std::filesystem::path scenarioPath;
+    std::vector<RaceType> races;
+    std::vector<std::pair<const char*, std::size_t>> objectCounts;
+    // Empty on success
+    std::string failure;
+    std::string error;
+    // Seed of generated scenario, differs from task seed after retries
+    std::time_t scenarioSeed{};
+    std::size_t attempts{};
+    // Nonzero when zones of scenario were refilled after first fill lacked space
+    std::uint64_t fillSeed{};
+    // Milliseconds
+    double contentsTime{};
+    double generationTime{};
+    double serializationTime{};
+    // Collected in analysis mode
+    std::vector<CreatedValue> stacks;
+    std::vector<CreatedValue> loot;
+    double roadCoverage{};
+    // Zone that lacked space, -1 if not known
+    int failedZone{-1};
+};
+
+// Created values of a job compared with requested ones
+struct ValueAnalysis
+{
+    std::uint64_t requested{};
+    std::uint64_t created{};
+    // Created to requested value ratios of each object with nonzero requested value
+    std::vector<double> ratios;
+};
+
+// Statistics of all scenarios of a single job
+struct JobAnalysis
+{
+    std::size_t scenarios{};
+    std::size_t succeeded{};
+    std::map<std::string, std::size_t> failures;
+    std::map<int, std::size_t> zoneFailures;
+    // Milliseconds of template contents and generation of succeeded scenarios
+    std::vector<double> times;
+    // Object counts of succeeded scenarios, in reportedObjects order
+    std::vector<std::vector<std::size_t>> objectCounts;
+    ValueAnalysis stacks;
+    ValueAnalysis loot;
+    std::vector<double> roadCoverage;
+};
+
+// clang-format off
+static const std::pair<const char*, RaceType> raceNames[] = {
+    {"Human", RaceType::Human},
+    {"Undead", RaceType::Undead},
+    {"Heretic", RaceType::Heretic},
+    {"Dwarf", RaceType::Dwarf},
+    {"Neutral", RaceType::Neutral},
+    {"Elf", RaceType::Elf},
+    {"Random", RaceType::Random},
+};
+
+// Objects counted in report
+static const std::pair<const char*, CMidgardID::Type> reportedObjects[] = {
+    {"fortifications", CMidgardID::Type::Fortification},
+    {"stacks", CMidgardID::Type::Stack},
+    {"units", CMidgardID::Type::Unit},
+    {"items", CMidgardID::Type::Item},
+    {"bags", CMidgardID::Type::Bag},
+    {"sites", CMidgardID::Type::Site},
+    {"ruins", CMidgardID::Type::Ruin},
+    {"crystals", CMidgardID::Type::Crystal},
+    {"landmarks", CMidgardID::Type::Landmark},
+};
+// clang-format on
+
+static const char* getRaceName(RaceType race)
+{
+    for (const auto& [name, type] : raceNames) {
+        if (type == race) {
+            return name;
+        }
+    }
+
+    return "Unknown";
+}
+
+static bool readRace(const std::string& name, RaceType& race)
+{
+    for (const auto& [raceName, type] : raceNames) {
+        if (name == raceName) {
+            race = type;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool readNumber(const std::string& string, long long& number)
+{
+    if (string.empty() || string.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+
+    try {
+        number = std::stoll(string);
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    return true;
+}
+
+static void readJobLine(const std::string& line, BatchJob& job)
+{
+    std::istringstream stream{line};
+
+    std::string templatePath;
+    std::string size;
+    std::string races;
+    std::string seeds;
+    std::string extra;
+    if (!(stream >> std::quoted(templatePath) >> size >> races >> seeds) || (stream >> extra)) {
+        throw std::runtime_error("Expected <template> <size> <races> <seed>[-<last seed>]");
+    }
+
+    job.templatePath = std::filesystem::u8path(templatePath);
+
+    long long number{};
+    if (!readNumber(size, number) || number <= 0) {
+        throw std::runtime_error("Wrong scenario size '" + size + "'");
+    }
+
+    job.size = static_cast<int>(number);
+
+    if (races != "-") {
+        std::istringstream racesStream{races};
+        std::string name;
+
+        while (std::getline(racesStream, name, ',')) {
+            RaceType race{};
+            if (!readRace(name, race)) {
+                throw std::runtime_error("Unknown race '" + name + "'");
+            }
+
+            job.races.push_back(race);
+        }
+    }
+
+    const auto separator{seeds.find('-')};
+    if (!readNumber(seeds.substr(0, separator), number)) {
+        throw std::runtime_error("Wrong seed '" + seeds + "'");
+    }
+
+    job.firstSeed = static_cast<std::time_t>(number);
+
+    if (separator != std::string::npos) {
+        if (!readNumber(seeds.substr(separator + 1), number)) {
+            throw std::runtime_error("Wrong seed range '" + seeds + "'");
+        }
+    }
+
+    job.lastSeed = static_cast<std::time_t>(number);
+
+    if (job.lastSeed < job.firstSeed) {
+        throw std::runtime_error("Empty seed range '" + seeds + "'");
+    }
+}
+
+std::vector<BatchJob> readBatchJobs(const std::filesystem::path& jobsFilePath)
+{
+    std::ifstream stream(jobsFilePath);
+    if (!stream) {
+        throw std::runtime_error("Could not open jobs file " + jobsFilePath.u8string());
+    }
+
+    std::vector<BatchJob> jobs;
+    std::string line;
+
+    for (int lineNumber = 1; std::getline(stream, line); ++lineNumber) {
+        const auto start{line.find_first_not_of(" \t\r")};
+        if (start == std::string::npos || line[start] == '#') {
+            continue;
+        }
+
+        BatchJob job;
+
+        try {
+            readJobLine(line, job);
+        } catch (const std::exception& e) {
+            throw std::runtime_error(jobsFilePath.u8string() + ':' + std::to_string(lineNumber)
+                                     + ": " + e.what());
+        }
+
+        if (job.templatePath.is_relative()) {
+            job.templatePath = jobsFilePath.parent_path() / job.templatePath;
+        }
+
+        jobs.push_back(std::move(job));
+    }
+
+    return jobs;
+}
+
+static double getMilliseconds(BatchClock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(BatchClock::now() - start).count();
+}
+
+static void writeDebugImages(const MapGenerator& generator,
+                             std::filesystem::path zonesImagePath,
+                             std::filesystem::path tilesImagePath)
+{
+    const auto size{static_cast<std::size_t>(generator.mapGenOptions.size)};
+
+    std::vector<RgbColor> zonesPixels(size * size);
+    std::vector<RgbColor> tilesPixels(size * size);
+
+    PreviewRasterizer rasterizer;
+    rasterizer.update(generator,
+                      PreviewImage{reinterpret_cast<std::uint8_t*>(zonesPixels.data()),
+                                   size * sizeof(RgbColor)},
+                      PreviewImage{reinterpret_cast<std::uint8_t*>(tilesPixels.data()),
+                                   size * sizeof(RgbColor)});
+
+    Image zonesImage(size, size, std::move(zonesPixels));
+    zonesImage.write(zonesImagePath);
+
+    Image tilesImage(size, size, std::move(tilesPixels));
+    tilesImage.write(tilesImagePath);
+}
+
+static GenerationAttemptPtr createAttempt(const GenerationContext& context,
+                                          const BatchTemplate& batchTemplate,
+                                          const BatchJob& job,
+                                          const BatchOptions& batchOptions,
+                                          std::time_t seed,
+                                          BatchReport& report)
+{
+    auto attempt{std::make_unique<GenerationAttempt>()};
+    attempt->mapTemplate = std::make_unique<MapTemplate>();
+
+    MapTemplate& mapTemplate{*attempt->mapTemplate};
+    mapTemplate.settings = batchTemplate.settings;
+
+    MapTemplateSettings& settings = mapTemplate.settings;
+    if (job.races.empty()) {
+        settings.races.assign(settings.maxPlayers, RaceType::Random);
+    } else {
+        settings.races = job.races;
+    }
+
+    settings.size = job.size;
+
+    const std::string seedString{std::to_string(seed)};
+
+    MapGenOptions options;
+    options.mapTemplate = &mapTemplate;
+    options.name = std::string{"Random scenario "} + seedString;
+    options.description = std::string{"Random scenario based on template '"} + settings.name
+                          + std::string{"'. Seed: "} + seedString
+                          + ". Starting gold: " + std::to_string(settings.startingGold)
+                          + ". Roads: " + std::to_string(settings.roads)
+                          + "%. Forest: " + std::to_string(settings.forest) + "%.";
+    options.size = settings.size;
+    options.fillThreads = batchOptions.fillThreads;
+
+    attempt->generator = std::make_unique<MapGenerator>(context, options, seed);
+
+    settings.replaceRandomRaces(attempt->generator->randomGenerator);
+
+    const auto start{BatchClock::now()};
+
+    {
+        auto templateState{batchTemplate.states->acquire()};
+        readTemplateContents(mapTemplate, templateState.getLua());
+    }
+
+    // Attempts of a single scenario run one by one
+    report.contentsTime += getMilliseconds(start);
+
+    return attempt;
+}
+
+static void generateScenario(const GenerationContext& context,
+                             const BatchTemplate& batchTemplate,
+                             const BatchTask& task,
+                             const BatchOptions& batchOptions,
+                             BatchReport& report)
+{
+    if (!batchTemplate.states) {
+        throw TemplateException(batchTemplate.error);
+    }
+
+    const BatchJob& job{*task.job};
+    const MapTemplateSettings& settings{batchTemplate.settings};
+
+    if (job.size < settings.sizeMin || job.size > settings.sizeMax) {
+        throw TemplateException("Template supports sizes from " + std::to_string(settings.sizeMin)
+                                + " to " + std::to_string(settings.sizeMax));
+    }
+
+    if (job.races.size() > static_cast<std::size_t>(settings.maxPlayers)) {
+        throw TemplateException("Template supports up to " + std::to_string(settings.maxPlayers)
+                                + " players");
+    }
+
+    CancellationToken cancellation;
+    if (batchOptions.timeLimit.count()) {
+        cancellation.setDeadline(CancellationToken::Clock::now() + batchOptions.timeLimit);
+    }
+
+    // Scenarios are already generated in parallel, retry one attempt at a time
+    GenerationAttemptOptions attemptOptions;
+    attemptOptions.maxAttempts = batchOptions.maxAttempts;
+    attemptOptions.fillAttempts = batchOptions.fillAttempts;
+    attemptOptions.cancellation = &cancellation;
+
+    auto start{BatchClock::now()};
+
+    auto result{generateWithRetries(
+        [&](std::time_t seed) {
+            return createAttempt(context, batchTemplate, job, batchOptions, seed, report);
+        },
+        task.seed, attemptOptions)};
+
+    report.generationTime = getMilliseconds(start) - report.contentsTime;
+    report.scenarioSeed = result.seed;
+    report.attempts = result.attemptsStarted;
+    report.fillSeed = result.fillSeed;
+    report.races = result.attempt->mapTemplate->settings.races;
+
+    auto& map{result.map};
+
+    for (const auto& [name, type] : reportedObjects) {
+        std::size_t count{};
+        map->visit(type, [&count](const ScenarioObject*) { ++count; });
+
+        report.objectCounts.emplace_back(name, count);
+    }
+
+    if (batchOptions.analyze) {
+        const MapGenerator& generator{*result.attempt->generator};
+
+        for (const auto& [zoneId, zone] : generator.zones) {
+            const ZoneStatistics& statistics{zone->getStatistics()};
+
+            report.stacks.insert(report.stacks.end(), statistics.stacks.begin(),
+                                 statistics.stacks.end());
+            report.loot.insert(report.loot.end(), statistics.loot.begin(),
+                               statistics.loot.end());
+        }
+
+        const auto roadTiles{std::count_if(generator.tiles.begin(), generator.tiles.end(),
+                                           [](const TileInfo& tile) { return tile.isRoad(); })};
+        report.roadCoverage = static_cast<double>(roadTiles) / generator.tiles.size();
+        return;
+    }
+
+    start = BatchClock::now();
+
+    map->serialize(report.scenarioPath);
+
+    report.serializationTime = getMilliseconds(start);
+
+    if (batchOptions.debugImages) {
+        auto imagePath{report.scenarioPath};
+        const auto stem{imagePath.stem().u8string()};
+
+        writeDebugImages(*result.attempt->generator,
+                         imagePath.replace_filename(stem + "_zones.png"),
+                         imagePath.replace_filename(stem + "_tiles.png"));
+    }
+}
+
+static std::string escapeJson(const std::string& string)
+{
+    std::string escaped;
+    escaped.reserve(string.size());
+
+    for (char c : string) {
+        switch (c) {
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char code[8];
+                std::snprintf(code, sizeof(code), "\\u%04x", c);
+                escaped += code;
+            } else {
+                escaped += c;
+            }
+            break;
+        }
+    }
+
+    return escaped;
+}
+
+static void writeReport(std::ostream& stream, const BatchTask& task, const BatchReport& report)
+{
+    const BatchJob& job{*task.job};
+
+    stream << "{\"job\":" << task.jobIndex << ",\"template\":\""
+           << escapeJson(job.templatePath.u8string()) << "\",\"size\":" << job.size
+           << ",\"seed\":" << task.seed << ",\"scenarioSeed\":" << report.scenarioSeed
+           << ",\"attempts\":" << report.attempts << ",\"fillSeed\":" << report.fillSeed
+           << ",\"races\":[";
+
+    for (std::size_t i = 0; i < report.races.size(); ++i) {
+        stream << (i ? ",\"" : "\"") << getRaceName(report.races[i]) << '"';
+    }
+
+    stream << "],\"scenario\":\"" << escapeJson(report.scenarioPath.filename().u8string())
+           << "\",\"success\":" << (report.failure.empty() ? "true" : "false");
+
+    if (!report.failure.empty()) {
+        stream << ",\"failure\":\"" << report.failure << "\",\"error\":\""
+               << escapeJson(report.error) << '"';
+    }
+
+    stream << std::fixed << std::setprecision(3) << ",\"contentsMs\":" << report.contentsTime
+           << ",\"generationMs\":" << report.generationTime
+           << ",\"serializationMs\":" << report.serializationTime << ",\"objects\":{";
+
+    for (std::size_t i = 0; i < report.objectCounts.size(); ++i) {
+        const auto& [name, count] = report.objectCounts[i];
+        stream << (i ? ",\"" : "\"") << name << "\":" << count;
+    }
+
+    stream << "}}\n";
+    stream.flush();
+}
+
+static void addValues(ValueAnalysis& analysis, const std::vector<CreatedValue>& values)
+{
+    for (const auto& value : values) {
+        analysis.requested += value.requested;
+        analysis.created += value.created;
+
+        if (value.requested > 0) {
+            analysis.ratios.push_back(static_cast<double>(value.created) / value.requested);
+        }
+    }
+}
+
+static void addToAnalysis(JobAnalysis& analysis, const BatchReport& report)
+{
+    ++analysis.scenarios;
+
+    if (!report.failure.empty()) {
+        ++analysis.failures[report.failure];
+
+        if (report.failedZone >= 0) {
+            ++analysis.zoneFailures[report.failedZone];
+        }
+
+        return;
+    }
+
+    ++analysis.succeeded;
+    analysis.times.push_back(report.contentsTime + report.generationTime);
+
+    analysis.objectCounts.resize(report.objectCounts.size());
+    for (std::size_t i = 0; i < report.objectCounts.size(); ++i) {
+        analysis.objectCounts[i].push_back(report.objectCounts[i].second);
+    }
+
+    addValues(analysis.stacks, report.stacks);
+    addValues(analysis.loot, report.loot);
+    analysis.roadCoverage.push_back(report.roadCoverage);
+}
+
+// Nearest rank percentile of sorted values
+static double getPercentile(const std::vector<double>& values, double percentile)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+
+    const auto rank{static_cast<std::size_t>(std::ceil(percentile / 100.0 * values.size()))};
+    return values[std::clamp<std::size_t>(rank, 1, values.size()) - 1];
+}
+
+template <typename T>
+static double getMean(const std::vector<T>& values)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+
+    return std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+}
+
+static const int reportedPercentiles[] = {10, 50, 90, 99};
+
+static void writePercentiles(std::ostream& stream, std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+
+    stream << '{';
+    for (const auto percentile : reportedPercentiles) {
+        stream << "\"p" << percentile << "\":" << getPercentile(values, percentile) << ',';
+    }
+
+    stream << "\"max\":" << (values.empty() ? 0.0 : values.back()) << '}';
+}
+
+static void writeValues(std::ostream& stream, const ValueAnalysis& values)
+{
+    stream << "{\"objects\":" << values.ratios.size() << ",\"requested\":" << values.requested
+           << ",\"created\":" << values.created << ",\"createdToRequested\":";
+
+    writePercentiles(stream, values.ratios);
+    stream << '}';
+}
+
+static void writeAnalysisJson(std::ostream& stream,
+                              const std::vector<BatchJob>& jobs,
+                              const std::vector<JobAnalysis>& analyses)
+{
+    stream << std::fixed << std::setprecision(3) << "{\"jobs\":[";
+
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        const BatchJob& job{jobs[i]};
+        const JobAnalysis& analysis{analyses[i]};
+
+        stream << (i ? ",\n" : "\n") << "{\"job\":" << i + 1 << ",\"template\":\""
+               << escapeJson(job.templatePath.u8string()) << "\",\"size\":" << job.size
+               << ",\"firstSeed\":" << job.firstSeed << ",\"lastSeed\":" << job.lastSeed
+               << ",\"scenarios\":" << analysis.scenarios
+               << ",\"succeeded\":" << analysis.succeeded << ",\"failures\":{";
+
+        bool first{true};
+        for (const auto& [failure, count] : analysis.failures) {
+            stream << (first ? "\"" : ",\"") << failure << "\":" << count;
+            first = false;
+        }
+
+        stream << "},\"zoneFailures\":[";
+
+        first = true;
+        for (const auto& [zoneId, count] : analysis.zoneFailures) {
+            stream << (first ? "" : ",") << "{\"zone\":" << zoneId << ",\"failures\":" << count
+                   << ",\"rate\":" << static_cast<double>(count) / analysis.scenarios << '}';
+            first = false;
+        }
+
+        stream << "],\"generationMs\":";
+        writePercentiles(stream, analysis.times);
+
+        stream << ",\"stackValue\":";
+        writeValues(stream, analysis.stacks);
+
+        stream << ",\"lootValue\":";
+        writeValues(stream, analysis.loot);
+
+        stream << ",\"roadCoverage\":";
+        writePercentiles(stream, analysis.roadCoverage);
+
+        stream << ",\"objects\":{";
+        for (std::size_t j = 0; j < analysis.objectCounts.size(); ++j) {
+            const auto& counts{analysis.objectCounts[j]};
+            const auto [min, max] = std::minmax_element(counts.begin(), counts.end());
+
+            stream << (j ? ",\"" : "\"") << reportedObjects[j].first << "\":{\"mean\":"
+                   << getMean(counts) << ",\"min\":" << *min << ",\"max\":" << *max << '}';
+        }
+
+        stream << "}}";
+    }
+
+    stream << "\n]}\n";
+}
+
+// Writes a line per job with the main values of analysis.json
+static void writeAnalysisCsv(std::ostream& stream,
+                             const std::vector<BatchJob>& jobs,
+                             const std::vector<JobAnalysis>& analyses)
+{
+    stream << "job,template,size,scenarios,failureRate,timeP50,timeP90,timeP99,"
+              "stackRequested,stackCreated,stackRatioP10,stackRatioP50,stackRatioP90,"
+              "lootRequested,lootCreated,lootRatioP10,lootRatioP50,lootRatioP90,roadCoverage";
+
+    for (const auto& [name, type] : reportedObjects) {
+        stream << ',' << name;
+    }
+
+    stream << ",zoneFailureRates\n";
+    stream << std::fixed << std::setprecision(3);
+
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        const BatchJob& job{jobs[i]};
+        const JobAnalysis& analysis{analyses[i]};
+
+        const double failed{static_cast<double>(analysis.scenarios - analysis.succeeded)};
+
+        auto times{analysis.times};
+        std::sort(times.begin(), times.end());
+
+        stream << i + 1 << ",\"" << job.templatePath.stem().u8string() << "\"," << job.size
+               << ',' << analysis.scenarios << ',' << failed / analysis.scenarios << ','
+               << getPercentile(times, 50.0) << ',' << getPercentile(times, 90.0) << ','
+               << getPercentile(times, 99.0);
+
+        for (const ValueAnalysis* values : {&analysis.stacks, &analysis.loot}) {
+            auto ratios{values->ratios};
+            std::sort(ratios.begin(), ratios.end());
+
+            stream << ',' << values->requested << ',' << values->created << ','
+                   << getPercentile(ratios, 10.0) << ',' << getPercentile(ratios, 50.0) << ','
+                   << getPercentile(ratios, 90.0);
+        }
+
+        stream << ',' << getMean(analysis.roadCoverage);
+
+        for (std::size_t j = 0; j < std::size(reportedObjects); ++j) {
+            stream << ','
+                   << (j < analysis.objectCounts.size() ? getMean(analysis.objectCounts[j]) : 0.0);
+        }
+
+        // Zone failure rates as 'zone:rate' pairs separated by spaces
+        stream << ",\"";
+        bool first{true};
+        for (const auto& [zoneId, count] : analysis.zoneFailures) {
+            stream << (first ? "" : " ") << zoneId << ':'
+                   << static_cast<double>(count) / analysis.scenarios;
+            first = false;
+        }
+
+        stream << "\"\n";
+    }
+}
+
+static void writeAnalysis(const std::filesystem::path& outputFolder,
+                          const std::vector<BatchJob>& jobs,
+                          const std::vector<JobAnalysis>& analyses)
+{
+    const auto jsonPath{outputFolder / "analysis.json"};
+    std::ofstream json(jsonPath);
+    if (!json) {
+        throw std::runtime_error("Could not create analysis file " + jsonPath.u8string());
+    }
+
+    writeAnalysisJson(json, jobs, analyses);
+
+    const auto csvPath{outputFolder / "analysis.csv"};
+    std::ofstream csv(csvPath);
+    if (!csv) {
+        throw std::runtime_error("Could not create analysis file " + csvPath.u8string());
+    }
+
+    writeAnalysisCsv(csv, jobs, analyses);
+
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        const JobAnalysis& analysis{analyses[i]};
+
+        auto times{analysis.times};
+        std::sort(times.begin(), times.end());
+
+        std::cout << "job" << i + 1 << ' ' << jobs[i].templatePath.stem().u8string() << ' '
+                  << jobs[i].size << ": " << analysis.succeeded << '/' << analysis.scenarios
+                  << " succeeded, median " << static_cast<long long>(getPercentile(times, 50.0))
+                  << " ms\n";
+    }
+}
+
+#ifdef RSG_PROFILING
+static void writeProfile(const std::filesystem::path& outputFolder)
+{
+    const auto& profiler{Profiler::instance()};
+
+    const auto tracePath{outputFolder / "trace.json"};
+    if (!profiler.writeTrace(tracePath)) {
+        std::cerr << "Could not write profiling trace " << tracePath.u8string() << '\n';
+    }
+
+    std::ofstream summary(outputFolder / "profile.txt");
+    profiler.writeSummary(summary);
+}
+#endif
+
+std::size_t runBatch(const GenerationContext& context,
+                     const std::vector<BatchJob>& jobs,
+                     const BatchOptions& options)
+{
+    std::filesystem::create_directories(options.outputFolder);
+
+    // Analysis replaces report of each scenario
+    std::ofstream reportStream;
+    if (!options.analyze) {
+        const auto reportPath{options.outputFolder / "report.jsonl"};
+        reportStream.open(reportPath);
+        if (!reportStream) {
+            throw std::runtime_error("Could not create report file " + reportPath.u8string());
+        }
+    }
+
+    // Unchanged templates are loaded from compiled chunks on repeated runs
+    TemplateCache templateCache{TemplateCache::getDefaultFolder()};
+    std::map<std::filesystem::path, BatchTemplate> templates;
+    std::vector<BatchTask> tasks;
+
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        const BatchJob& job{jobs[i]};
+
+        for (auto seed = job.firstSeed; seed <= job.lastSeed; ++seed) {
+            tasks.push_back(BatchTask{&job, i + 1, seed});
+        }
+
+        if (templates.find(job.templatePath) != templates.end()) {
+            continue;
+        }
+
+        // Read template settings once, jobs fail separately if template could not be loaded
+        BatchTemplate& batchTemplate{templates[job.templatePath]};
+
+        try {
+            sol::state lua;
+            bindLuaApi(lua);
+
+            batchTemplate.settings = templateCache.readTemplateSettings(job.templatePath, lua);
+            batchTemplate.states = std::make_unique<LuaStatePool>(templateCache,
+                                                                  job.templatePath);
+        } catch (const std::exception& e) {
+            batchTemplate.error = e.what();
+        }
+    }
+
+    std::atomic<std::size_t> nextTask{};
+    std::atomic<std::size_t> failedTasks{};
+    std::mutex reportMutex;
+    std::vector<JobAnalysis> analyses(jobs.size());
+
+    auto worker = [&]() {
+        for (auto i = nextTask++; i < tasks.size(); i = nextTask++) {
+            const BatchTask& task{tasks[i]};
+            const BatchJob& job{*task.job};
+
+            BatchReport report;
+            report.races = job.races;
+            report.scenarioPath = options.outputFolder
+                                  / std::filesystem::u8path(
+                                      "job" + std::to_string(task.jobIndex) + '_'
+                                      + job.templatePath.stem().u8string() + '_'
+                                      + std::to_string(job.size) + '_'
+                                      + std::to_string(task.seed) + ".sg");
+
+            try {
+                generateScenario(context, templates.at(job.templatePath), task, options,
+                                 report);
+            } catch (const TemplateException& e) {
+                report.failure = "Template";
+                report.error = e.what();
+            } catch (const LackOfSpaceException& e) {
+                report.failure = "LackOfSpace";
+                report.error = e.what();
+                report.failedZone = e.getZoneId();
+            } catch (const GenerationCancelledException&) {
+                report.failure = "Timeout";
+                report.error = "Scenario was not generated within time limit";
+            } catch (const std::exception& e) {
+                report.failure = "Error";
+                report.error = e.what();
+            }
+
+            if (!report.failure.empty()) {
+                ++failedTasks;
+            }
+
+            std::lock_guard<std::mutex> lock{reportMutex};
+
+            if (options.analyze) {
+                addToAnalysis(analyses[task.jobIndex - 1], report);
+                continue;
+            }
+
+            writeReport(reportStream, task, report);
+
+            std::cout << '[' << (i + 1) << '/' << tasks.size() << "] "
+                      << report.scenarioPath.filename().u8string();
+            if (report.failure.empty()) {
+                std::cout << ": " << static_cast<long long>(report.generationTime) << " ms\n";
+            } else {
+                std::cout << ": " << report.error << '\n';
+            }
+        }
+    };
+
+    const auto threadsTotal{std::max<std::size_t>(1, std::min(options.threads, tasks.size()))};
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < threadsTotal; ++i) {
+        threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (options.analyze) {
+        writeAnalysis(options.outputFolder, jobs, analyses);
+    }
+
+#ifdef RSG_PROFILING
+    writeProfile(options.outputFolder);
+#endif
+
+    return failedTasks;
+}
+
+} // namespace rsg
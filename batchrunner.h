@@ -0,0 +1,85 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "enums.h"
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <filesystem>
+#include <vector>
+
+namespace rsg {
+
+class GenerationContext;
+
+// Scenarios generated from a single template with the same size and races,
+// one scenario for each seed in range
+struct BatchJob
+{
+    std::filesystem::path templatePath;
+    // Races chosen for players, empty list means random race for each template player
+    std::vector<RaceType> races;
+    int size{};
+    std::time_t firstSeed{};
+    std::time_t lastSeed{};
+};
+
+struct BatchOptions
+{
+    // Folder for scenario files, debug images and report
+    std::filesystem::path outputFolder;
+    // Scenarios generated at the same time
+    std::size_t threads{1};
+    // Attempts with derived seeds made for each scenario while zones lack space
+    std::size_t maxAttempts{1};
+    // Zone fills retried from placement of each attempt before it fails
+    std::size_t fillAttempts{1};
+    // Threads that fill zones of each scenario in parallel, zero fills zones one by one
+    std::size_t fillThreads{};
+    // Time given to each scenario including retries, zero means no limit
+    std::chrono::milliseconds timeLimit{};
+    // Write zones and tiles images next to each scenario file
+    bool debugImages{};
+    // Do not write scenarios, aggregate statistics of each job instead
+    bool analyze{};
+};
+
+// Reads jobs from text file, one job per line:
+// <template> <size> <races> <seed>[-<last seed>]
+// Races are comma separated names (Human,Dwarf,Random) or '-' for random race of each
+// template player.
+// Relative template paths are relative to jobs file folder.
+// Empty lines and lines starting with '#' are skipped.
+// Throws std::runtime_error on syntax errors
+std::vector<BatchJob> readBatchJobs(const std::filesystem::path& jobsFilePath);
+
+// Generates scenarios of all jobs in a thread pool, each template is loaded once.
+// Writes scenario files and 'report.jsonl' with a line per scenario:
+// seed that succeeded, timings, object counts or failure reason.
+// In analysis mode scenarios are not written, 'analysis.json' and 'analysis.csv' hold
+// failure rate of each zone, created stack and loot values compared with requested ones,
+// object counts, road coverage and generation time percentiles of each job.
+// Returns number of scenarios that failed to generate
+std::size_t runBatch(const GenerationContext& context,
+                     const std::vector<BatchJob>& jobs,
+                     const BatchOptions& options);
+
+} // namespace rsg
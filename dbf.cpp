@@ -18,6 +18,7 @@
  */
 
 #include "dbf.h"
+#include "profiler.h"
 #include <charconv>
 #include <fstream>
 
@@ -175,6 +176,8 @@ bool Dbf::Record::value(bool& result, const Column& column) const
 Dbf::Dbf(const std::filesystem::path& filePath)
     : dbfFilePath{filePath}
 {
+    RSG_PROFILE_SCOPE_DETAIL("Dbf::Dbf", filePath.filename().u8string());
+
     std::ifstream stream(filePath, std::ios_base::binary);
     if (!stream) {
         return;
@@ -20,12 +20,16 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <gsl/span>
+#include <initializer_list>
 #include <iterator>
 #include <map>
 #include <optional>
 #include <string_view>
+#include <type_traits>
+#include <variant>
 #include <vector>
 
 namespace rsg {
@@ -121,6 +125,56 @@ public:
         Data data{};
     };
 
+    /**
+     * Maps table columns to members of a structure.
+     * Column names are resolved once per table with bind(),
+     * after that records are decoded without any name lookups.
+     */
+    template <typename T>
+    class Schema
+    {
+    public:
+        using Member = std::variant<std::string_view T::*, int T::*, bool T::*>;
+
+        struct Field
+        {
+            const char* columnName;
+            Member member;
+            bool optional{}; /**< Missing column or empty value does not fail decoding. */
+        };
+
+        Schema(std::initializer_list<Field> fields)
+            : fields{fields}
+        { }
+
+        /**
+         * Resolves column names of the table.
+         * @returns false if required column is missing or has unexpected type.
+         */
+        bool bind(const Dbf& dbf);
+
+        /**
+         * Decodes bound fields of the record into result.
+         * Optional fields that could not be read are left untouched.
+         * @returns false if any of required fields could not be read.
+         */
+        bool decode(T& result, const Record& record) const;
+
+        /** Returns nullptr if column was not bound. */
+        const Column* column(const char* columnName) const;
+
+    private:
+        struct BoundField
+        {
+            const Column* column;
+            Member member;
+            bool optional;
+        };
+
+        std::vector<Field> fields;
+        std::vector<BoundField> boundFields;
+    };
+
     struct iterator
     {
         using iterator_category = std::input_iterator_tag;
@@ -287,4 +341,72 @@ private:
     bool valid{};
 };
 
+template <typename T>
+bool Dbf::Schema<T>::bind(const Dbf& dbf)
+{
+    boundFields.clear();
+    boundFields.reserve(fields.size());
+
+    for (const auto& field : fields) {
+        const Column* column{dbf.column(field.columnName)};
+        if (!column) {
+            if (field.optional) {
+                continue;
+            }
+
+            return false;
+        }
+
+        const Column::Type expectedType{std::visit(
+            [](auto member) {
+                using Value = std::remove_reference_t<decltype(std::declval<T&>().*member)>;
+
+                if constexpr (std::is_same_v<Value, int>) {
+                    return Column::Type::Number;
+                } else if constexpr (std::is_same_v<Value, bool>) {
+                    return Column::Type::Logical;
+                } else {
+                    return Column::Type::Character;
+                }
+            },
+            field.member)};
+
+        if (column->type != expectedType) {
+            return false;
+        }
+
+        boundFields.push_back(BoundField{column, field.member, field.optional});
+    }
+
+    return true;
+}
+
+template <typename T>
+bool Dbf::Schema<T>::decode(T& result, const Record& record) const
+{
+    for (const auto& field : boundFields) {
+        const bool decoded{std::visit(
+            [&](auto member) { return record.value(result.*member, *field.column); },
+            field.member)};
+
+        if (!decoded && !field.optional) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename T>
+const Dbf::Column* Dbf::Schema<T>::column(const char* columnName) const
+{
+    for (const auto& field : boundFields) {
+        if (!std::strcmp(field.column->name, columnName)) {
+            return field.column;
+        }
+    }
+
+    return nullptr;
+}
+
 } // namespace rsg
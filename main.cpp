@@ -17,143 +17,82 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "mapgenerator.h"
-#include "maptemplate.h"
-#include "maptemplatereader.h"
+#include "batchrunner.h"
+#include "generationcontext.h"
 #include "standalonegameinfo.h"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
-#include <sol/sol.hpp>
 #include <stdexcept>
-// debug
-#include "image.h"
+#include <string>
+#include <thread>
+
+static void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program
+              << " <game folder> <jobs file> <output folder> [--threads N] [--attempts N]"
+                 " [--fill-attempts N] [--fill-threads N] [--time-limit SECONDS] [--debug-images]"
+                 " [--analyze]\n"
+                 "Jobs file lines: <template> <size> <races> <seed>[-<last seed>]\n"
+                 "Races are comma separated (Human,Undead,Heretic,Dwarf,Elf,Random) "
+                 "or '-' for random race of each template player\n";
+}
 
-// argv[1] - template file
-// argv[2] - path to game
-// argv[3] - path where save created map
 int main(int argc, char* argv[])
 {
     using namespace rsg;
 
-    assert(argc == 4);
+    if (argc < 4) {
+        printUsage(argv[0]);
+        return 2;
+    }
 
-    const std::filesystem::path gameFolder{argv[2]};
+    const std::filesystem::path gameFolder{std::filesystem::u8path(argv[1])};
+    const std::filesystem::path jobsFilePath{std::filesystem::u8path(argv[2])};
+
+    BatchOptions options;
+    options.outputFolder = std::filesystem::u8path(argv[3]);
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 4; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--debug-images")) {
+            options.debugImages = true;
+        } else if (!std::strcmp(argv[i], "--analyze")) {
+            options.analyze = true;
+        } else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--attempts") && i + 1 < argc) {
+            options.maxAttempts = std::max(1, std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--fill-attempts") && i + 1 < argc) {
+            options.fillAttempts = std::max(1, std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--fill-threads") && i + 1 < argc) {
+            options.fillThreads = std::max(0, std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--time-limit") && i + 1 < argc) {
+            const auto seconds{std::max(0.0, std::atof(argv[++i]))};
+            options.timeLimit = std::chrono::milliseconds(static_cast<long long>(seconds * 1000));
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
 
     try {
-        const StandaloneGameInfo info(gameFolder);
-        setGameInfo(&info);
-
-#if 1
-        std::time_t mapSeed{std::time(nullptr)};
-#else
-        std::time_t mapSeed = std::time_t(1673113695);
-#endif
-
-        const std::string seedString{std::to_string(mapSeed)};
-
-        const std::filesystem::path templateFilePath{argv[1]};
-
-        sol::state lua;
-        // Bind scenario generator specific Lua api
-        bindLuaApi(lua);
-
-        MapTemplate mapTemplate;
-        // Read template from file, make sure its ok
-        mapTemplate.settings = readTemplateSettings(templateFilePath, lua);
-
-        // Emulate settings from user
-        MapTemplateSettings& settings = mapTemplate.settings;
-        settings.races.insert(settings.races.end(), settings.maxPlayers, RaceType::Random);
-        settings.size = 72;
-
-        MapGenOptions options;
-        options.mapTemplate = &mapTemplate;
-
-        // MapTemplateSettings name and description are used for ingame (or standalone tool) UI
-        // only.
-        options.name = std::string{"Random scenario "} + seedString;
-        options.description = std::string{"Random scenario based on template '"} + settings.name
-                              + std::string{"'. Seed: "} + seedString
-                              + ". Starting gold: " + std::to_string(settings.startingGold)
-                              + ". Roads: " + std::to_string(settings.roads)
-                              + "%. Forest: " + std::to_string(settings.forest) + "%.";
-        options.size = settings.size;
-
-        MapGenerator generator{options, mapSeed};
+        const auto jobs{readBatchJobs(jobsFilePath)};
 
-        settings.replaceRandomRaces(generator.randomGenerator);
+        // Game data is loaded once and shared by all jobs
+        const StandaloneGameInfo info(gameFolder,
+                                      StandaloneGameInfo::getDefaultSnapshotPath(gameFolder));
+        const GenerationContext context(info, info.getGeneratorSettings());
 
-        // Generate template contents
-        readTemplateContents(mapTemplate, lua);
-
-        auto map{generator.generate()};
-
-        const std::filesystem::path scenarioFilePath{argv[3]};
-
-        map->serialize(scenarioFilePath);
-
-        {
-            const auto width{generator.mapGenOptions.size};
-            const auto height{generator.mapGenOptions.size};
-
-            std::vector<RgbColor> pixels(width * height);
-            std::vector<RgbColor> pixels2(width * height);
-
-            for (int i = 0; i < width; ++i) {
-                for (int j = 0; j < height; ++j) {
-                    Position pos{i, j};
-
-                    // clang-format off
-                    static const RgbColor colors[] = {
-                        RgbColor{255, 0, 0}, // red
-                        RgbColor{0, 255, 0}, // green
-                        RgbColor{0, 0, 255}, // blue
-                        RgbColor{255, 255, 255}, // white
-                        RgbColor{0, 0, 0}, // black
-                        RgbColor{127, 127, 127}, // gray
-                        RgbColor{255, 255, 0}, // yellow
-                        RgbColor{0, 255, 255}, // cyan
-                        RgbColor{255, 0, 255}, // magenta
-                        RgbColor{255, 153, 0}, // orange
-                        RgbColor{0, 158, 10}, // dark green
-                        RgbColor{0, 57, 158}, // dark blue
-                        RgbColor{158, 57, 0}, // dark red
-                    };
-                    // clang-format on
-
-                    const std::size_t index = i + width * j;
-
-                    const auto zoneId{generator.zoneColoring[generator.posToIndex(pos)]};
-                    pixels[index] = colors[zoneId];
-
-                    auto& tile{generator.tiles[generator.posToIndex(pos)]};
-
-                    if (tile.isRoad()) {
-                        pixels2[index] = RgbColor(175, 175, 175); // grey
-                    } else if (tile.isUsed()) {
-                        pixels2[index] = RgbColor(237, 177, 100); // yellow
-                    } else if (tile.isBlocked()) {
-                        pixels2[index] = RgbColor(255, 0, 0); // red
-                    } else if (tile.isFree()) {
-                        pixels2[index] = RgbColor(255, 255, 255); // white
-                    } else if (tile.isPossible()) {
-                        pixels2[index] = RgbColor(255, 179, 185); // pink
-                    } else {
-                        pixels2[index] = RgbColor(0, 0, 0); // black for all other
-                    }
-                }
-            }
-
-            {
-                Image zonesImage(width, height, pixels);
-                zonesImage.write("mapZones.png");
-
-                Image tilesImage(width, height, pixels2);
-                tilesImage.write("mapTiles.png");
-            }
-
-            std::cout << "Debug\n";
+        const auto failed{runBatch(context, jobs, options)};
+        if (failed) {
+            std::cerr << failed << " scenarios failed to generate\n";
+            return 1;
         }
     } catch (const std::exception& e) {
-        std::cerr << "Exception during map generation: " << e.what() << '\n';
+        std::cerr << "Exception during batch generation: " << e.what() << '\n';
+        return 1;
     }
+
+    return 0;
 }
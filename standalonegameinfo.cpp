@@ -21,6 +21,7 @@
 #include "currency.h"
 #include "dbf.h"
 #include "generatorsettings.h"
+#include "profiler.h"
 #include "standaloneiteminfo.h"
 #include "standalonelandmarkinfo.h"
 #include "standaloneraceinfo.h"
@@ -28,6 +29,7 @@
 #include "standaloneunitinfo.h"
 #include "textconvert.h"
 #include <cassert>
+#include <future>
 #include <iostream>
 
 namespace rsg {
@@ -40,15 +42,22 @@ static bool isVanillaReachId(int reachId)
            || reachId == (int)ReachType::Adjacent;
 }
 
-static bool readId(const Dbf::Record& record, const char* column, CMidgardID& id)
+static bool readId(const std::string_view& idString, CMidgardID& id)
 {
-    std::string_view idString{};
-    if (!record.value(idString, column)) {
+    CMidgardID tmpId{idString.data()};
+    if (tmpId == invalidId) {
         return false;
     }
 
+    id = tmpId;
+    return true;
+}
+
+// Same as readId, but also rejects empty ids
+static bool readNonEmptyId(const std::string_view& idString, CMidgardID& id)
+{
     CMidgardID tmpId{idString.data()};
-    if (tmpId == invalidId) {
+    if (tmpId == invalidId || tmpId == emptyId) {
         return false;
     }
 
@@ -56,6 +65,169 @@ static bool readId(const Dbf::Record& record, const char* column, CMidgardID& id
     return true;
 }
 
+// Opens table and binds its columns to the schema
+template <typename T>
+static bool openTable(Dbf& db, Dbf::Schema<T>& schema, const char* dbFileName)
+{
+    if (!db) {
+        std::cerr << "Could not open " << dbFileName << '\n';
+        return false;
+    }
+
+    if (!schema.bind(db)) {
+        std::cerr << "Missing or invalid columns in " << dbFileName << '\n';
+        return false;
+    }
+
+    return true;
+}
+
+struct TextRecord
+{
+    std::string_view id;
+    std::string_view text;
+};
+
+struct SiteTextRecord
+{
+    std::string_view name;
+    std::string_view description;
+};
+
+struct ReachRecord
+{
+    int id{};
+    bool melee{};
+    int maxTargets{-1};
+};
+
+struct AttackRecord
+{
+    std::string_view id;
+    int reach{};
+    int type{};
+};
+
+struct UnitRecord
+{
+    bool waterOnly{};
+    std::string_view id;
+    int type{};
+    int level{};
+    std::string_view raceId;
+    bool smallUnit{};
+    bool male{};
+    int subrace{};
+    std::string_view nameId;
+    std::string_view attackId;
+    int hp{};
+    int move{-1};
+    int leadership{-1};
+    int value{};
+};
+
+struct ItemRecord
+{
+    int type{};
+    std::string_view id;
+    std::string_view value;
+};
+
+struct SpellRecord
+{
+    std::string_view id;
+    int type{};
+    int level{};
+    std::string_view cost;
+};
+
+struct LandmarkRecord
+{
+    std::string_view id;
+    int x{};
+    int y{};
+    bool mountain{};
+    int type{};
+};
+
+struct LeaderNameRecord
+{
+    std::string_view raceId;
+    bool male{};
+    std::string_view name;
+};
+
+struct RaceRecord
+{
+    std::string_view id;
+    std::string_view guardId;
+    std::string_view nobleId;
+    std::string_view leader1;
+    std::string_view leader2;
+    std::string_view leader3;
+    std::string_view leader4;
+    int type{};
+};
+
+// Runs game data reading tasks concurrently.
+// Task starts its work only after all of its dependencies succeeded
+class LoadingTasks
+{
+public:
+    using Task = std::shared_future<bool>;
+
+    ~LoadingTasks()
+    {
+        // Tasks reference caller data, never leave them running
+        for (const auto& task : tasks) {
+            task.wait();
+        }
+    }
+
+    template <typename F>
+    Task run(std::initializer_list<Task> dependencies, F&& function)
+    {
+        std::vector<Task> waitFor{dependencies};
+
+        auto body = [waitFor = std::move(waitFor), function = std::forward<F>(function)]() {
+            bool ready{true};
+            for (const auto& dependency : waitFor) {
+                // Failed dependency means this task has nothing to work with
+                ready = waitSucceeded(dependency) && ready;
+            }
+
+            return ready && function();
+        };
+
+        auto task{std::async(std::launch::async, std::move(body)).share()};
+        tasks.push_back(task);
+        return task;
+    }
+
+    // Waits for all tasks, rethrows first exception if any of them has thrown
+    bool wait()
+    {
+        bool result{true};
+        for (const auto& task : tasks) {
+            result = task.get() && result;
+        }
+
+        return result;
+    }
+
+private:
+    static bool waitSucceeded(const Task& task)
+    {
+        try {
+            return task.get();
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    std::vector<Task> tasks;
+};
+
 static bool readTexts(TextsInfo& texts,
                       const std::filesystem::path& folderPath,
                       const char* dbFileName)
@@ -63,35 +235,33 @@ static bool readTexts(TextsInfo& texts,
     texts.clear();
 
     Dbf db{folderPath / dbFileName};
-    if (!db) {
-        std::cerr << "Could not open " << dbFileName << '\n';
-        return false;
-    }
+    Dbf::Schema<TextRecord> schema{
+        {"TXT_ID", &TextRecord::id},
+        {"TEXT", &TextRecord::text},
+    };
 
-    const Dbf::Column* textColumn{db.column("TEXT")};
-    if (!textColumn) {
-        std::cerr << "Missing 'TEXT' column in " << dbFileName << '\n';
+    if (!openTable(db, schema, dbFileName)) {
         return false;
     }
 
-    const std::uint8_t textLength{textColumn->length};
+    const std::uint8_t textLength{schema.column("TEXT")->length};
 
     for (const auto& record : db) {
         if (record.deleted()) {
             continue;
         }
 
-        CMidgardID textId;
-        if (!readId(record, "TXT_ID", textId)) {
+        TextRecord text;
+        if (!schema.decode(text, record)) {
             continue;
         }
 
-        std::string_view textView{};
-        if (!record.value(textView, "TEXT")) {
+        CMidgardID textId;
+        if (!readId(text.id, textId)) {
             continue;
         }
 
-        texts[textId] = translate(textView, textLength);
+        texts[textId] = translate(text.text, textLength);
     }
 
     return true;
@@ -104,32 +274,33 @@ static bool readSiteText(SiteTexts& texts,
     texts.clear();
 
     Dbf db{dbFilename};
-    if (!db) {
-        std::cerr << "Could not open " << dbFilename.filename().string() << '\n';
+    Dbf::Schema<SiteTextRecord> schema{
+        {"NAME", &SiteTextRecord::name},
+        {"DESC", &SiteTextRecord::description, true},
+    };
+
+    if (!openTable(db, schema, dbFilename.filename().string().c_str())) {
         return false;
     }
 
-    const auto nameLength = db.column("NAME")->length;
-    const auto descriptionLength = db.column("DESC")->length;
+    const auto nameLength = schema.column("NAME")->length;
+    const Dbf::Column* descriptionColumn{schema.column("DESC")};
 
     for (const auto& record : db) {
         if (record.deleted()) {
             continue;
         }
 
-        std::string_view nameView{};
-        if (!record.value(nameView, "NAME")) {
+        SiteTextRecord siteText;
+        if (!schema.decode(siteText, record)) {
             continue;
         }
 
         SiteText text;
-        text.name = translate(nameView, nameLength);
+        text.name = translate(siteText.name, nameLength);
 
-        if (readDescriptions) {
-            std::string_view descriptionView{};
-            if (record.value(descriptionView, "DESC")) {
-                text.description = translate(descriptionView, descriptionLength);
-            }
+        if (readDescriptions && descriptionColumn && !siteText.description.empty()) {
+            text.description = translate(siteText.description, descriptionColumn->length);
         }
 
         texts.emplace_back(std::move(text));
@@ -138,11 +309,24 @@ static bool readSiteText(SiteTexts& texts,
     return true;
 }
 
-StandaloneGameInfo::StandaloneGameInfo(const std::filesystem::path& gameFolderPath)
+StandaloneGameInfo::StandaloneGameInfo(const std::filesystem::path& gameFolderPath,
+                                       const std::filesystem::path& snapshotPath)
 {
+    if (!snapshotPath.empty() && readSnapshot(snapshotPath, gameFolderPath)) {
+        assignCatalogIndices(*this);
+        return;
+    }
+
     if (!readGameInfo(gameFolderPath)) {
         throw std::runtime_error("Could not read game info");
     }
+
+    if (!snapshotPath.empty() && !writeSnapshot(snapshotPath, gameFolderPath)) {
+        // Not critical, game data will be read from game files next time
+        std::cerr << "Could not write game data snapshot\n";
+    }
+
+    assignCatalogIndices(*this);
 }
 
 const UnitsInfo& StandaloneGameInfo::getUnits() const
@@ -321,64 +505,59 @@ const char* StandaloneGameInfo::getText(const TextsInfo& texts, const CMidgardID
     return it->second.c_str();
 }
 
-bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolderPath)
+bool StandaloneGameInfo::readAttacksInfo(const std::filesystem::path& globalsFolderPath,
+                                         AttacksInfo& attacks)
 {
-    unitsInfo.clear();
-    leaders.clear();
-    soldiers.clear();
-
-    minLeaderValue = std::numeric_limits<int>::max();
-    maxLeaderValue = std::numeric_limits<int>::min();
-
-    minSoldierValue = std::numeric_limits<int>::max();
-    maxSoldierValue = std::numeric_limits<int>::min();
+    attacks.clear();
 
     bool customReaches{false};
     std::map<int /* raw reach id */, ReachType /* actual reach type to use instead */> reaches;
 
     {
         Dbf reachDb{globalsFolderPath / "LAttR.dbf"};
-        if (!reachDb) {
-            std::cerr << "Could not open LAttR.dbf\n";
+        // 'Melee' and 'max targets' are read only for custom reaches
+        Dbf::Schema<ReachRecord> schema{
+            {"ID", &ReachRecord::id},
+            {"MELEE", &ReachRecord::melee, true},
+            {"MAX_TARGTS", &ReachRecord::maxTargets, true},
+        };
+
+        if (!openTable(reachDb, schema, "LAttR.dbf")) {
             return false;
         }
 
         // Check custom reaches presence by new special 'melee' column.
         // Don't bother reading even vanilla ones if there are no custom reaches
-        customReaches = reachDb.column("MELEE") != nullptr;
+        customReaches = schema.column("MELEE") != nullptr;
         if (customReaches) {
             for (const auto& record : reachDb) {
                 if (record.deleted()) {
                     continue;
                 }
 
-                int rawId{};
-                if (!record.value(rawId, "ID")) {
+                ReachRecord reachRecord;
+                if (!schema.decode(reachRecord, record)) {
                     continue;
                 }
 
+                const int rawId{reachRecord.id};
                 if (isVanillaReachId(rawId)) {
                     reaches[rawId] = static_cast<ReachType>(rawId);
                 } else {
                     // Map custom reaches to vanilla ones (Any, All or Adjacent)
                     // depending on 'melee' hint and max targets count.
                     // We don't care about their actual logic
-                    bool melee{false};
-                    if (!record.value(melee, "MELEE")) {
-                        continue;
-                    }
 
                     // Melle custom reaches become 'Adjacent'
                     ReachType reach = ReachType::Adjacent;
-                    if (!melee) {
+                    if (!reachRecord.melee) {
                         // Non-melee custom reaches with 6 max targets becomes 'All',
                         // others are 'Any'
-                        int maxTargets{};
-                        if (!record.value(maxTargets, "MAX_TARGTS")) {
+                        if (reachRecord.maxTargets < 0) {
                             continue;
                         }
 
-                        reach = maxTargets == 6 ? ReachType::All : ReachType::Any;
+                        reach = reachRecord.maxTargets == 6 ? ReachType::All : ReachType::Any;
                     }
 
                     reaches[rawId] = reach;
@@ -387,12 +566,15 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
         }
     }
 
-    std::map<CMidgardID /* attack id */, std::pair<ReachType, AttackType>> attacks;
-
     {
         Dbf attacksDb{globalsFolderPath / "GAttacks.dbf"};
-        if (!attacksDb) {
-            std::cerr << "Could not open GAttacks.dbf\n";
+        Dbf::Schema<AttackRecord> schema{
+            {"ATT_ID", &AttackRecord::id},
+            {"REACH", &AttackRecord::reach},
+            {"CLASS", &AttackRecord::type},
+        };
+
+        if (!openTable(attacksDb, schema, "GAttacks.dbf")) {
             return false;
         }
 
@@ -401,25 +583,18 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
                 continue;
             }
 
-            std::string_view idString{};
-            if (!record.value(idString, "ATT_ID")) {
-                continue;
-            }
-
-            CMidgardID attackId(idString.data());
-            if (attackId == invalidId || attackId == emptyId) {
+            AttackRecord attack;
+            if (!schema.decode(attack, record)) {
                 continue;
             }
 
-            int reach{};
-            if (!record.value(reach, "REACH")) {
+            CMidgardID attackId;
+            if (!readNonEmptyId(attack.id, attackId)) {
                 continue;
             }
 
-            int type{};
-            if (!record.value(type, "CLASS")) {
-                continue;
-            }
+            const int reach{attack.reach};
+            const int type{attack.type};
 
             if (!customReaches) {
                 // We can use vanilla reaches as is
@@ -437,9 +612,36 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
         }
     }
 
+    return true;
+}
+
+bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolderPath,
+                                       const AttacksInfo& attacks)
+{
+    unitsInfo.clear();
+    allUnits.clear();
+
     Dbf unitsDb{globalsFolderPath / "GUnits.dbf"};
-    if (!unitsDb) {
-        std::cerr << "Could not open GUnits.dbf\n";
+    // 'Move' and 'leadership' are required for leaders only
+    Dbf::Schema<UnitRecord> schema{
+        {"WATER_ONLY", &UnitRecord::waterOnly},
+        {"UNIT_ID", &UnitRecord::id},
+        {"UNIT_CAT", &UnitRecord::type},
+        {"LEVEL", &UnitRecord::level},
+        {"RACE_ID", &UnitRecord::raceId},
+        {"SIZE_SMALL", &UnitRecord::smallUnit},
+        {"SEX_M", &UnitRecord::male},
+        {"SUBRACE", &UnitRecord::subrace},
+        {"NAME_TXT", &UnitRecord::nameId},
+        // We only interested in primary attack
+        {"ATTACK_ID", &UnitRecord::attackId},
+        {"HIT_POINT", &UnitRecord::hp},
+        {"MOVE", &UnitRecord::move, true},
+        {"LEADERSHIP", &UnitRecord::leadership, true},
+        {"XP_KILLED", &UnitRecord::value},
+    };
+
+    if (!openTable(unitsDb, schema, "GUnits.dbf")) {
         return false;
     }
 
@@ -448,82 +650,36 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
             continue;
         }
 
-        bool waterOnly{};
-        if (!record.value(waterOnly, "WATER_ONLY")) {
+        UnitRecord unit;
+        if (!schema.decode(unit, record)) {
             continue;
         }
 
-        if (waterOnly) {
+        if (unit.waterOnly) {
             // Skip water-only units until generator supports water zones
             continue;
         }
 
-        std::string_view idString{};
-        if (!record.value(idString, "UNIT_ID")) {
-            continue;
-        }
-
-        CMidgardID unitId(idString.data());
-        if (unitId == invalidId || unitId == emptyId) {
-            continue;
-        }
-
-        int type{};
-        if (!record.value(type, "UNIT_CAT")) {
-            continue;
-        }
-
-        const auto unitType{static_cast<UnitType>(type)};
-
-        int level{};
-        if (!record.value(level, "LEVEL")) {
-            continue;
-        }
-
-        std::string_view raceIdString{};
-        if (!record.value(raceIdString, "RACE_ID")) {
-            continue;
-        }
-
-        CMidgardID raceId(raceIdString.data());
-        if (raceId == invalidId || raceId == emptyId) {
-            continue;
-        }
-
-        bool smallUnit{};
-        if (!record.value(smallUnit, "SIZE_SMALL")) {
-            continue;
-        }
-
-        bool male{};
-        if (!record.value(male, "SEX_M")) {
+        CMidgardID unitId;
+        if (!readNonEmptyId(unit.id, unitId)) {
             continue;
         }
 
-        int subrace{};
-        if (!record.value(subrace, "SUBRACE")) {
-            continue;
-        }
-
-        std::string_view nameIdString{};
-        if (!record.value(nameIdString, "NAME_TXT")) {
-            continue;
-        }
+        const auto unitType{static_cast<UnitType>(unit.type)};
 
-        CMidgardID nameId(nameIdString.data());
-        if (nameId == invalidId || nameId == emptyId) {
+        CMidgardID raceId;
+        if (!readNonEmptyId(unit.raceId, raceId)) {
             continue;
         }
 
-        // We only interested in primary attack
-        std::string_view attackString{};
-        if (!record.value(attackString, "ATTACK_ID")) {
+        CMidgardID nameId;
+        if (!readNonEmptyId(unit.nameId, nameId)) {
             continue;
         }
 
         // Primary attack should always exist
-        CMidgardID attackId(attackString.data());
-        if (attackId == invalidId || attackId == emptyId) {
+        CMidgardID attackId;
+        if (!readNonEmptyId(unit.attackId, attackId)) {
             continue;
         }
 
@@ -533,27 +689,23 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
             continue;
         }
 
-        int hp{};
-        if (!record.value(hp, "HIT_POINT")) {
-            continue;
-        }
-
         int move{};
         int leadership{};
         if (unitType == UnitType::Leader) {
-            if (!record.value(move, "MOVE")) {
+            if (unit.move < 0 || unit.leadership < 0) {
                 continue;
             }
 
-            if (!record.value(leadership, "LEADERSHIP")) {
-                continue;
-            }
+            move = unit.move;
+            leadership = unit.leadership;
         }
 
-        int value{};
-        if (!record.value(value, "XP_KILLED")) {
-            continue;
-        }
+        const int level{unit.level};
+        const int subrace{unit.subrace};
+        const int hp{unit.hp};
+        const bool smallUnit{unit.smallUnit};
+        const bool male{unit.male};
+        const int value{unit.value};
 
         if (value == 0) {
             continue;
@@ -566,30 +718,62 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
                                                        pair.first, pair.second, hp, move,
                                                        leadership, !smallUnit, male)};
 
-        if (unitType == UnitType::Leader) {
-            leaders.push_back(info.get());
+        allUnits.push_back(info.get());
+        unitsInfo[unitId] = std::move(info);
+    }
 
-            if (value < minLeaderValue) {
-                minLeaderValue = value;
-            }
+    return true;
+}
 
-            if (value > maxLeaderValue) {
-                maxLeaderValue = value;
-            }
+bool StandaloneGameInfo::buildLeaders()
+{
+    leaders.clear();
 
-        } else if (unitType == UnitType::Soldier) {
-            soldiers.push_back(info.get());
+    minLeaderValue = std::numeric_limits<int>::max();
+    maxLeaderValue = std::numeric_limits<int>::min();
 
-            if (value < minSoldierValue) {
-                minSoldierValue = value;
-            }
+    for (auto unit : allUnits) {
+        if (unit->getUnitType() != UnitType::Leader) {
+            continue;
+        }
 
-            if (value > maxSoldierValue) {
-                maxSoldierValue = value;
-            }
+        leaders.push_back(unit);
+
+        const int value{unit->getValue()};
+        if (value < minLeaderValue) {
+            minLeaderValue = value;
         }
 
-        unitsInfo[unitId] = std::move(info);
+        if (value > maxLeaderValue) {
+            maxLeaderValue = value;
+        }
+    }
+
+    return true;
+}
+
+bool StandaloneGameInfo::buildSoldiers()
+{
+    soldiers.clear();
+
+    minSoldierValue = std::numeric_limits<int>::max();
+    maxSoldierValue = std::numeric_limits<int>::min();
+
+    for (auto unit : allUnits) {
+        if (unit->getUnitType() != UnitType::Soldier) {
+            continue;
+        }
+
+        soldiers.push_back(unit);
+
+        const int value{unit->getValue()};
+        if (value < minSoldierValue) {
+            minSoldierValue = value;
+        }
+
+        if (value > maxSoldierValue) {
+            maxSoldierValue = value;
+        }
     }
 
     return true;
@@ -599,11 +783,15 @@ bool StandaloneGameInfo::readItemsInfo(const std::filesystem::path& globalsFolde
 {
     itemsInfo.clear();
     allItems.clear();
-    itemsByType.clear();
 
     Dbf itemsDb{globalsFolderPath / "GItem.dbf"};
-    if (!itemsDb) {
-        std::cerr << "Could not open GItem.dbf\n";
+    Dbf::Schema<ItemRecord> schema{
+        {"ITEM_CAT", &ItemRecord::type},
+        {"ITEM_ID", &ItemRecord::id},
+        {"VALUE", &ItemRecord::value},
+    };
+
+    if (!openTable(itemsDb, schema, "GItem.dbf")) {
         return false;
     }
 
@@ -612,22 +800,19 @@ bool StandaloneGameInfo::readItemsInfo(const std::filesystem::path& globalsFolde
             continue;
         }
 
-        int type{};
-        if (!record.value(type, "ITEM_CAT")) {
+        ItemRecord item;
+        if (!schema.decode(item, record)) {
             continue;
         }
 
-        CMidgardID itemId;
-        if (!readId(record, "ITEM_ID", itemId)) {
-            continue;
-        }
+        const int type{item.type};
 
-        std::string_view valueString{};
-        if (!record.value(valueString, "VALUE")) {
+        CMidgardID itemId;
+        if (!readId(item.id, itemId)) {
             continue;
         }
 
-        const Currency currency{Currency::fromString(valueString)};
+        const Currency currency{Currency::fromString(item.value)};
 
         // Use sum of resources as as value
         // TODO: get values by running Lua script
@@ -646,22 +831,37 @@ bool StandaloneGameInfo::readItemsInfo(const std::filesystem::path& globalsFolde
         auto info{std::make_unique<StandaloneItemInfo>(itemId, value, itemType)};
 
         allItems.push_back(info.get());
-        itemsByType[itemType].push_back(info.get());
         itemsInfo[itemId] = std::move(info);
     }
 
     return true;
 }
 
+bool StandaloneGameInfo::buildItemsByType()
+{
+    itemsByType.clear();
+
+    for (auto item : allItems) {
+        itemsByType[item->getItemType()].push_back(item);
+    }
+
+    return true;
+}
+
 bool StandaloneGameInfo::readSpellsInfo(const std::filesystem::path& globalsFolderPath)
 {
     spellsInfo.clear();
     allSpells.clear();
-    spellsByType.clear();
 
     Dbf spellsDb{globalsFolderPath / "GSpells.dbf"};
-    if (!spellsDb) {
-        std::cerr << "Could not open GSpells.dbf\n";
+    Dbf::Schema<SpellRecord> schema{
+        {"SPELL_ID", &SpellRecord::id},
+        {"CATEGORY", &SpellRecord::type},
+        {"LEVEL", &SpellRecord::level},
+        {"BUY_C", &SpellRecord::cost},
+    };
+
+    if (!openTable(spellsDb, schema, "GSpells.dbf")) {
         return false;
     }
 
@@ -670,27 +870,20 @@ bool StandaloneGameInfo::readSpellsInfo(const std::filesystem::path& globalsFold
             continue;
         }
 
-        CMidgardID spellId;
-        if (!readId(record, "SPELL_ID", spellId)) {
-            continue;
-        }
-
-        int type{};
-        if (!record.value(type, "CATEGORY")) {
+        SpellRecord spell;
+        if (!schema.decode(spell, record)) {
             continue;
         }
 
-        int level{};
-        if (!record.value(level, "LEVEL")) {
+        CMidgardID spellId;
+        if (!readId(spell.id, spellId)) {
             continue;
         }
 
-        std::string_view costString{};
-        if (!record.value(costString, "BUY_C")) {
-            continue;
-        }
+        const int type{spell.type};
+        const int level{spell.level};
 
-        const Currency currency{Currency::fromString(costString)};
+        const Currency currency{Currency::fromString(spell.cost)};
 
         // Use sum of resources as as value
         // TODO: get values by running Lua script
@@ -704,23 +897,38 @@ bool StandaloneGameInfo::readSpellsInfo(const std::filesystem::path& globalsFold
         auto info{std::make_unique<StandaloneSpellInfo>(spellId, value, level, spellType)};
 
         allSpells.push_back(info.get());
-        spellsByType[spellType].push_back(info.get());
         spellsInfo[spellId] = std::move(info);
     }
 
     return true;
 }
 
+bool StandaloneGameInfo::buildSpellsByType()
+{
+    spellsByType.clear();
+
+    for (auto spell : allSpells) {
+        spellsByType[spell->getSpellType()].push_back(spell);
+    }
+
+    return true;
+}
+
 bool StandaloneGameInfo::readLandmarksInfo(const std::filesystem::path& globalsFolderPath)
 {
     landmarksInfo.clear();
-    landmarksByType.clear();
-    landmarksByRace.clear();
-    mountainLandmarks.clear();
+    allLandmarks.clear();
 
     Dbf landmarksDb{globalsFolderPath / "GLmark.dbf"};
-    if (!landmarksDb) {
-        std::cerr << "Could not open GLmark.dbf\n";
+    Dbf::Schema<LandmarkRecord> schema{
+        {"LMARK_ID", &LandmarkRecord::id},
+        {"CX", &LandmarkRecord::x},
+        {"CY", &LandmarkRecord::y},
+        {"MOUNTAIN", &LandmarkRecord::mountain},
+        {"CATEGORY", &LandmarkRecord::type},
+    };
+
+    if (!openTable(landmarksDb, schema, "GLmark.dbf")) {
         return false;
     }
 
@@ -729,65 +937,82 @@ bool StandaloneGameInfo::readLandmarksInfo(const std::filesystem::path& globalsF
             continue;
         }
 
-        CMidgardID landmarkId;
-        if (!readId(record, "LMARK_ID", landmarkId)) {
+        LandmarkRecord landmark;
+        if (!schema.decode(landmark, record)) {
             continue;
         }
 
-        int x{};
-        if (!record.value(x, "CX")) {
+        CMidgardID landmarkId;
+        if (!readId(landmark.id, landmarkId)) {
             continue;
         }
 
-        int y{};
-        if (!record.value(y, "CY")) {
-            continue;
-        }
+        auto landmarkType{static_cast<LandmarkType>(landmark.type)};
+        auto info{std::make_unique<StandaloneLandmarkInfo>(landmarkId,
+                                                           Position{landmark.x, landmark.y},
+                                                           landmarkType, landmark.mountain)};
 
-        bool mountain{};
-        if (!record.value(mountain, "MOUNTAIN")) {
-            continue;
-        }
+        allLandmarks.push_back(info.get());
+        landmarksInfo[landmarkId] = std::move(info);
+    }
 
-        int type{};
-        if (!record.value(type, "CATEGORY")) {
-            continue;
-        }
+    return true;
+}
+
+bool StandaloneGameInfo::buildLandmarksByType()
+{
+    landmarksByType.clear();
 
-        auto landmarkType{static_cast<LandmarkType>(type)};
-        auto info{std::make_unique<StandaloneLandmarkInfo>(landmarkId, Position{x, y}, landmarkType,
-                                                           mountain)};
+    for (auto landmark : allLandmarks) {
+        landmarksByType[landmark->getLandmarkType()].push_back(landmark);
+    }
 
-        if (isEmpireLandmark(landmarkId)) {
-            landmarksByRace[RaceType::Human].push_back(info.get());
-        }
+    return true;
+}
+
+bool StandaloneGameInfo::buildLandmarksByRace()
+{
+    landmarksByRace.clear();
 
-        if (isClansLandmark(landmarkId)) {
-            landmarksByRace[RaceType::Dwarf].push_back(info.get());
+    for (auto landmark : allLandmarks) {
+        const auto& landmarkId{landmark->getLandmarkId()};
+
+        if (isEmpireLandmark(generatorSettings, landmarkId)) {
+            landmarksByRace[RaceType::Human].push_back(landmark);
         }
 
-        if (isUndeadLandmark(landmarkId)) {
-            landmarksByRace[RaceType::Undead].push_back(info.get());
+        if (isClansLandmark(generatorSettings, landmarkId)) {
+            landmarksByRace[RaceType::Dwarf].push_back(landmark);
         }
 
-        if (isLegionsLandmark(landmarkId)) {
-            landmarksByRace[RaceType::Heretic].push_back(info.get());
+        if (isUndeadLandmark(generatorSettings, landmarkId)) {
+            landmarksByRace[RaceType::Undead].push_back(landmark);
         }
 
-        if (isElvesLandmark(landmarkId)) {
-            landmarksByRace[RaceType::Elf].push_back(info.get());
+        if (isLegionsLandmark(generatorSettings, landmarkId)) {
+            landmarksByRace[RaceType::Heretic].push_back(landmark);
         }
 
-        if (isNeutralLandmark(landmarkId)) {
-            landmarksByRace[RaceType::Neutral].push_back(info.get());
+        if (isElvesLandmark(generatorSettings, landmarkId)) {
+            landmarksByRace[RaceType::Elf].push_back(landmark);
         }
 
-        if (isMountainLandmark(landmarkId)) {
-            mountainLandmarks.push_back(info.get());
+        if (isNeutralLandmark(generatorSettings, landmarkId)) {
+            landmarksByRace[RaceType::Neutral].push_back(landmark);
         }
+    }
 
-        landmarksByType[landmarkType].push_back(info.get());
-        landmarksInfo[landmarkId] = std::move(info);
+    return true;
+}
+
+bool StandaloneGameInfo::buildMountainLandmarks()
+{
+    mountainLandmarks.clear();
+
+    for (auto landmark : allLandmarks) {
+        if (isMountainLandmark(generatorSettings, landmark->getLandmarkId())) {
+            mountainLandmarks.push_back(landmark);
+        }
     }
 
     return true;
@@ -800,8 +1025,13 @@ bool StandaloneGameInfo::readRacesInfo(const std::filesystem::path& globalsFolde
     std::map<CMidgardID /* race id */, LeaderNames> leaderNames;
 
     Dbf namesDb{globalsFolderPath / "Tleader.dbf"};
-    if (!namesDb) {
-        std::cerr << "Could not open Tleader.dbf\n";
+    Dbf::Schema<LeaderNameRecord> namesSchema{
+        {"RACE_ID", &LeaderNameRecord::raceId},
+        {"SEX_M", &LeaderNameRecord::male},
+        {"TEXT", &LeaderNameRecord::name},
+    };
+
+    if (!openTable(namesDb, namesSchema, "Tleader.dbf")) {
         return false;
     }
 
@@ -810,77 +1040,71 @@ bool StandaloneGameInfo::readRacesInfo(const std::filesystem::path& globalsFolde
             continue;
         }
 
-        CMidgardID raceId;
-        if (!readId(record, "RACE_ID", raceId)) {
-            continue;
-        }
-
-        bool male{};
-        if (!record.value(male, "SEX_M")) {
+        LeaderNameRecord leaderName;
+        if (!namesSchema.decode(leaderName, record)) {
             continue;
         }
 
-        std::string_view nameView{};
-        if (!record.value(nameView, "TEXT")) {
+        CMidgardID raceId;
+        if (!readId(leaderName.raceId, raceId)) {
             continue;
         }
 
         LeaderNames& names = leaderNames[raceId];
-        auto& namesArray = male ? names.maleNames : names.femaleNames;
+        auto& namesArray = leaderName.male ? names.maleNames : names.femaleNames;
 
         constexpr std::uint8_t maxLeaderNameLength{31};
-        namesArray.push_back(translate(nameView, maxLeaderNameLength));
+        namesArray.push_back(translate(leaderName.name, maxLeaderNameLength));
     }
 
     Dbf racesDb{globalsFolderPath / "Grace.dbf"};
-    if (!racesDb) {
-        std::cerr << "Could not open Grace.dbf\n";
+    Dbf::Schema<RaceRecord> racesSchema{
+        {"RACE_ID", &RaceRecord::id},
+        {"GUARDIAN", &RaceRecord::guardId},
+        {"NOBLE", &RaceRecord::nobleId},
+        {"LEADER_1", &RaceRecord::leader1},
+        {"LEADER_2", &RaceRecord::leader2},
+        {"LEADER_3", &RaceRecord::leader3},
+        {"LEADER_4", &RaceRecord::leader4},
+        {"RACE_TYPE", &RaceRecord::type},
+    };
+
+    if (!openTable(racesDb, racesSchema, "Grace.dbf")) {
         return false;
     }
 
-    char columnName[9] = {'L', 'E', 'A', 'D', 'E', 'R', '_', '1', 0};
-
     for (const auto& record : racesDb) {
         if (record.deleted()) {
             continue;
         }
 
+        RaceRecord race;
+        if (!racesSchema.decode(race, record)) {
+            continue;
+        }
+
         CMidgardID raceId;
-        if (!readId(record, "RACE_ID", raceId)) {
+        if (!readId(race.id, raceId)) {
             continue;
         }
 
         CMidgardID guardId;
-        if (!readId(record, "GUARDIAN", guardId)) {
+        if (!readId(race.guardId, guardId)) {
             continue;
         }
 
         CMidgardID nobleId;
-        if (!readId(record, "NOBLE", nobleId)) {
+        if (!readId(race.nobleId, nobleId)) {
             continue;
         }
 
-        bool failed{};
         std::vector<CMidgardID> leaderIds(4);
-        for (std::size_t i = 0; i < std::size(leaderIds); ++i) {
-            columnName[7] = '1' + static_cast<char>(i);
-
-            if (!readId(record, columnName, leaderIds[i])) {
-                failed = true;
-                break;
-            }
-        }
-
-        if (failed) {
+        if (!readId(race.leader1, leaderIds[0]) || !readId(race.leader2, leaderIds[1])
+            || !readId(race.leader3, leaderIds[2]) || !readId(race.leader4, leaderIds[3])) {
             continue;
         }
 
-        int type;
-        if (!record.value(type, "RACE_TYPE")) {
-            continue;
-        }
-
-        const auto raceType{static_cast<RaceType>(type)};
+        const auto raceType{static_cast<RaceType>(race.type)};
 
         auto raceInfo{std::make_unique<StandaloneRaceInfo>(raceId, guardId, nobleId, raceType,
                                                            std::move(leaderNames[raceId]),
@@ -891,6 +1115,12 @@ bool StandaloneGameInfo::readRacesInfo(const std::filesystem::path& globalsFolde
     return true;
 }
 
+bool StandaloneGameInfo::buildDerivedArrays()
+{
+    return buildLeaders() && buildSoldiers() && buildItemsByType() && buildSpellsByType()
+           && buildLandmarksByType() && buildLandmarksByRace() && buildMountainLandmarks();
+}
+
 bool StandaloneGameInfo::readGlobalTexts(const std::filesystem::path& globalsFolderPath)
 {
     return readTexts(globalTexts, globalsFolderPath, "Tglobal.dbf");
@@ -906,24 +1136,27 @@ bool StandaloneGameInfo::readCityNames(const std::filesystem::path& scenDataFold
     cityNames.clear();
 
     Dbf namesDb{scenDataFolderPath / "Cityname.dbf"};
-    if (!namesDb) {
-        std::cerr << "Could not open Cityname.dbf\n";
+    Dbf::Schema<SiteTextRecord> schema{
+        {"NAME", &SiteTextRecord::name},
+    };
+
+    if (!openTable(namesDb, schema, "Cityname.dbf")) {
         return false;
     }
 
-    const auto textLength = namesDb.column("NAME")->length;
+    const auto textLength = schema.column("NAME")->length;
 
     for (const auto& record : namesDb) {
         if (record.deleted()) {
             continue;
         }
 
-        std::string_view nameView{};
-        if (!record.value(nameView, "NAME")) {
+        SiteTextRecord cityName;
+        if (!schema.decode(cityName, record)) {
             continue;
         }
 
-        cityNames.push_back(translate(nameView, textLength));
+        cityNames.push_back(translate(cityName.name, textLength));
     }
 
     return true;
@@ -940,15 +1173,47 @@ bool StandaloneGameInfo::readSiteTexts(const std::filesystem::path& scenDataFold
 
 bool StandaloneGameInfo::readGameInfo(const std::filesystem::path& gameFolderPath)
 {
+    RSG_PROFILE_SCOPE("StandaloneGameInfo::readGameInfo");
+
     const std::filesystem::path globalsFolder{gameFolderPath / "Globals"};
     const std::filesystem::path scenDataFolder{gameFolderPath / "ScenData"};
     const std::filesystem::path interfDataFolder{gameFolderPath / "Interf"};
 
-    return readGeneratorSettings(gameFolderPath) && readRacesInfo(globalsFolder)
-           && readUnitsInfo(globalsFolder) && readItemsInfo(globalsFolder)
-           && readSpellsInfo(globalsFolder) && readLandmarksInfo(globalsFolder)
-           && readGlobalTexts(globalsFolder) && readEditorInterfaceTexts(interfDataFolder)
-           && readCityNames(scenDataFolder) && readSiteTexts(scenDataFolder);
+    // Tables are independent of each other and are read concurrently.
+    // Each task only writes its own members, dependencies are explicit
+    LoadingTasks tasks;
+
+    const auto settings = tasks.run({}, [&]() {
+        return readGeneratorSettings(generatorSettings, gameFolderPath);
+    });
+
+    AttacksInfo attacks;
+    const auto attacksRead = tasks.run({},
+                                       [&]() { return readAttacksInfo(globalsFolder, attacks); });
+    const auto units = tasks.run({attacksRead},
+                                 [&]() { return readUnitsInfo(globalsFolder, attacks); });
+    tasks.run({units}, [this]() { return buildLeaders(); });
+    tasks.run({units}, [this]() { return buildSoldiers(); });
+
+    const auto items = tasks.run({}, [&]() { return readItemsInfo(globalsFolder); });
+    tasks.run({items}, [this]() { return buildItemsByType(); });
+
+    const auto spells = tasks.run({}, [&]() { return readSpellsInfo(globalsFolder); });
+    tasks.run({spells}, [this]() { return buildSpellsByType(); });
+
+    const auto landmarks = tasks.run({}, [&]() { return readLandmarksInfo(globalsFolder); });
+    tasks.run({landmarks}, [this]() { return buildLandmarksByType(); });
+    // Landmark races and mountains are specified in generator settings
+    tasks.run({landmarks, settings}, [this]() { return buildLandmarksByRace(); });
+    tasks.run({landmarks, settings}, [this]() { return buildMountainLandmarks(); });
+
+    tasks.run({}, [&]() { return readRacesInfo(globalsFolder); });
+    tasks.run({}, [&]() { return readGlobalTexts(globalsFolder); });
+    tasks.run({}, [&]() { return readEditorInterfaceTexts(interfDataFolder); });
+    tasks.run({}, [&]() { return readCityNames(scenDataFolder); });
+    tasks.run({}, [&]() { return readSiteTexts(scenDataFolder); });
+
+    return tasks.wait();
 }
 
 } // namespace rsg
@@ -20,7 +20,9 @@
 #pragma once
 
 #include "gameinfo.h"
+#include "generatorsettings.h"
 #include <filesystem>
+#include <utility>
 
 namespace rsg {
 
@@ -28,10 +30,18 @@ namespace rsg {
 class StandaloneGameInfo final : public GameInfo
 {
 public:
-    StandaloneGameInfo(const std::filesystem::path& gameFolderPath);
+    // Reads game data from snapshot file if it is up to date with game files.
+    // Otherwise reads game files and writes new snapshot.
+    // Empty snapshot path disables snapshot usage
+    StandaloneGameInfo(const std::filesystem::path& gameFolderPath,
+                       const std::filesystem::path& snapshotPath = {});
 
     ~StandaloneGameInfo() override = default;
 
+    // Returns snapshot location in temporary folder unique for specified game folder
+    static std::filesystem::path getDefaultSnapshotPath(
+        const std::filesystem::path& gameFolderPath);
+
     const UnitsInfo& getUnits() const override;
 
     const UnitInfoArray& getLeaders() const override;
@@ -86,15 +96,45 @@ public:
 
     const SiteTexts& getTrainerTexts() const override;
 
+    // Returns generator settings read along with game data
+    const GeneratorSettings& getGeneratorSettings() const
+    {
+        return generatorSettings;
+    }
+
 private:
+    using AttacksInfo = std::map<CMidgardID /* attack id */, std::pair<ReachType, AttackType>>;
+
     bool readGameInfo(const std::filesystem::path& gameFolderPath);
 
-    bool readUnitsInfo(const std::filesystem::path& globalsFolderPath);
+    // Implemented in standalonegameinfosnapshot.cpp
+    bool readSnapshot(const std::filesystem::path& snapshotPath,
+                      const std::filesystem::path& gameFolderPath);
+    bool writeSnapshot(const std::filesystem::path& snapshotPath,
+                       const std::filesystem::path& gameFolderPath) const;
+    bool buildDerivedArrays();
+
+    static bool readAttacksInfo(const std::filesystem::path& globalsFolderPath,
+                                AttacksInfo& attacks);
+
+    // Readers fill catalogs along with arrays that keep records in database order.
+    // Derived arrays are built from them afterwards, independently of each other
+    bool readUnitsInfo(const std::filesystem::path& globalsFolderPath,
+                       const AttacksInfo& attacks);
     bool readItemsInfo(const std::filesystem::path& globalsFolderPath);
     bool readSpellsInfo(const std::filesystem::path& globalsFolderPath);
     bool readLandmarksInfo(const std::filesystem::path& globalsFolderPath);
     bool readRacesInfo(const std::filesystem::path& globalsFolderPath);
 
+    bool buildLeaders();
+    bool buildSoldiers();
+    bool buildItemsByType();
+    bool buildSpellsByType();
+    bool buildLandmarksByType();
+    // Requires generator settings to be read
+    bool buildLandmarksByRace();
+    bool buildMountainLandmarks();
+
     bool readGlobalTexts(const std::filesystem::path& globalsFolderPath);
     bool readEditorInterfaceTexts(const std::filesystem::path& interfFolderPath);
 
@@ -104,6 +144,7 @@ private:
     const char* getText(const TextsInfo& texts, const CMidgardID& textId) const;
 
     UnitsInfo unitsInfo{};
+    UnitInfoArray allUnits{};
     UnitInfoArray leaders{};
     UnitInfoArray soldiers{};
 
@@ -122,6 +163,7 @@ private:
     std::map<SpellType, SpellInfoArray> spellsByType;
 
     LandmarksInfo landmarksInfo;
+    LandmarkInfoArray allLandmarks;
     std::map<LandmarkType, LandmarkInfoArray> landmarksByType;
     std::map<RaceType, LandmarkInfoArray> landmarksByRace;
     LandmarkInfoArray mountainLandmarks;
@@ -138,6 +180,8 @@ private:
     SiteTexts merchantTexts;
     SiteTexts ruinTexts;
     SiteTexts trainerTexts;
+
+    GeneratorSettings generatorSettings;
 };
 
 } // namespace rsg
@@ -0,0 +1,423 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "standalonegameinfo.h"
+#include "generatorsettings.h"
+#include "mappedfile.h"
+#include "snapshot.h"
+#include "standaloneiteminfo.h"
+#include "standalonelandmarkinfo.h"
+#include "standaloneraceinfo.h"
+#include "standalonespellinfo.h"
+#include "standaloneunitinfo.h"
+#include <cstdio>
+#include <iostream>
+
+namespace rsg {
+
+// Snapshot layout:
+// header, source files keys, generator settings, units, items, spells, landmarks, races, texts.
+// Increase version each time layout or meaning of stored data changes
+static constexpr std::uint32_t snapshotSignature{0x53475352}; // 'RSGS'
+static constexpr std::uint32_t snapshotVersion{1};
+
+// Files that snapshot contents depend on, relative to game folder
+static const char* snapshotSources[] = {
+    "Globals/LAttR.dbf",
+    "Globals/GAttacks.dbf",
+    "Globals/GUnits.dbf",
+    "Globals/GItem.dbf",
+    "Globals/GSpells.dbf",
+    "Globals/GLmark.dbf",
+    "Globals/Tleader.dbf",
+    "Globals/Grace.dbf",
+    "Globals/Tglobal.dbf",
+    "Interf/TAppEdit.dbf",
+    "ScenData/Cityname.dbf",
+    "ScenData/Campname.dbf",
+    "ScenData/Magename.dbf",
+    "ScenData/Mercname.dbf",
+    "ScenData/Ruinname.dbf",
+    "ScenData/Trainame.dbf",
+    "Scripts/generatorSettings.lua",
+    "Imgs/IsoTerrn.ff",
+    "Imgs/IsoCmon.ff",
+};
+
+struct SourceKey
+{
+    std::uint64_t size{};
+    std::int64_t lastWriteTime{};
+};
+
+static SourceKey getSourceKey(const std::filesystem::path& filePath)
+{
+    std::error_code error;
+
+    SourceKey key;
+    key.size = std::filesystem::file_size(filePath, error);
+    if (error) {
+        return SourceKey{};
+    }
+
+    const auto writeTime{std::filesystem::last_write_time(filePath, error)};
+    if (error) {
+        return SourceKey{};
+    }
+
+    key.lastWriteTime = static_cast<std::int64_t>(writeTime.time_since_epoch().count());
+    return key;
+}
+
+static void writeSnapshotTexts(SnapshotWriter& writer, const TextsInfo& texts)
+{
+    writer.write(static_cast<std::uint32_t>(texts.size()));
+    for (const auto& [id, text] : texts) {
+        writer.write(id);
+        writer.write(text);
+    }
+}
+
+static void readSnapshotTexts(SnapshotReader& reader, TextsInfo& texts)
+{
+    texts.clear();
+
+    const std::uint32_t count{reader.readCount()};
+    texts.reserve(count);
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        const auto id{reader.readValue<CMidgardID>()};
+        reader.read(texts[id]);
+    }
+}
+
+static void writeSnapshotSiteTexts(SnapshotWriter& writer, const SiteTexts& texts)
+{
+    writer.write(static_cast<std::uint32_t>(texts.size()));
+    for (const auto& text : texts) {
+        writer.write(text.name);
+        writer.write(text.description);
+    }
+}
+
+static void readSnapshotSiteTexts(SnapshotReader& reader, SiteTexts& texts)
+{
+    texts.resize(reader.readCount());
+    for (auto& text : texts) {
+        reader.read(text.name);
+        reader.read(text.description);
+    }
+}
+
+static void writeObjectImages(SnapshotWriter& writer, const GeneratorSettings::ObjectImages& images)
+{
+    writer.write(images.images);
+    writer.write(images.waterImages);
+}
+
+static void readObjectImages(SnapshotReader& reader, GeneratorSettings::ObjectImages& images)
+{
+    reader.read(images.images);
+    reader.read(images.waterImages);
+}
+
+static void writeSnapshotSettings(SnapshotWriter& writer, const GeneratorSettings& settings)
+{
+    writer.write(settings.forbiddenUnits);
+    writer.write(settings.forbiddenItems);
+    writer.write(settings.forbiddenSpells);
+
+    writer.write(settings.landmarks.empire);
+    writer.write(settings.landmarks.clans);
+    writer.write(settings.landmarks.undead);
+    writer.write(settings.landmarks.legions);
+    writer.write(settings.landmarks.elves);
+    writer.write(settings.landmarks.neutral);
+    writer.write(settings.landmarks.mountains);
+
+    writer.write(settings.mountains);
+
+    writeObjectImages(writer, settings.bags);
+    writeObjectImages(writer, settings.ruins);
+    writeObjectImages(writer, settings.merchants);
+    writeObjectImages(writer, settings.mages);
+    writeObjectImages(writer, settings.trainers);
+    writeObjectImages(writer, settings.mercenaries);
+    writeObjectImages(writer, settings.resourceMarkets);
+
+    writer.write(settings.maxTreeImageIndex);
+}
+
+static void readSnapshotSettings(SnapshotReader& reader, GeneratorSettings& settings)
+{
+    reader.read(settings.forbiddenUnits);
+    reader.read(settings.forbiddenItems);
+    reader.read(settings.forbiddenSpells);
+
+    reader.read(settings.landmarks.empire);
+    reader.read(settings.landmarks.clans);
+    reader.read(settings.landmarks.undead);
+    reader.read(settings.landmarks.legions);
+    reader.read(settings.landmarks.elves);
+    reader.read(settings.landmarks.neutral);
+    reader.read(settings.landmarks.mountains);
+
+    reader.read(settings.mountains);
+
+    readObjectImages(reader, settings.bags);
+    readObjectImages(reader, settings.ruins);
+    readObjectImages(reader, settings.merchants);
+    readObjectImages(reader, settings.mages);
+    readObjectImages(reader, settings.trainers);
+    readObjectImages(reader, settings.mercenaries);
+    readObjectImages(reader, settings.resourceMarkets);
+
+    reader.read(settings.maxTreeImageIndex);
+}
+
+std::filesystem::path StandaloneGameInfo::getDefaultSnapshotPath(
+    const std::filesystem::path& gameFolderPath)
+{
+    // Each game folder (or mod) gets its own snapshot
+    const auto folder{std::filesystem::absolute(gameFolderPath).lexically_normal()};
+    const std::size_t folderHash{std::hash<std::string>{}(folder.string())};
+
+    char fileName[64] = {0};
+    std::snprintf(fileName, std::size(fileName) - 1, "rsgGameData%016llx.snapshot",
+                  static_cast<unsigned long long>(folderHash));
+
+    return std::filesystem::temp_directory_path() / fileName;
+}
+
+bool StandaloneGameInfo::readSnapshot(const std::filesystem::path& snapshotPath,
+                                      const std::filesystem::path& gameFolderPath)
+{
+    const MappedFile file{snapshotPath};
+    if (!file) {
+        return false;
+    }
+
+    try {
+        SnapshotReader reader{file.data(), file.size()};
+
+        if (reader.readValue<std::uint32_t>() != snapshotSignature
+            || reader.readValue<std::uint32_t>() != snapshotVersion) {
+            return false;
+        }
+
+        if (reader.readCount() != std::size(snapshotSources)) {
+            return false;
+        }
+
+        for (const char* source : snapshotSources) {
+            const SourceKey current{getSourceKey(gameFolderPath / source)};
+
+            const auto stored{reader.readValue<SourceKey>()};
+            if (stored.size != current.size || stored.lastWriteTime != current.lastWriteTime) {
+                // Game files were changed since snapshot was written
+                return false;
+            }
+        }
+
+        generatorSettings = GeneratorSettings();
+        readSnapshotSettings(reader, generatorSettings);
+
+        unitsInfo.clear();
+        allUnits.clear();
+        for (std::uint32_t i = 0, count = reader.readCount(); i < count; ++i) {
+            const auto unitId{reader.readValue<CMidgardID>()};
+            const auto raceId{reader.readValue<CMidgardID>()};
+            const auto nameId{reader.readValue<CMidgardID>()};
+            const auto level{reader.readValue<int>()};
+            const auto value{reader.readValue<int>()};
+            const auto unitType{reader.readValue<UnitType>()};
+            const auto subrace{reader.readValue<SubRaceType>()};
+            const auto reach{reader.readValue<ReachType>()};
+            const auto attackType{reader.readValue<AttackType>()};
+            const auto hp{reader.readValue<int>()};
+            const auto move{reader.readValue<int>()};
+            const auto leadership{reader.readValue<int>()};
+            const auto big{reader.readValue<bool>()};
+            const auto male{reader.readValue<bool>()};
+
+            auto info{std::make_unique<StandaloneUnitInfo>(unitId, raceId, nameId, level, value,
+                                                           unitType, subrace, reach, attackType,
+                                                           hp, move, leadership, big, male)};
+            allUnits.push_back(info.get());
+            unitsInfo[unitId] = std::move(info);
+        }
+
+        itemsInfo.clear();
+        allItems.clear();
+        for (std::uint32_t i = 0, count = reader.readCount(); i < count; ++i) {
+            const auto itemId{reader.readValue<CMidgardID>()};
+            const auto value{reader.readValue<int>()};
+            const auto itemType{reader.readValue<ItemType>()};
+
+            auto info{std::make_unique<StandaloneItemInfo>(itemId, value, itemType)};
+            allItems.push_back(info.get());
+            itemsInfo[itemId] = std::move(info);
+        }
+
+        spellsInfo.clear();
+        allSpells.clear();
+        for (std::uint32_t i = 0, count = reader.readCount(); i < count; ++i) {
+            const auto spellId{reader.readValue<CMidgardID>()};
+            const auto value{reader.readValue<int>()};
+            const auto level{reader.readValue<int>()};
+            const auto spellType{reader.readValue<SpellType>()};
+
+            auto info{std::make_unique<StandaloneSpellInfo>(spellId, value, level, spellType)};
+            allSpells.push_back(info.get());
+            spellsInfo[spellId] = std::move(info);
+        }
+
+        landmarksInfo.clear();
+        allLandmarks.clear();
+        for (std::uint32_t i = 0, count = reader.readCount(); i < count; ++i) {
+            const auto landmarkId{reader.readValue<CMidgardID>()};
+            const auto x{reader.readValue<int>()};
+            const auto y{reader.readValue<int>()};
+            const auto landmarkType{reader.readValue<LandmarkType>()};
+            const auto mountain{reader.readValue<bool>()};
+
+            auto info{std::make_unique<StandaloneLandmarkInfo>(landmarkId, Position{x, y},
+                                                               landmarkType, mountain)};
+            allLandmarks.push_back(info.get());
+            landmarksInfo[landmarkId] = std::move(info);
+        }
+
+        racesInfo.clear();
+        for (std::uint32_t i = 0, count = reader.readCount(); i < count; ++i) {
+            const auto raceId{reader.readValue<CMidgardID>()};
+            const auto guardianId{reader.readValue<CMidgardID>()};
+            const auto nobleId{reader.readValue<CMidgardID>()};
+            const auto raceType{reader.readValue<RaceType>()};
+
+            LeaderNames leaderNames;
+            reader.read(leaderNames.maleNames);
+            reader.read(leaderNames.femaleNames);
+
+            std::vector<CMidgardID> leaderIds;
+            reader.read(leaderIds);
+
+            racesInfo[raceId] = std::make_unique<StandaloneRaceInfo>(raceId, guardianId, nobleId,
+                                                                     raceType,
+                                                                     std::move(leaderNames),
+                                                                     std::move(leaderIds));
+        }
+
+        readSnapshotTexts(reader, globalTexts);
+        readSnapshotTexts(reader, editorInterfaceTexts);
+        reader.read(cityNames);
+        readSnapshotSiteTexts(reader, mercenaryTexts);
+        readSnapshotSiteTexts(reader, mageTexts);
+        readSnapshotSiteTexts(reader, merchantTexts);
+        readSnapshotSiteTexts(reader, ruinTexts);
+        readSnapshotSiteTexts(reader, trainerTexts);
+    } catch (const std::exception& e) {
+        std::cerr << "Could not read game data snapshot: " << e.what() << '\n';
+        return false;
+    }
+
+    return buildDerivedArrays();
+}
+
+bool StandaloneGameInfo::writeSnapshot(const std::filesystem::path& snapshotPath,
+                                       const std::filesystem::path& gameFolderPath) const
+{
+    SnapshotWriter writer;
+
+    writer.write(snapshotSignature);
+    writer.write(snapshotVersion);
+
+    writer.write(static_cast<std::uint32_t>(std::size(snapshotSources)));
+    for (const char* source : snapshotSources) {
+        writer.write(getSourceKey(gameFolderPath / source));
+    }
+
+    writeSnapshotSettings(writer, generatorSettings);
+
+    // Keep database order, derived arrays depend on it
+    writer.write(static_cast<std::uint32_t>(allUnits.size()));
+    for (const auto unit : allUnits) {
+        writer.write(unit->getUnitId());
+        writer.write(unit->getRaceId());
+        writer.write(unit->getNameId());
+        writer.write(unit->getLevel());
+        writer.write(unit->getValue());
+        writer.write(unit->getUnitType());
+        writer.write(unit->getSubrace());
+        writer.write(unit->getAttackReach());
+        writer.write(unit->getAttackType());
+        writer.write(unit->getHp());
+        writer.write(unit->getMove());
+        writer.write(unit->getLeadership());
+        writer.write(unit->isBig());
+        writer.write(unit->isMale());
+    }
+
+    writer.write(static_cast<std::uint32_t>(allItems.size()));
+    for (const auto item : allItems) {
+        writer.write(item->getItemId());
+        writer.write(item->getValue());
+        writer.write(item->getItemType());
+    }
+
+    writer.write(static_cast<std::uint32_t>(allSpells.size()));
+    for (const auto spell : allSpells) {
+        writer.write(spell->getSpellId());
+        writer.write(spell->getValue());
+        writer.write(spell->getLevel());
+        writer.write(spell->getSpellType());
+    }
+
+    writer.write(static_cast<std::uint32_t>(allLandmarks.size()));
+    for (const auto landmark : allLandmarks) {
+        writer.write(landmark->getLandmarkId());
+        writer.write(landmark->getSize().x);
+        writer.write(landmark->getSize().y);
+        writer.write(landmark->getLandmarkType());
+        writer.write(landmark->isMountain());
+    }
+
+    writer.write(static_cast<std::uint32_t>(racesInfo.size()));
+    for (const auto& [raceId, race] : racesInfo) {
+        writer.write(race->getRaceId());
+        writer.write(race->getGuardianUnitId());
+        writer.write(race->getNobleLeaderId());
+        writer.write(race->getRaceType());
+        writer.write(race->getLeaderNames().maleNames);
+        writer.write(race->getLeaderNames().femaleNames);
+        writer.write(race->getLeaderIds());
+    }
+
+    writeSnapshotTexts(writer, globalTexts);
+    writeSnapshotTexts(writer, editorInterfaceTexts);
+    writer.write(cityNames);
+    writeSnapshotSiteTexts(writer, mercenaryTexts);
+    writeSnapshotSiteTexts(writer, mageTexts);
+    writeSnapshotSiteTexts(writer, merchantTexts);
+    writeSnapshotSiteTexts(writer, ruinTexts);
+    writeSnapshotSiteTexts(writer, trainerTexts);
+
+    return writeSnapshotFile(snapshotPath, writer);
+}
+
+} // namespace rsg